@@ -0,0 +1,34 @@
+/*
+ * Приложение поверх CubeMX: дисплеи, задачи main loop и их таблица (sched.h).
+ *
+ * Один и тот же код у прошивки и у хостовой сборки (Host/app.c): main()
+ * после MX_*_Init вызывает AppTasks_Init(), в while(1) — AppTasks_Run().
+ * Колбэки HAL остаются в main.c (USER CODE 4), шина панелей для них —
+ * oled_bus.
+ *
+ * APP_USB_CMD = 1 (по умолчанию) — задача команд USB CDC (AppTasks_OnUsbRx,
+ * 'D', 'R', 'T' ...). На хосте 0: CDC там нет, кэши не переключить.
+ */
+#ifndef APP_TASKS_H
+#define APP_TASKS_H
+
+#include "ssd1309.h"
+
+#ifndef APP_USB_CMD
+#define APP_USB_CMD 1
+#endif
+
+extern SSD1309_t oled;
+extern SSD1309_Bus_t oled_bus;
+
+/* USER CODE 2: загрузка по стадиям, дисплеи, таблица задач */
+void AppTasks_Init(void);
+
+/* Тело while(1): один проход планировщика */
+void AppTasks_Run(void);
+
+/* Из CDC_Receive_FS (контекст USB ISR): команда для задачи usb_cmd.
+   Определена всегда, при APP_USB_CMD = 0 принятое отбрасывается */
+void AppTasks_OnUsbRx(const uint8_t *buf, uint32_t len);
+
+#endif // APP_TASKS_H
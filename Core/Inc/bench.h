@@ -0,0 +1,79 @@
+/*
+ * Микробенчмарки горячих функций: один набор случаев на плате и на хосте.
+ *
+ * Случай — функция, повторённая фиксированное число раз (iters в таблице
+ * bench.c, от прогона к прогону не меняется), пачками по iters/BENCH_BATCHES.
+ * В отчёте среднее и лучшая пачка на операцию, в тактах и наносекундах.
+ * Между пачками, вне замера, — Bench_Idle (разгрузка USB-лога).
+ *
+ * Плата: такты DWT->CYCCNT, нс — из тактов по SystemCoreClock. Запуск
+ * USB-командой 'B' (Bench_Start); Bench_Task из main loop выполняет по
+ * случаю за проход (до ~100 мс без возврата) и пишет строку, когда в
+ * кольце USB-лога есть место. Отрисовка идёт в свой framebuffer,
+ * ProcessStatusResponse разбирает кадры на втором ведомом — после замера
+ * его состояние поправит ближайший опрос.
+ * Хост: время и такты даёт Host/bench/bench_port.c (CLOCK_MONOTONIC, TSC).
+ *
+ * Вывод — JSON Lines, по объекту на строку (заголовок, затем случаи), чтобы
+ * строки отчёта выделялись из остального лога:
+ *   {"suite":"pult","platform":"stm32h750","cpu_mhz":480,"icache":1,"dcache":1,"cases":17}
+ *   {"bench":"gas_build_frame","platform":"stm32h750","iters":20000,"ns_per_op":...}
+ * Сравнение двух прогонов — Tools/bench_compare.py.
+ *
+ * BENCH_ENABLED = 0 (по умолчанию) — в прошивке набора нет, вызовы пустые.
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+#ifndef BENCH_ENABLED
+#define BENCH_ENABLED 0
+#endif
+
+#define BENCH_BATCHES   16u
+#define BENCH_LINE_MAX  256u
+
+typedef struct {
+    uint64_t cycles;        /* 0 — у платформы нет счётчика тактов */
+    uint64_t ns;            /* 0 — считать из тактов */
+} Bench_Stamp_t;
+
+typedef struct {
+    uint32_t iters;
+    uint32_t batch;         /* итераций в пачке */
+    uint64_t cycles;        /* всего */
+    uint64_t ns;
+    uint64_t min_cycles;    /* самая быстрая пачка */
+    uint64_t min_ns;
+} Bench_Result_t;
+
+#if BENCH_ENABLED
+
+uint8_t Bench_Count(void);
+const char *Bench_Name(uint8_t idx);
+
+/* Случай idx; iters делится на div (хост под valgrind) */
+void Bench_Run(uint8_t idx, uint32_t div, Bench_Result_t *res);
+
+/* Строка JSON с \r\n; длина без завершающего нуля */
+uint16_t Bench_FormatResult(char *out, uint16_t max, const char *name, const Bench_Result_t *res);
+
+/* Плата: весь набор в USB-лог */
+void Bench_Start(void);
+void Bench_Task(void);
+
+/* Платформа: часы, пауза между пачками, заголовок отчёта */
+void Bench_Now(Bench_Stamp_t *t);
+void Bench_Idle(void);
+const char *Bench_Platform(void);
+uint16_t Bench_FormatHeader(char *out, uint16_t max);
+
+#else
+
+static inline void Bench_Start(void) { }
+static inline void Bench_Task(void) { }
+
+#endif
+
+#endif // BENCH_H
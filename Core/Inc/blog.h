@@ -0,0 +1,71 @@
+/*
+ * Двоичный лог с отложенным форматированием.
+ *
+ * BLOG("UNIT%d TX: %c\r\n", u, cmd) кладёт в кольцо USB-лога только
+ * идентификатор строки формата и аргументы (varint), форматирует хост:
+ * Tools/blog_decode.py берёт строки из Debug/Pult.elf.
+ *
+ * Строки формата лежат в секции .blog_fmt, которая в линкер-скрипте
+ * помечена INFO: во flash не попадает, остаётся только в ELF. Идентификатор —
+ * смещение строки в этой секции.
+ *
+ * Аргументы — до BLOG_MAX_ARGS целых до 32 бит (%d %u %x %c, модификаторы
+ * l/h игнорируются). %s — только строки-константы во flash, через BLOG_STR():
+ * хост читает их из ELF по адресу. Строки из RAM и 64-битные значения —
+ * через UsbLog_Printf.
+ *
+ * Запись в потоке: 0x1E, id (2 байта LE), n, n аргументов varint.
+ * Дамп буфера: 0x1E, id, 0xFF, len, len байт. Текст UsbLog_Printf идёт
+ * в том же потоке, 0x1E в нём не встречается.
+ *
+ * BLOG_ENABLED = 0 — те же вызовы печатают текст через UsbLog_Printf.
+ */
+#ifndef BLOG_H
+#define BLOG_H
+
+#include <stdint.h>
+#include "usb_log.h"
+
+#ifndef BLOG_ENABLED
+#define BLOG_ENABLED 1
+#endif
+
+#define BLOG_MAX_ARGS   8u
+#define BLOG_SYNC       0x1Eu
+#define BLOG_DUMP_MARK  0xFFu
+
+void Blog_Write(uint16_t id, uint32_t nargs, const uint32_t *args);
+void Blog_Dump(uint16_t id, const uint8_t *data, uint16_t len);
+void Blog_DumpText(const char *label, const uint8_t *data, uint16_t len);
+
+#define BLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define BLOG_NARGS(...) BLOG_NARGS_(_0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#define BLOG_FMT_(name, fmt) \
+    static const char name[] __attribute__((section(".blog_fmt"), used)) = fmt
+
+#if BLOG_ENABLED
+
+#define BLOG_STR(s)  ((uint32_t)(uintptr_t)(s))
+
+#define BLOG(fmt, ...) do { \
+    BLOG_FMT_(blog_fmt_, fmt); \
+    const uint32_t blog_args_[] = { 0u, ##__VA_ARGS__ }; \
+    Blog_Write((uint16_t)(uintptr_t)blog_fmt_, BLOG_NARGS(__VA_ARGS__), &blog_args_[1]); \
+} while (0)
+
+/* Хост печатает: "<label> (len): XX XX ... | ascii" */
+#define BLOG_DUMP(label, data, len) do { \
+    BLOG_FMT_(blog_fmt_, label); \
+    Blog_Dump((uint16_t)(uintptr_t)blog_fmt_, (data), (len)); \
+} while (0)
+
+#else
+
+#define BLOG_STR(s)                 (s)
+#define BLOG(fmt, ...)              UsbLog_Printf(fmt, ##__VA_ARGS__)
+#define BLOG_DUMP(label, data, len) Blog_DumpText(label, (data), (len))
+
+#endif
+
+#endif // BLOG_H
@@ -0,0 +1,52 @@
+/*
+ * Загрузка по стадиям: опрос ведомых не ждёт остальной периферии.
+ *
+ * Boot_Start() (USER CODE 2, сразу после MX_*_Init) запускает опрос на
+ * настройках по умолчанию — первый S уходит на первом проходе main loop —
+ * и ставит чтение зеркала EEPROM в очередь I2C. Дальше всё идёт
+ * параллельно из Boot_Task() в main loop, без блокирующих ожиданий:
+ *   EEPROM  — зеркало загружено: Config_Init(), адреса и скорости ведомых,
+ *             контраст панелей, UI_Init();
+ *   дисплей — reset и последовательность инициализации SSD1309_Task;
+ *   USB     — перечисление (хост выбрал конфигурацию CDC), лог до него
+ *             копится в кольце usb_log.
+ *
+ * Каждая стадия отмечается один раз, в мкс от DWT_CyclesInit(); когда
+ * отмечены все, в USB-лог уходит одна строка отчёта (мкс от Boot_Start):
+ *   Boot [us]: poll 12 first_s 31 config 11840 ui 11905 display 141300 usb 912000
+ */
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+#include "ssd1309.h"
+
+#define BOOT_MAX_DISPLAYS  3u
+#define BOOT_NOT_REACHED   0xFFFFFFFFu
+
+typedef enum {
+    BOOT_PHASE_START = 0,      // Boot_Start: периферия CubeMX готова
+    BOOT_PHASE_POLL_START,     // Dispenser_Init, приём UART запущен
+    BOOT_PHASE_FIRST_POLL,     // первый кадр S отдан в UART
+    BOOT_PHASE_CONFIG,         // зеркало EEPROM загружено, настройки применены
+    BOOT_PHASE_UI,             // UI_Init: клавиатура, экраны
+    BOOT_PHASE_DISPLAY,        // все панели проинициализированы
+    BOOT_PHASE_USB,            // хост выбрал конфигурацию CDC
+    BOOT_PHASES
+} Boot_Phase_t;
+
+void Boot_Start(void);
+
+// Панель, которой нужны контраст и инверсия из настроек; до Boot_Task
+void Boot_AttachDisplay(SSD1309_t *d);
+
+// Вызывать в while(1), после EEPROM_Task
+void Boot_Task(void);
+
+// Только первая отметка стадии
+void Boot_Mark(Boot_Phase_t phase);
+
+uint8_t Boot_Reached(Boot_Phase_t phase);
+uint32_t Boot_GetUs(Boot_Phase_t phase);    // BOOT_NOT_REACHED — ещё нет
+
+#endif // BOOT_H
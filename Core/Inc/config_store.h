@@ -0,0 +1,69 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include "main.h"
+
+/*
+ * Настройки пульта в EEPROM: две чередующиеся копии (слоты A/B), у каждой
+ * заголовок с номером версии схемы, порядковым номером записи и CRC16.
+ * Сохранение пишет в слот, где лежит более старая копия, поэтому обрыв
+ * питания посреди записи портит только её — при загрузке берётся самая
+ * новая копия с верной CRC.
+ *
+ * Правило схемы: новые поля только дописываются в конец Config_t с
+ * увеличением CONFIG_VERSION. Старая запись читается как префикс поверх
+ * значений по умолчанию; если поле меняет смысл — правка в Migrate().
+ */
+#define CONFIG_VERSION      1u
+#define CONFIG_UNITS        2u
+#define CONFIG_NOZZLES      4u
+
+#define CONFIG_SLOT_A       0x0100u    // начало страницы EEPROM
+#define CONFIG_SLOT_SIZE    128u       // две страницы: запас на рост схемы
+#define CONFIG_SLOT_B       (CONFIG_SLOT_A + CONFIG_SLOT_SIZE)
+
+// Старая раскладка (до версии 1): цены uint32 big-endian по 0x0000 и 0x0004
+#define CONFIG_LEGACY_PRICE0 0x0000u
+#define CONFIG_LEGACY_PRICE1 0x0004u
+
+#define CONFIG_PRICE_MAX    9999u
+#define CONFIG_PRICE_DEFAULT 1100u
+
+typedef struct {
+    uint32_t price[CONFIG_UNITS][CONFIG_NOZZLES];  // коп/л, индекс 0 — пистолет 1
+    uint32_t baud[CONFIG_UNITS];                   // USART2, USART3
+    uint8_t  slave_addr[CONFIG_UNITS];             // адрес GasKitLink
+    uint16_t poll_idle_ms;                         // опрос S в простое
+    uint16_t poll_fuelling_ms;                     // опрос S во время налива
+    uint16_t reply_timeout_ms;                     // ожидание ответа ведомого
+    uint8_t  contrast;                             // SSD1309, 0x81
+    uint8_t  invert;
+    uint8_t  debug_overlay;
+    uint8_t  reserved;
+} Config_t;
+
+typedef enum {
+    CONFIG_SRC_DEFAULTS = 0,   // копий нет или обе испорчены
+    CONFIG_SRC_LEGACY,         // перенесено из старой раскладки цен
+    CONFIG_SRC_SLOT_A,
+    CONFIG_SRC_SLOT_B
+} Config_Source_t;
+
+// Умолчания до загрузки зеркала EEPROM: опрос ведомых начинается на них
+void Config_InitDefaults(void);
+
+// Оба слота из зеркала EEPROM (после EEPROM_InitAsync); без зеркала —
+// блокирующее чтение с шины. Применение к ведомым и дисплею — boot.c
+Config_Source_t Config_Init(void);
+
+const Config_t *Config_Get(void);
+
+// Запись в свободный слот через отложенную запись EEPROM, не блокирует.
+// HAL_BUSY — очередь EEPROM полна, активная копия не меняется
+HAL_StatusTypeDef Config_Save(const Config_t *cfg);
+HAL_StatusTypeDef Config_SetPrice(uint8_t unit, uint8_t nozzle, uint32_t price);
+
+uint32_t Config_GetSeq(void);
+Config_Source_t Config_GetSource(void);   // откуда взяты настройки при загрузке
+
+#endif // CONFIG_STORE_H
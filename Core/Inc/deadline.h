@@ -0,0 +1,37 @@
+/*
+ * Ближайший срок, к которому main loop снова нужен модулям.
+ *
+ * Модуль, который ждёт времени (таймаут ответа, период опроса, задержка
+ * записи), отмечает в проверке тик, когда она сработает:
+ *
+ *   if ((now - start) > timeout) { ... }
+ *   Deadline_At(start + timeout + 1u);
+ *
+ * За итерацию main loop отметки сводятся к минимуму (Deadline_Take): до
+ * этого тика, если не придёт прерывание, итерации ничего не меняют.
+ * Отмечать стоит только ожидания; работа «прямо сейчас» отмечает now.
+ *
+ * На плате main loop пока крутится без сна и минимум не читает — цена
+ * отметки одно сравнение. Хостовая симуляция по нему перескакивает простой
+ * (App_RunFast в Host/app.c).
+ */
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <stdint.h>
+
+extern uint32_t deadline_next;
+extern uint8_t deadline_set;
+
+static inline void Deadline_At(uint32_t tick)
+{
+    if (!deadline_set || (int32_t)(tick - deadline_next) < 0) {
+        deadline_next = tick;
+        deadline_set = 1u;
+    }
+}
+
+/* Минимум отметок с прошлого вызова; 0 — отметок не было */
+uint8_t Deadline_Take(uint32_t *tick);
+
+#endif // DEADLINE_H
@@ -69,6 +69,7 @@ typedef struct {
 } Dispenser_t;
 
 void Dispenser_Init(void);
+void Dispenser_ApplyConfig(void);   // адреса и скорости из Config после загрузки EEPROM
 void Dispenser_Update(void);
 
 // Commands для конкретного ведомого
@@ -84,4 +85,7 @@ void Dispenser_SwitchActiveUnit(uint8_t unit_idx);
 uint8_t Dispenser_GetActiveUnit(void);
 DispenserUnit_t* Dispenser_GetUnit(uint8_t unit_idx);
 
+// Разбор ответа S, как в цикле опроса: 1 - нужна следующая команда (для bench.c)
+uint8_t Dispenser_ProcessStatus(uint8_t unit_idx, const GasFrame_t *frame);
+
 #endif // DISPENSER_H
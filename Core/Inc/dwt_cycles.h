@@ -0,0 +1,31 @@
+/*
+ * Счётчик тактов ядра (DWT->CYCCNT) для замеров длительности.
+ * 32 бита на 480 МГц переполняются примерно через 8.9 с — разность
+ * (uint32_t)(t1 - t0) корректна для интервалов короче этого.
+ */
+#ifndef DWT_CYCLES_H
+#define DWT_CYCLES_H
+
+#include "stm32h7xx.h"
+#include <stdint.h>
+
+/* Вызвать один раз после SystemClock_Config() */
+static inline void DWT_CyclesInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = 0xC5ACCE55u;   /* Cortex-M7: снять блокировку записи в DWT */
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t DWT_Cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+static inline uint32_t DWT_CyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000u);
+}
+
+#endif // DWT_CYCLES_H
@@ -6,15 +6,103 @@
 
 #define AT24C256_ADDR 0xA0
 
+/*
+ * Асинхронный драйвер AT24C256 на I2C1 (прерывания).
+ *
+ * Запросы ставятся в очередь и выполняются из EEPROM_Task() по событиям
+ * HAL_I2C_*Callback. Запись режется по страницам 64 байта; окончание цикла
+ * записи определяется опросом ACK (адрес без данных), а не HAL_Delay(5).
+ * Callback завершения вызывается из EEPROM_Task(), то есть в main loop.
+ */
+#define EEPROM_PAGE_SIZE        64u
+#define EEPROM_SIZE             32768u
+#define EEPROM_QUEUE_LEN        8u
+#define EEPROM_MAX_WRITE        64u     // данные записи копируются в очередь
+#define EEPROM_WRITE_TIMEOUT_MS 20u     // tWR по даташиту 5 мс, запас на сбои шины
+
+/*
+ * Отложенная запись (write-back): EEPROM_Stage() только помечает байты
+ * страницы грязными. Страница уходит в очередь одним запросом через
+ * EEPROM_WB_DELAY_MS после первого изменения, поэтому соседние обновления
+ * (две цены, запись журнала и её индекс) стоят одного цикла записи.
+ * Несмежные грязные участки одной страницы тоже уходят одним запросом, от
+ * первого до последнего грязного байта: промежутки между ними перед
+ * записью дочитываются из микросхемы (один запрос чтения). Только при
+ * вытеснении раньше срока участки пишутся по отдельности, без чтения.
+ */
+#define EEPROM_WB_PAGES         4u
+#define EEPROM_WB_DELAY_MS      10u
+
+/*
+ * Зеркало начала EEPROM в RAM (настройки и старые цены). Загружается одним
+ * чтением из очереди (EEPROM_InitAsync), дальше все чтения этой области
+ * идут из RAM.
+ * Изменённые байты копятся в самом зеркале и пишутся, когда очередь I2C
+ * пуста (не позже EEPROM_MIRROR_MAX_DELAY_MS). Страница уходит одним
+ * запросом от первого до последнего изменённого байта; неизменившиеся байты
+ * за пределами этого участка на шину не попадают. Размер кратен странице.
+ */
+#define EEPROM_MIRROR_SIZE      512u
+#define EEPROM_MIRROR_MAX_DELAY_MS 1000u
+
+typedef struct {
+    uint32_t staged;        // вызовов EEPROM_Stage
+    uint32_t staged_bytes;
+    uint32_t page_writes;   // запросов записи, ушедших в очередь
+    uint32_t write_bytes;
+    uint32_t evictions;     // страниц вытеснено раньше срока (нет свободного слота)
+    uint32_t fill_reads;    // дочитываний промежутков страницы перед записью
+    uint32_t unchanged_bytes; // записано в зеркало без изменений — на шину не ушли
+    uint32_t mirror_hits;   // чтений, обслуженных из зеркала
+} EEPROM_Stats_t;
+
+typedef void (*EEPROM_Callback_t)(HAL_StatusTypeDef status, void *ctx);
+
+// Постановка в очередь. HAL_BUSY — очередь полна, HAL_ERROR — неверные аргументы
+HAL_StatusTypeDef EEPROM_WriteAsync(uint16_t mem_addr, const uint8_t *data, uint16_t size,
+                                    EEPROM_Callback_t cb, void *ctx);
+// data должен жить до вызова cb
+HAL_StatusTypeDef EEPROM_ReadAsync(uint16_t mem_addr, uint8_t *data, uint16_t size,
+                                   EEPROM_Callback_t cb, void *ctx);
+
+// Отложенная запись, данные копируются. HAL_BUSY — нет слота и очередь полна
+HAL_StatusTypeDef EEPROM_Stage(uint16_t mem_addr, const uint8_t *data, uint16_t size);
+// Поставить все грязные страницы в очередь сейчас, не дожидаясь задержки
+HAL_StatusTypeDef EEPROM_Flush(void);
+// Барьер: cb вызывается, когда всё изменённое до этого вызова записано в
+// микросхему (HAL_ERROR — какая-то из этих записей не прошла). Один барьер
+// в ожидании, повторный вызов до его постановки — HAL_BUSY
+HAL_StatusTypeDef EEPROM_FlushBarrier(EEPROM_Callback_t cb, void *ctx);
+
+void EEPROM_GetStats(EEPROM_Stats_t *out);
+void EEPROM_ResetStats(void);
+
+// Вызывать в while(1)
+void EEPROM_Task(void);
+uint8_t EEPROM_IsIdle(void);      // очередь пуста и грязных страниц нет
+
+// Маршрутизация из HAL_I2C_*Callback (hi2c1)
+void EEPROM_OnI2cDone(I2C_HandleTypeDef *hi2c);
+void EEPROM_OnI2cError(I2C_HandleTypeDef *hi2c);
+
+// Драйвер в исходное состояние и загрузка зеркала первым запросом очереди,
+// один раз после MX_I2C1_Init(). cb — из EEPROM_Task, когда зеркало
+// загружено; при ошибке оно выключено и чтения идут на шину
+HAL_StatusTypeDef EEPROM_InitAsync(EEPROM_Callback_t cb, void *ctx);
+
+// Блокирующие варианты — только до запуска main loop (начальная загрузка);
+// запись режется по страницам, с ожиданием цикла записи после каждой;
+// при непустой очереди возвращают HAL_BUSY. Чтение учитывает ещё не
+// записанные байты из EEPROM_Stage(); из зеркала отвечает сразу, без шины
 HAL_StatusTypeDef EEPROM_Write(uint16_t mem_addr, uint8_t *data, uint16_t size);
 HAL_StatusTypeDef EEPROM_Read(uint16_t mem_addr, uint8_t *data, uint16_t size);
 
 // Specific helpers for this project
-HAL_StatusTypeDef EEPROM_SavePrice(uint32_t price);
+HAL_StatusTypeDef EEPROM_SavePrice(uint32_t price);       // отложенная запись
 uint32_t EEPROM_LoadPrice(void);
 
 // Additional helper for second unit
-HAL_StatusTypeDef EEPROM_SavePriceToAddr(uint16_t addr, uint32_t price);
+HAL_StatusTypeDef EEPROM_SavePriceToAddr(uint16_t addr, uint32_t price);  // отложенная запись
 uint32_t EEPROM_LoadPriceFromAddr(uint16_t addr);
 
 #endif // EEPROM_AT24_H
@@ -0,0 +1,251 @@
+/*
+ * Крупные цифры 16x24 и 16x32 (7-сегментный стиль) для объёма/суммы.
+ *
+ * Глифы хранятся сразу в формате страниц SSD1309: [глиф][страница][колонка],
+ * бит 0 = верхняя строка страницы. Вывод при y, кратном 8, — это memcpy
+ * по страницам без попиксельной отрисовки.
+ *
+ * Подмножество глифов выбирается при сборке (-D...=0/1):
+ *   FONT_DIGITS_16X24 / FONT_DIGITS_16X32  - какие размеры компилировать;
+ *   FONT_DIGITS_HAS_DOT / _MINUS / _COLON  - дополнительные символы.
+ * Цифры '0'..'9' и пробел есть всегда. Выброшенный глиф SSD1309_DrawBigChar
+ * рисует рамкой; что нужно экранам, проверяет ui_manager.c при сборке.
+ */
+#ifndef FONT_DIGITS_H
+#define FONT_DIGITS_H
+
+#include <stdint.h>
+#include "font_digits_cfg.h"
+
+/* Индексы глифов с учётом выброшенных символов */
+#define FONT_DIGITS_IDX_SPACE  10u
+#define FONT_DIGITS_IDX_DOT    (FONT_DIGITS_IDX_SPACE + 1u)
+#define FONT_DIGITS_IDX_MINUS  (FONT_DIGITS_IDX_DOT   + FONT_DIGITS_HAS_DOT)
+#define FONT_DIGITS_IDX_COLON  (FONT_DIGITS_IDX_MINUS + FONT_DIGITS_HAS_MINUS)
+#define FONT_DIGITS_COUNT      (FONT_DIGITS_IDX_COLON + FONT_DIGITS_HAS_COLON)
+
+/* Индекс глифа для символа, либо -1 если символ не скомпилирован */
+static inline int font_digits_index(char ch)
+{
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    switch (ch) {
+    case ' ': return (int)FONT_DIGITS_IDX_SPACE;
+#if FONT_DIGITS_HAS_DOT
+    case '.': return (int)FONT_DIGITS_IDX_DOT;
+#endif
+#if FONT_DIGITS_HAS_MINUS
+    case '-': return (int)FONT_DIGITS_IDX_MINUS;
+#endif
+#if FONT_DIGITS_HAS_COLON
+    case ':': return (int)FONT_DIGITS_IDX_COLON;
+#endif
+    default:  return -1;
+    }
+}
+
+#if FONT_DIGITS_16X24
+static const uint8_t font_digits_16x24[FONT_DIGITS_COUNT][3][16] = {
+    /* '0' */ {
+        {0xF0,0xF8,0xF4,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0xF4,0xF8,0xF0,0x00,0x00,0x00},
+        {0xE3,0xF7,0xE3,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE3,0xF7,0xE3,0x00,0x00,0x00},
+        {0x0F,0x1F,0x2F,0x70,0x70,0x70,0x70,0x70,0x70,0x70,0x2F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* '1' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xF0,0xF8,0xF0,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE3,0xF7,0xE3,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* '2' */ {
+        {0x00,0x00,0x04,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0xF4,0xF8,0xF0,0x00,0x00,0x00},
+        {0xE0,0xF0,0xE8,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x0B,0x07,0x03,0x00,0x00,0x00},
+        {0x0F,0x1F,0x2F,0x70,0x70,0x70,0x70,0x70,0x70,0x70,0x20,0x00,0x00,0x00,0x00,0x00}
+    },
+    /* '3' */ {
+        {0x00,0x00,0x04,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0xF4,0xF8,0xF0,0x00,0x00,0x00},
+        {0x00,0x00,0x08,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0xEB,0xF7,0xE3,0x00,0x00,0x00},
+        {0x00,0x00,0x20,0x70,0x70,0x70,0x70,0x70,0x70,0x70,0x2F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* '4' */ {
+        {0xF0,0xF8,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xF0,0xF8,0xF0,0x00,0x00,0x00},
+        {0x03,0x07,0x0B,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0xEB,0xF7,0xE3,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* '5' */ {
+        {0xF0,0xF8,0xF4,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x04,0x00,0x00,0x00,0x00,0x00},
+        {0x03,0x07,0x0B,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0xE8,0xF0,0xE0,0x00,0x00,0x00},
+        {0x00,0x00,0x20,0x70,0x70,0x70,0x70,0x70,0x70,0x70,0x2F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* '6' */ {
+        {0xF0,0xF8,0xF4,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x04,0x00,0x00,0x00,0x00,0x00},
+        {0xE3,0xF7,0xEB,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0xE8,0xF0,0xE0,0x00,0x00,0x00},
+        {0x0F,0x1F,0x2F,0x70,0x70,0x70,0x70,0x70,0x70,0x70,0x2F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* '7' */ {
+        {0x00,0x00,0x04,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0xF4,0xF8,0xF0,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE3,0xF7,0xE3,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* '8' */ {
+        {0xF0,0xF8,0xF4,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0xF4,0xF8,0xF0,0x00,0x00,0x00},
+        {0xE3,0xF7,0xEB,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0xEB,0xF7,0xE3,0x00,0x00,0x00},
+        {0x0F,0x1F,0x2F,0x70,0x70,0x70,0x70,0x70,0x70,0x70,0x2F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* '9' */ {
+        {0xF0,0xF8,0xF4,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0x0E,0xF4,0xF8,0xF0,0x00,0x00,0x00},
+        {0x03,0x07,0x0B,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0xEB,0xF7,0xE3,0x00,0x00,0x00},
+        {0x00,0x00,0x20,0x70,0x70,0x70,0x70,0x70,0x70,0x70,0x2F,0x1F,0x0F,0x00,0x00,0x00}
+    },
+    /* ' ' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+#if FONT_DIGITS_HAS_DOT
+    /* '.' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x70,0x70,0x70,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+#endif
+#if FONT_DIGITS_HAS_MINUS
+    /* '-' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x08,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x08,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+#endif
+#if FONT_DIGITS_HAS_COLON
+    /* ':' */ {
+        {0x00,0xC0,0xC0,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0xC1,0xC1,0xC1,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x01,0x01,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+#endif
+};
+
+static const uint8_t font_digits_16x24_w[FONT_DIGITS_COUNT] = {
+    16,16,16,16,16,16,16,16,16,16, /* '0'..'9' */
+    16,                            /* ' ' */
+#if FONT_DIGITS_HAS_DOT
+    6,
+#endif
+#if FONT_DIGITS_HAS_MINUS
+    16,
+#endif
+#if FONT_DIGITS_HAS_COLON
+    6,
+#endif
+};
+#endif /* FONT_DIGITS_16X24 */
+
+
+#if FONT_DIGITS_16X32
+static const uint8_t font_digits_16x32[FONT_DIGITS_COUNT][4][16] = {
+    /* '0' */ {
+        {0xE0,0xF0,0xF0,0xEC,0x1E,0x1E,0x1E,0x1E,0x1E,0xEC,0xF0,0xF0,0xE0,0x00,0x00,0x00},
+        {0x3F,0x7F,0x7F,0x3F,0x00,0x00,0x00,0x00,0x00,0x3F,0x7F,0x7F,0x3F,0x00,0x00,0x00},
+        {0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00,0x00,0x00,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x07,0x0F,0x0F,0x37,0x78,0x78,0x78,0x78,0x78,0x37,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* '1' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xE0,0xF0,0xF0,0xE0,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0x7F,0x7F,0x3F,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x07,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* '2' */ {
+        {0x00,0x00,0x00,0x0C,0x1E,0x1E,0x1E,0x1E,0x1E,0xEC,0xF0,0xF0,0xE0,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0xC0,0xE0,0xE0,0xE0,0xE0,0xE0,0xFF,0x7F,0x7F,0x3F,0x00,0x00,0x00},
+        {0xFE,0xFF,0xFF,0xFE,0x01,0x01,0x01,0x01,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x07,0x0F,0x0F,0x37,0x78,0x78,0x78,0x78,0x78,0x30,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+    /* '3' */ {
+        {0x00,0x00,0x00,0x0C,0x1E,0x1E,0x1E,0x1E,0x1E,0xEC,0xF0,0xF0,0xE0,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0xC0,0xE0,0xE0,0xE0,0xE0,0xE0,0xFF,0x7F,0x7F,0x3F,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x01,0x01,0x01,0x01,0x01,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x30,0x78,0x78,0x78,0x78,0x78,0x37,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* '4' */ {
+        {0xE0,0xF0,0xF0,0xE0,0x00,0x00,0x00,0x00,0x00,0xE0,0xF0,0xF0,0xE0,0x00,0x00,0x00},
+        {0x3F,0x7F,0x7F,0xFF,0xE0,0xE0,0xE0,0xE0,0xE0,0xFF,0x7F,0x7F,0x3F,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x01,0x01,0x01,0x01,0x01,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x07,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* '5' */ {
+        {0xE0,0xF0,0xF0,0xEC,0x1E,0x1E,0x1E,0x1E,0x1E,0x0C,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x3F,0x7F,0x7F,0xFF,0xE0,0xE0,0xE0,0xE0,0xE0,0xC0,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x01,0x01,0x01,0x01,0x01,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x30,0x78,0x78,0x78,0x78,0x78,0x37,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* '6' */ {
+        {0xE0,0xF0,0xF0,0xEC,0x1E,0x1E,0x1E,0x1E,0x1E,0x0C,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x3F,0x7F,0x7F,0xFF,0xE0,0xE0,0xE0,0xE0,0xE0,0xC0,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0xFE,0xFF,0xFF,0xFE,0x01,0x01,0x01,0x01,0x01,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x07,0x0F,0x0F,0x37,0x78,0x78,0x78,0x78,0x78,0x37,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* '7' */ {
+        {0x00,0x00,0x00,0x0C,0x1E,0x1E,0x1E,0x1E,0x1E,0xEC,0xF0,0xF0,0xE0,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0x7F,0x7F,0x3F,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x07,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* '8' */ {
+        {0xE0,0xF0,0xF0,0xEC,0x1E,0x1E,0x1E,0x1E,0x1E,0xEC,0xF0,0xF0,0xE0,0x00,0x00,0x00},
+        {0x3F,0x7F,0x7F,0xFF,0xE0,0xE0,0xE0,0xE0,0xE0,0xFF,0x7F,0x7F,0x3F,0x00,0x00,0x00},
+        {0xFE,0xFF,0xFF,0xFE,0x01,0x01,0x01,0x01,0x01,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x07,0x0F,0x0F,0x37,0x78,0x78,0x78,0x78,0x78,0x37,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* '9' */ {
+        {0xE0,0xF0,0xF0,0xEC,0x1E,0x1E,0x1E,0x1E,0x1E,0xEC,0xF0,0xF0,0xE0,0x00,0x00,0x00},
+        {0x3F,0x7F,0x7F,0xFF,0xE0,0xE0,0xE0,0xE0,0xE0,0xFF,0x7F,0x7F,0x3F,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x01,0x01,0x01,0x01,0x01,0xFE,0xFF,0xFF,0xFE,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x30,0x78,0x78,0x78,0x78,0x78,0x37,0x0F,0x0F,0x07,0x00,0x00,0x00}
+    },
+    /* ' ' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+#if FONT_DIGITS_HAS_DOT
+    /* '.' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x78,0x78,0x78,0x78,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+#endif
+#if FONT_DIGITS_HAS_MINUS
+    /* '-' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0xC0,0xE0,0xE0,0xE0,0xE0,0xE0,0xC0,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x01,0x01,0x01,0x01,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+#endif
+#if FONT_DIGITS_HAS_COLON
+    /* ':' */ {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x1E,0x1E,0x1E,0x1E,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x3C,0x3C,0x3C,0x3C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    },
+#endif
+};
+
+static const uint8_t font_digits_16x32_w[FONT_DIGITS_COUNT] = {
+    16,16,16,16,16,16,16,16,16,16, /* '0'..'9' */
+    16,                            /* ' ' */
+#if FONT_DIGITS_HAS_DOT
+    7,
+#endif
+#if FONT_DIGITS_HAS_MINUS
+    16,
+#endif
+#if FONT_DIGITS_HAS_COLON
+    7,
+#endif
+};
+#endif /* FONT_DIGITS_16X32 */
+
+#endif /* FONT_DIGITS_H */
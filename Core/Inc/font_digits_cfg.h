@@ -0,0 +1,25 @@
+/*
+ * Подмножество глифов крупных цифр (font_digits.h), без самих таблиц:
+ * флаги нужны и тем, кто шрифт только использует (проверки ui_manager.c).
+ */
+#ifndef FONT_DIGITS_CFG_H
+#define FONT_DIGITS_CFG_H
+
+#ifndef FONT_DIGITS_16X24
+#define FONT_DIGITS_16X24     1
+#endif
+#ifndef FONT_DIGITS_16X32
+#define FONT_DIGITS_16X32     0
+#endif
+
+#ifndef FONT_DIGITS_HAS_DOT
+#define FONT_DIGITS_HAS_DOT   1
+#endif
+#ifndef FONT_DIGITS_HAS_MINUS
+#define FONT_DIGITS_HAS_MINUS 0
+#endif
+#ifndef FONT_DIGITS_HAS_COLON
+#define FONT_DIGITS_HAS_COLON 0
+#endif
+
+#endif /* FONT_DIGITS_CFG_H */
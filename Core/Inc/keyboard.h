@@ -2,12 +2,81 @@
 #define KEYBOARD_H
 
 #include "main.h"
+#include <stdbool.h>
 
 #define KEY_ROWS 5
 #define KEY_COLS 4
 
-void Keyboard_Init(void);
-char Keyboard_Scan(void);
-char Keyboard_GetKey(void); // Returns key only once per press (debounced)
+/*
+ * Сканирование от TIM3 (1 кГц): за один тик читается одна строка, строка
+ * успевает установиться до следующего тика, поэтому ожидания нет вовсе.
+ * Полный опрос матрицы — KEY_SCAN_PERIOD_MS.
+ *
+ * Антидребезг — интегратор на каждую клавишу: нажатие признаётся после
+ * KEY_DEBOUNCE_SCANS одинаковых опросов подряд. Задержка реакции не больше
+ * (KEY_DEBOUNCE_SCANS + 1) * KEY_SCAN_PERIOD_MS.
+ *
+ * KEYBOARD_SCAN_DMA = 1: строки переключает DMA по TIM3 (UP/CC2 -> BSRR),
+ * столбцы снимает DMA по CC1 (IDR -> кольцевой буфер). Прерываний нет, CPU
+ * разбирает накопленные проходы в Keyboard_GetEvent() вертикальными счётчиками.
+ * Если разводка не подходит для DMA, используется прерывание TIM3.
+ *
+ * Пока клавиши не нажаты, сканер стоит: все строки low, столбцы ждут спада по
+ * EXTI. Первое нажатие запускает сканирование, после KEY_IDLE_MS тишины
+ * матрица снова уходит в ожидание.
+ *
+ * События складываются в очередь (один писатель — ISR, один читатель — main loop),
+ * несколько одновременно нажатых клавиш не теряются.
+ */
+#ifndef KEYBOARD_SCAN_DMA
+#define KEYBOARD_SCAN_DMA    1
+#endif
+
+#define KEY_SCAN_PERIOD_MS   KEY_ROWS   /* 1 строка за 1 мс */
+#define KEY_DEBOUNCE_SCANS   4u
+#define KEY_LONGPRESS_MS     1000u
+#define KEY_QUEUE_SIZE       32u        /* степень двойки */
+#define KEY_IDLE_MS          100u       /* тишина до возврата в ожидание EXTI */
+
+/* Клавиши с автоповтором: цифры и RES (очистка) */
+#ifndef KEY_REPEAT_KEYS
+#define KEY_REPEAT_KEYS      "0123456789E"
+#endif
+#define KEY_REPEAT_DELAY_MS  500u
+#define KEY_REPEAT_RATE_MS   100u
+
+typedef enum {
+    KEY_EV_PRESS = 0,
+    KEY_EV_RELEASE,
+    KEY_EV_LONG,      /* удержание дольше KEY_LONGPRESS_MS, один раз за нажатие */
+    KEY_EV_REPEAT     /* автоповтор для KEY_REPEAT_KEYS */
+} Keyboard_EventType_t;
+
+typedef struct {
+    char key;
+    uint8_t type;     /* Keyboard_EventType_t */
+} Keyboard_Event_t;
+
+void Keyboard_Init(void);                   // Запускает TIM3
+bool Keyboard_GetEvent(Keyboard_Event_t *ev);
+char Keyboard_GetKey(void);                 // Нажатие или автоповтор, 0 если событий нет
+
+// Автоповтор: delay_ms = 0 выключает
+void Keyboard_SetAutoRepeat(uint16_t delay_ms, uint16_t rate_ms);
+
+// Событий потеряно из-за переполнения очереди
+uint32_t Keyboard_GetDropped(void);
+
+// Режим DMA: разбор отстал на кольцо проходов (main loop стоял дольше 75 мс)
+uint32_t Keyboard_GetOverruns(void);
+
+// Сканер остановлен, ждёт нажатия: клавиатура не мешает спать
+bool Keyboard_IsIdle(void);
+
+// Из HAL_TIM_PeriodElapsedCallback для TIM3 (в режиме DMA не вызывается)
+void Keyboard_OnTick(void);
+
+// Из HAL_GPIO_EXTI_Callback
+void Keyboard_OnExti(uint16_t pin);
 
 #endif // KEYBOARD_H
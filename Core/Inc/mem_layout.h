@@ -0,0 +1,42 @@
+/*
+ * Размещение кода и данных по областям памяти STM32H750.
+ *
+ * ITCM_CODE — функция в ITCM (64 КБ с адреса 0): выполнение без тактов
+ * ожидания, не зависит от флеша и I-кэша. Для обработчиков прерываний,
+ * разбора протокола и вывода глифов. Вызовы между ITCM и флешем линкер
+ * делает через переходники (veneer) — в самых частых вызовах это лишний
+ * переход, поэтому горячий путь лучше держать в ITCM целиком.
+ *
+ * DTCM_DATA / DTCM_BSS — переменные в DTCM (128 КБ): один такт, без кэша.
+ * Первые копируются из флеша, вторые обнуляются (startup_stm32h750vbtx.s).
+ * DMA1/DMA2 в DTCM не достают — буферы DMA только через DMA_BUFFER.
+ *
+ * Заполнение областей печатает линкер (--print-memory-usage), подробности
+ * по символам — в Pult.map.
+ *
+ * I- и D-кэш включены (main.c). Буферы, которые читает или пишет DMA,
+ * кладутся в секцию .dma_buffer — начало D2 SRAM (0x30000000), которое MPU
+ * (MPU_Config, регион 1) делает некэшируемым. Для них не нужны ни Clean,
+ * ни Invalidate, и они доступны DMA1/DMA2 в обоих линкер-скриптах (в DTCM,
+ * где у RAM-сборки лежат .data/.bss, DMA1/DMA2 не достают).
+ *
+ * Секция NOLOAD: стартовый код её не обнуляет, начальное содержимое
+ * буфера не определено. Размер ограничен регионом MPU (DMA_REGION_SIZE,
+ * проверяется ASSERT в линкер-скрипте).
+ *
+ *   static uint8_t rx_buf[64] DMA_BUFFER;
+ */
+#ifndef MEM_LAYOUT_H
+#define MEM_LAYOUT_H
+
+#define ITCM_CODE   __attribute__((section(".itcm_text")))
+#define DTCM_DATA   __attribute__((section(".dtcm_data")))
+#define DTCM_BSS    __attribute__((section(".dtcm_bss")))
+
+#define DMA_REGION_BASE   0x30000000u
+#define DMA_REGION_SIZE   (32u * 1024u)   /* = MPU_REGION_SIZE_32KB */
+
+/* Выравнивание по линии кэша (32 байта), как у остальных DMA-буферов */
+#define DMA_BUFFER  __attribute__((section(".dma_buffer"), aligned(32)))
+
+#endif // MEM_LAYOUT_H
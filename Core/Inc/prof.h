@@ -0,0 +1,103 @@
+/*
+ * Профилирование по зонам на счётчике тактов DWT->CYCCNT.
+ *
+ *   PROF_BEGIN(UI_DRAW);
+ *   UI_Draw();
+ *   PROF_END(UI_DRAW);
+ *
+ * На зону: число замеров, минимум, среднее, максимум и гистограмма по
+ * степеням двойки (корзина k — от 2^k до 2^(k+1)-1 тактов, последняя —
+ * всё, что больше). Отдельно период main loop и его дрожание — разность
+ * соседних периодов (Prof_LoopTick в начале каждой итерации).
+ *
+ * Время зоны — полное, вместе с вытеснившими её прерываниями. Прерывания
+ * размечены в stm32h7xx_it.c, каждое — своей зоной, поэтому их вклад
+ * виден отдельно.
+ *
+ * Цена замера — два чтения CYCCNT и Prof_Record (ITCM, несколько десятков
+ * тактов), профилирование остаётся включённым и в выпускной сборке.
+ * Вывод по USB-команде 'P' (Prof_DumpStart): построчно, по мере места
+ * в кольце USB-лога. PROF_ENABLED = 0 убирает замеры совсем.
+ */
+#ifndef PROF_H
+#define PROF_H
+
+#include "stm32h7xx.h"
+#include <stdint.h>
+
+#ifndef PROF_ENABLED
+#define PROF_ENABLED 1
+#endif
+
+#define PROF_HIST_BINS  28u   /* 2^27 тактов = 280 мс на 480 МГц */
+
+/* Идентификатор, имя в отчёте */
+#define PROF_ZONE_LIST(X) \
+    X(LOOP,            "loop")              \
+    X(JITTER,          "loop_jitter")       \
+    X(DISPENSER,       "Dispenser_Update")  \
+    X(PROCESS_UNIT,    "ProcessUnitUpdate") \
+    X(UI_INPUT,        "UI_ProcessInput")   \
+    X(UI_DRAW,         "UI_Draw")           \
+    X(OLED_TASK,       "SSD1309_Bus_Task")  \
+    X(USBLOG_TASK,     "UsbLog_Task")       \
+    X(EEPROM_TASK,     "EEPROM_Task")       \
+    X(SYSTICK,         "isr SysTick")       \
+    X(DMA1_S0,         "isr DMA1_S0")       \
+    X(DMA1_S1,         "isr DMA1_S1")       \
+    X(DMA1_S2,         "isr DMA1_S2")       \
+    X(DMA1_S3,         "isr DMA1_S3")       \
+    X(DMA1_S5,         "isr DMA1_S5")       \
+    X(TIM2,            "isr TIM2")          \
+    X(TIM3,            "isr TIM3")          \
+    X(I2C1_EV,         "isr I2C1_EV")       \
+    X(I2C1_ER,         "isr I2C1_ER")       \
+    X(SPI2,            "isr SPI2")          \
+    X(USART2,          "isr USART2")        \
+    X(USART3,          "isr USART3")        \
+    X(EXTI15_10,       "isr EXTI15_10")     \
+    X(OTG_FS,          "isr OTG_FS")        \
+    X(OTG_FS_EP1_OUT,  "isr OTG_FS_EP1_OUT") \
+    X(OTG_FS_EP1_IN,   "isr OTG_FS_EP1_IN")
+
+typedef enum {
+#define PROF_ENUM_(id, name) PROF_##id,
+    PROF_ZONE_LIST(PROF_ENUM_)
+#undef PROF_ENUM_
+    PROF_ZONE_COUNT
+} Prof_Zone_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[PROF_HIST_BINS];
+} Prof_Stat_t;
+
+#if PROF_ENABLED
+
+#define PROF_BEGIN(id)  const uint32_t prof_t0_##id = DWT->CYCCNT
+#define PROF_END(id)    Prof_Record(PROF_##id, DWT->CYCCNT - prof_t0_##id)
+
+#else
+
+#define PROF_BEGIN(id)  do { } while (0)
+#define PROF_END(id)    do { } while (0)
+
+#endif
+
+/* Любой контекст; одна зона не должна писаться из двух контекстов сразу */
+void Prof_Record(Prof_Zone_t zone, uint32_t cycles);
+
+/* main loop: начало итерации */
+void Prof_LoopTick(void);
+
+void Prof_Reset(void);
+void Prof_Get(Prof_Zone_t zone, Prof_Stat_t *out);
+
+/* Отчёт в USB-лог: Prof_DumpStart запускает, Prof_Task выводит по строке */
+void Prof_DumpStart(void);
+void Prof_Task(void);
+
+#endif // PROF_H
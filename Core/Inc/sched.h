@@ -0,0 +1,103 @@
+/*
+ * Кооперативный планировщик main loop: статическая таблица задач, без
+ * стеков и без вытеснения. Задача — шаг, который выполняется до конца
+ * (run-to-completion) и возвращает управление.
+ *
+ * Уровни приоритета, сверху вниз: протокол (опрос ТРК), ввод (клавиатура,
+ * EEPROM, стадии загрузки), лог (USB), отрисовка. Проход Sched_Run
+ * выполняет по шагу каждой задачи в порядке уровней; задачи уровня
+ * протокола, кроме того, опрашиваются снова перед каждым шагом задачи
+ * ниже. Поэтому протокол ждёт не дольше самого длинного шага, а не всего
+ * прохода: обмен с ТРК не зависит от того, сколько рисует UI.
+ *
+ * Длинная работа режется точками уступки — протопоток на switch/case:
+ *
+ *   static uint8_t Draw(Sched_Task_t *t) {
+ *       static uint8_t i;              // переживает уступку только static
+ *       PT_BEGIN(t);
+ *       for (i = 0; i < n; i++) {
+ *           DrawPart(i);
+ *           PT_YIELD(t);               // следующий проход — отсюда
+ *       }
+ *       PT_END(t);
+ *   }
+ *
+ * Внутри протопотока нельзя свой switch вокруг PT_YIELD, локальные
+ * переменные после уступки не сохраняются.
+ *
+ * На задачу: шаги, такты ядра (доля CPU от времени с Sched_ResetStats),
+ * самый долгий шаг и наибольший интервал между началами соседних шагов —
+ * худшая задержка, с которой задача получала управление. Такты шага идут
+ * и в зону prof.h, если она указана. Отчёт — Sched_DumpStart (USB-команда 'T'),
+ * выводит его задача Sched_DumpTask построчно, по мере места в USB-логе.
+ */
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include "prof.h"
+
+#define SCHED_MAX_TASKS  16u
+
+typedef enum {
+    SCHED_PRIO_PROTOCOL = 0,
+    SCHED_PRIO_INPUT,
+    SCHED_PRIO_LOGGING,
+    SCHED_PRIO_RENDER,
+    SCHED_PRIO_LEVELS
+} Sched_Prio_t;
+
+// Результат шага
+#define SCHED_DONE   0u        // работа закончена, следующий шаг — с начала
+#define SCHED_YIELD  1u        // уступка, следующий шаг — с точки PT_YIELD
+
+#define SCHED_NO_ZONE PROF_ZONE_COUNT
+
+typedef struct Sched_Task_s Sched_Task_t;
+
+typedef struct {
+    uint32_t runs;             // шагов
+    uint32_t yields;           // из них закончились уступкой
+    uint64_t cycles;
+    uint32_t max_step;         // такты самого долгого шага
+    uint32_t max_latency;      // такты между началами соседних шагов, наибольший интервал
+} Sched_Stats_t;
+
+struct Sched_Task_s {
+    const char *name;
+    void (*call)(void);                  // простая задача: вызов целиком
+    uint8_t (*step)(Sched_Task_t *t);    // протопоток, если call == NULL
+    uint8_t prio;
+    Prof_Zone_t zone;                    // SCHED_NO_ZONE — без prof.h
+
+    uint16_t pt;                         // точка продолжения, 0 — начало
+    uint8_t started;                     // t_start уже есть
+    uint32_t t_start;                    // DWT начала прошлого шага
+    Sched_Stats_t stats;
+};
+
+#define SCHED_CALL(name, fn, prio, zone)  { (name), (fn), NULL, (prio), (zone), 0u, 0u, 0u, { 0 } }
+#define SCHED_STEP(name, fn, prio, zone)  { (name), NULL, (fn), (prio), (zone), 0u, 0u, 0u, { 0 } }
+
+#define PT_BEGIN(t)   switch ((t)->pt) { case 0:
+#define PT_YIELD(t)   do { (t)->pt = (uint16_t)__LINE__; return SCHED_YIELD; case __LINE__:; } while (0)
+#define PT_EXIT(t)    do { (t)->pt = 0u; return SCHED_DONE; } while (0)
+#define PT_END(t)     } (t)->pt = 0u; return SCHED_DONE
+
+// Таблица живёт всё время работы; упорядочивается по уровням (в уровне —
+// как в таблице). Лишние задачи сверх SCHED_MAX_TASKS отбрасываются
+void Sched_Init(Sched_Task_t *tasks, uint8_t count);
+
+// Один проход, из while(1)
+void Sched_Run(void);
+
+uint8_t Sched_Count(void);
+const Sched_Task_t *Sched_GetTask(uint8_t idx);
+void Sched_ResetStats(void);
+
+// Отчёт в USB-лог: Sched_DumpStart запускает, Sched_DumpTask (задача уровня
+// лога) выводит по строке за проход
+void Sched_DumpStart(void);
+void Sched_DumpTask(void);
+
+#endif // SCHED_H
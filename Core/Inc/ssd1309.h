@@ -6,9 +6,24 @@
  *    для исходного буфера (tx). Драйвер делает Clean автоматически.
  * 2) Память буфера должна быть ДОСТУПНА DMA. Не размещайте framebuffer в DTCM.
  *
+ * Режимы обновления (SSD1309_Config_t::refresh):
+ * - WINDOW: горизонтальная адресация, окно страниц first..last, столбцы
+ *   col_offset..col_offset+127. Изменённый участок уходит одной DMA-передачей
+ *   данных; если окно не менялось, команд нет вовсе — одно прерывание на кадр.
+ * - PAGED: цепочка команда/данные на каждую страницу — для контроллеров без
+ *   горизонтальной адресации (SH1106).
+ *
+ * Несколько панелей на одном SPI (SSD1309_Bus_t):
+ * - у каждой панели свой CS и framebuffer, DC/SCK/SDA (и RST) общие;
+ * - цепочка DMA (init или кадр) владеет шиной целиком, по её концу шина свободна;
+ * - SSD1309_Bus_Task() обходит панели по кругу начиная со следующей за последним
+ *   владельцем, поэтому постоянно меняющаяся панель не задерживает остальные;
+ * - панели без RST (rst_port = NULL) сбрасываются вместе с той, что им управляет.
+ *
  * Callback политика:
  * - Драйвер НЕ переопределяет HAL_*Callback.
- * - Вы маршрутизируете callbacks и вызываете SSD1309_OnSpiTxCplt / SSD1309_OnSpiError.
+ * - Вы маршрутизируете callbacks и вызываете SSD1309_OnSpiTxCplt / SSD1309_OnSpiError
+ *   (или SSD1309_Bus_OnSpiTxCplt / SSD1309_Bus_OnSpiError для общей шины).
  */
 
 #ifndef SSD1309_DRIVER_H
@@ -31,26 +46,79 @@ typedef enum {
     SSD1309_COLOR_WHITE = 1
 } SSD1309_Color_t;
 
+/* Крупные цифры из font_digits.h */
+typedef enum {
+    SSD1309_FONT_16X24 = 0,
+    SSD1309_FONT_16X32 = 1
+} SSD1309_BigFont_t;
+
+typedef enum {
+    SSD1309_REFRESH_WINDOW = 0,
+    SSD1309_REFRESH_PAGED  = 1
+} SSD1309_Refresh_t;
+
+#define SSD1309_NUM_MAX_SLOTS 12u
+
+/*
+ * Числовое поле с фиксированной точкой (сантилитры, деньги).
+ * Хранит то, что уже нарисовано, и перерисовывает только изменившиеся знакоместа.
+ * После SSD1309_Clear() поле нужно сбросить через SSD1309_NumField_Invalidate().
+ */
+typedef struct {
+    uint16_t x;          /* левый край поля */
+    uint8_t  page;       /* верхняя страница, y = page * 8 */
+    uint8_t  font;       /* SSD1309_BigFont_t */
+    uint8_t  int_digits; /* знакомест в целой части (ведущие нули -> пробелы) */
+    uint8_t  decimals;   /* знаков после точки, 0 = без точки */
+    uint8_t  valid;      /* 0 -> следующий DrawNumber рисует всё поле */
+    char     shown[SSD1309_NUM_MAX_SLOTS];
+} SSD1309_NumField_t;
+
 typedef struct {
     SPI_HandleTypeDef *hspi;
 
     GPIO_TypeDef *cs_port;  uint16_t cs_pin;
     GPIO_TypeDef *dc_port;  uint16_t dc_pin;
-    GPIO_TypeDef *rst_port; uint16_t rst_pin;
+    GPIO_TypeDef *rst_port; uint16_t rst_pin;   /* rst_port = NULL: RST общий, не трогаем */
 
     uint8_t col_offset; /* часто 0 или 2 для модулей 132->128 */
     uint8_t invert;     /* 0 normal, 1 invert */
+    uint8_t contrast;   /* 0x81; 0 — по умолчанию 0x7F */
+    uint8_t refresh;    /* SSD1309_Refresh_t, по умолчанию WINDOW */
 } SSD1309_Config_t;
 
+/* Счётчики конвейера вывода. Время — такты DWT->CYCCNT (dwt_cycles.h) */
 typedef struct {
+    uint32_t updates;          /* вызовов SSD1309_UpdateAsync */
+    uint32_t update_busy;      /* ... пока предыдущий кадр ещё передавался */
+    uint32_t coalesced;        /* ... и изменения слились со следующим кадром */
+    uint32_t frames;           /* кадров, переданных полностью */
+    uint32_t dropped;          /* кадров, оборванных сбоем (страницы ушли повторно) */
+    uint32_t spi_errors;       /* вызовов SSD1309_OnSpiError */
+    uint32_t bytes;            /* байт по SPI: init + команды + данные */
+    uint32_t xfer_cycles_last; /* длительность передачи кадра, от старта до последнего TxCplt */
+    uint32_t xfer_cycles_max;
+    uint32_t t_start;
+} SSD1309_Stats_t;
+
+struct SSD1309_Bus_s;
+
+typedef struct SSD1309_s {
     SSD1309_Config_t cfg;
+    struct SSD1309_Bus_s *bus; /* NULL -> SPI принадлежит панели единолично */
+    uint8_t bus_slot;
 
     /* framebuffer aligned(32) чтобы корректно чистить DCache по линиям */
     uint8_t fb[SSD1309_FB_SIZE] __attribute__((aligned(32)));
 
     volatile uint8_t ready;
     volatile uint8_t busy;
-    volatile uint8_t dirty;
+    volatile uint8_t dirty;     /* маска изменённых страниц: бит N = страница N */
+
+    uint8_t hold;               /* кадр рисуется по частям: SSD1309_Task его не начинает */
+    uint8_t panel_pending;      /* контраст/инверсия из SSD1309_SetPanel ещё не отправлены */
+    uint8_t tx_pages;           /* страницы текущей передачи (снимок dirty) */
+    volatile uint8_t resend;    /* страницы, возвращённые из ISR после сбоя */
 
     uint32_t t0_ms;
     uint8_t init_step;
@@ -60,14 +128,36 @@ typedef struct {
 
     uint8_t page;
 
+    uint8_t window;             /* 1 = режим WINDOW активен */
+    uint8_t win_first;          /* окно страниц, запрограммированное в контроллере */
+    uint8_t win_last;
+    uint8_t win_valid;          /* 0 -> указатель адреса не известен, нужна команда окна */
+
     uint8_t init_seq[32] __attribute__((aligned(32)));
     uint8_t tx_cmd[8]    __attribute__((aligned(32)));
     uint8_t tx_len;
     uint8_t phase;
+
+    SSD1309_Stats_t stats;
 } SSD1309_t;
 
+#define SSD1309_BUS_MAX_PANELS 4u
+
+/* Общий SPI + DMA stream для нескольких панелей */
+typedef struct SSD1309_Bus_s {
+    SPI_HandleTypeDef *hspi;
+    SSD1309_t *panels[SSD1309_BUS_MAX_PANELS];
+    uint8_t count;
+    uint8_t rr;                   /* с какой панели начинать следующий обход */
+    SSD1309_t *volatile owner;    /* захват — только main loop, освобождение — и ISR */
+} SSD1309_Bus_t;
+
 void SSD1309_Init(SSD1309_t *d, const SSD1309_Config_t *cfg);
 void SSD1309_BeginAsync(SSD1309_t *d);
+/* Контраст и инверсия после BeginAsync (настройки из EEPROM). Работающей
+   панели SSD1309_Task отправит 0x81 <contrast> и 0xA6/0xA7 между кадрами —
+   без reset и повторной инициализации; можно звать в любой момент */
+void SSD1309_SetPanel(SSD1309_t *d, uint8_t contrast, uint8_t invert);
 
 /* Вызывать регулярно (например, в while(1)) */
 void SSD1309_Task(SSD1309_t *d);
@@ -77,17 +167,49 @@ void SSD1309_Clear(SSD1309_t *d);
 void SSD1309_DrawPixel(SSD1309_t *d, uint16_t x, uint16_t y, SSD1309_Color_t c);
 void SSD1309_DrawChar8x8(SSD1309_t *d, uint16_t x, uint16_t y, char ch, SSD1309_Color_t c);
 void SSD1309_DrawString8x8(SSD1309_t *d, uint16_t x, uint16_t y, const char *s, SSD1309_Color_t c);
+void SSD1309_ClearPages(SSD1309_t *d, uint8_t first, uint8_t count);
+void SSD1309_FillRect(SSD1309_t *d, uint16_t x, uint16_t y, uint16_t w, uint16_t h, SSD1309_Color_t c);
+
+/* Крупные цифры: вывод тайлами по страницам, возвращает ширину символа.
+   Символ или размер, не вошедший в сборку (font_digits.h), рисуется рамкой */
+uint16_t SSD1309_DrawBigChar(SSD1309_t *d, uint16_t x, uint8_t page, char ch, SSD1309_BigFont_t font);
 
-/* Асинхронное обновление дисплея */
+/* value = 12345, int_digits = 3, decimals = 2 -> "123.45"; без sprintf, с насыщением.
+   Возвращает длину строки или 0, если не влезает в out_sz. */
+uint8_t SSD1309_FormatFixed(char *out, uint8_t out_sz, uint32_t value, uint8_t int_digits, uint8_t decimals);
+void SSD1309_DrawNumber(SSD1309_t *d, SSD1309_NumField_t *f, uint32_t value);
+static inline void SSD1309_NumField_Invalidate(SSD1309_NumField_t *f) { f->valid = 0u; }
+
+/* Асинхронное обновление дисплея: отправляются только страницы из dirty */
 void SSD1309_UpdateAsync(SSD1309_t *d);
 
+/* Кадр рисуется в несколько шагов main loop: до SSD1309_UpdateAsync
+   SSD1309_Task не отправляет изменённые страницы (полкадра на экране) */
+static inline void SSD1309_Hold(SSD1309_t *d) { d->hold = 1u; }
+
 static inline bool SSD1309_IsReady(const SSD1309_t *d) { return d->ready != 0u; }
 static inline bool SSD1309_IsBusy(const SSD1309_t *d)  { return d->busy  != 0u; }
+/* Проинициализирована и настройки SSD1309_SetPanel уже в контроллере */
+static inline bool SSD1309_IsSettled(const SSD1309_t *d) { return d->ready != 0u && d->panel_pending == 0u; }
+
+/* Счётчики читаются без блокировки: отдельные поля могут отличаться на один кадр */
+static inline const SSD1309_Stats_t *SSD1309_GetStats(const SSD1309_t *d) { return &d->stats; }
+void SSD1309_ResetStats(SSD1309_t *d);
 
 /* Маршрутизация из ваших HAL callbacks */
 void SSD1309_OnSpiTxCplt(SSD1309_t *d, SPI_HandleTypeDef *hspi);
 void SSD1309_OnSpiError(SSD1309_t *d, SPI_HandleTypeDef *hspi);
 
+/* Общая шина: Attach после SSD1309_Init() панели */
+void SSD1309_Bus_Init(SSD1309_Bus_t *b, SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef SSD1309_Bus_Attach(SSD1309_Bus_t *b, SSD1309_t *d);
+
+/* Вместо SSD1309_Task() для каждой панели шины */
+void SSD1309_Bus_Task(SSD1309_Bus_t *b);
+
+void SSD1309_Bus_OnSpiTxCplt(SSD1309_Bus_t *b, SPI_HandleTypeDef *hspi);
+void SSD1309_Bus_OnSpiError(SSD1309_Bus_t *b, SPI_HandleTypeDef *hspi);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,6 +2,9 @@
 #define UI_MANAGER_H
 
 #include "main.h"
+#include "ssd1309.h"
+#include "ui_widgets.h"
+#include "sched.h"
 
 typedef enum {
     UI_STATE_MAIN,
@@ -17,5 +20,26 @@ typedef enum {
 void UI_Init(void);
 void UI_ProcessInput(void);  // Process keyboard input (call every loop)
 void UI_Draw(void);          // Draw screen (call only when display ready)
+uint8_t UI_DrawTask(Sched_Task_t *t);  // то же по шагам, задача отрисовки sched.h
+
+// Экран оператора для состояния (NULL - нет такого); для замеров отрисовки
+const UI_Screen_t* UI_GetScreen(UI_State_t state);
+
+// Счётчики отрисовки; время — такты DWT->CYCCNT
+typedef struct {
+    uint32_t renders;            // проходов UI_Draw через 33 мс гейт
+    uint32_t widgets;            // перерисовано виджетов всего
+    uint32_t render_cycles_last; // рендер во framebuffer, без передачи по SPI
+    uint32_t render_cycles_max;
+} UI_Stats_t;
+
+const UI_Stats_t* UI_GetStats(void);
+void UI_ResetStats(void);
+
+// Отладочная строка "передача/рендер, мкс" в правом нижнем углу операторского экрана
+void UI_SetDebugOverlay(uint8_t on);
+
+// Клиентская панель ведомого: показывает его налив параллельно с экраном оператора
+void UI_AttachUnitPanel(uint8_t unit, SSD1309_t *disp);
 
 #endif // UI_MANAGER_H
@@ -0,0 +1,107 @@
+/*
+ * Retained-виджеты для OLED (SSD1309).
+ *
+ * Экран — это const-массив дескрипторов UI_Widget_t во flash. Каждый виджет
+ * привязан к источнику данных (getter) и хранит в UI_View_t последнее
+ * отрисованное значение. UI_View_Refresh() перерисовывает только виджеты,
+ * у которых изменилось значение, и только их прямоугольник, поэтому
+ * в драйвер уходят лишь затронутые страницы.
+ */
+#ifndef UI_WIDGETS_H
+#define UI_WIDGETS_H
+
+#include "ssd1309.h"
+#include <stdint.h>
+
+#define UI_MAX_WIDGETS   24u
+#define UI_TEXT_MAX      16u   /* 128 / 8 символов */
+
+/* arg виджета: взять индекс ведомого из UI_View_t::unit */
+#define UI_ARG_VIEW      0xFFu
+
+/* font для UI_W_NUMBER: 8x8 или SSD1309_BigFont_t */
+#define UI_FONT_8X8      0xFFu
+
+typedef enum {
+    UI_W_LABEL = 0,   /* статичный текст text */
+    UI_W_TEXT,        /* текст из get_text(arg), перерисовка при изменении строки */
+    UI_W_NUMBER,      /* число get(arg) с фиксированной точкой */
+    UI_W_ICON,        /* символ text[get(arg)] */
+    UI_W_BAR,         /* прогресс get(arg) = 0..100 % в рамке */
+    UI_W_HLINE        /* горизонтальная линия шириной w */
+} UI_WidgetType_t;
+
+typedef uint32_t    (*UI_Getter_t)(uint8_t arg);
+typedef const char *(*UI_TextGetter_t)(uint8_t arg);
+
+typedef struct {
+    uint8_t type;        /* UI_WidgetType_t */
+    uint8_t x, y;        /* левый верхний угол, px */
+    uint8_t w, h;        /* прямоугольник, который виджет стирает при перерисовке */
+    uint8_t arg;         /* аргумент getter'а или UI_ARG_VIEW */
+    uint8_t font;        /* NUMBER: UI_FONT_8X8 или SSD1309_BigFont_t (y кратно 8) */
+    uint8_t int_digits;  /* NUMBER: знакомест в целой части */
+    uint8_t decimals;    /* NUMBER: знаков после точки */
+    const char *text;    /* LABEL: строка; ICON: символы по значению */
+    UI_Getter_t get;
+    UI_TextGetter_t get_text;
+} UI_Widget_t;
+
+typedef struct {
+    const UI_Widget_t *widgets;
+    uint8_t count;
+} UI_Screen_t;
+
+#define UI_SCREEN(arr) { (arr), (uint8_t)(sizeof(arr) / sizeof((arr)[0])) }
+
+/* Сокращения для описания экранов */
+#define UI_LABEL(x_, y_, s_) \
+    { .type = UI_W_LABEL, .x = (x_), .y = (y_), .text = (s_) }
+#define UI_HLINE(y_) \
+    { .type = UI_W_HLINE, .x = 0, .y = (y_), .w = SSD1309_WIDTH, .h = 1 }
+#define UI_TEXT(x_, y_, w_, fn_, arg_) \
+    { .type = UI_W_TEXT, .x = (x_), .y = (y_), .w = (w_), .h = 8, .arg = (arg_), .get_text = (fn_) }
+#define UI_NUM8(x_, y_, dig_, dec_, fn_, arg_) \
+    { .type = UI_W_NUMBER, .x = (x_), .y = (y_), .w = 8u * ((dig_) + ((dec_) ? (dec_) + 1u : 0u)), .h = 8, \
+      .arg = (arg_), .font = UI_FONT_8X8, .int_digits = (dig_), .decimals = (dec_), .get = (fn_) }
+#define UI_BIGNUM(x_, page_, font_, dig_, dec_, fn_, arg_) \
+    { .type = UI_W_NUMBER, .x = (x_), .y = (page_) * 8u, .arg = (arg_), .font = (font_), \
+      .int_digits = (dig_), .decimals = (dec_), .get = (fn_) }
+#define UI_ICON(x_, y_, chars_, fn_, arg_) \
+    { .type = UI_W_ICON, .x = (x_), .y = (y_), .w = 8, .h = 8, .arg = (arg_), .text = (chars_), .get = (fn_) }
+#define UI_BAR(x_, y_, w_, h_, fn_, arg_) \
+    { .type = UI_W_BAR, .x = (x_), .y = (y_), .w = (w_), .h = (h_), .arg = (arg_), .get = (fn_) }
+
+/* Последнее отрисованное состояние виджета */
+typedef struct {
+    uint8_t valid;
+    uint32_t value;
+    union {
+        char text[UI_TEXT_MAX + 1u];   /* UI_W_TEXT */
+        SSD1309_NumField_t num;        /* UI_W_NUMBER крупным шрифтом */
+    } u;
+} UI_WidgetState_t;
+
+/* Экран, показанный на конкретном дисплее */
+typedef struct {
+    SSD1309_t *disp;
+    const UI_Screen_t *screen;
+    uint8_t unit;        /* подставляется вместо UI_ARG_VIEW */
+    UI_WidgetState_t state[UI_MAX_WIDGETS];
+} UI_View_t;
+
+void UI_View_Init(UI_View_t *v, SSD1309_t *disp);
+
+/* Смена экрана: очистка framebuffer и полная отрисовка */
+void UI_View_Show(UI_View_t *v, const UI_Screen_t *scr);
+
+/* Перерисовка изменившихся виджетов; возвращает их число */
+uint8_t UI_View_Refresh(UI_View_t *v);
+
+/* То же по частям (отрисовка с уступками): UI_View_Begin только очищает
+   framebuffer, виджеты рисует UI_View_RefreshWidget по одному */
+void UI_View_Begin(UI_View_t *v, const UI_Screen_t *scr);
+uint8_t UI_View_Count(const UI_View_t *v);
+uint8_t UI_View_RefreshWidget(UI_View_t *v, uint8_t i);   /* 1 — перерисован */
+
+#endif // UI_WIDGETS_H
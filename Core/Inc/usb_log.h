@@ -0,0 +1,60 @@
+/*
+ * USB CDC лог: кольцо с несколькими писателями (main loop и ISR) без
+ * запрета прерываний.
+ *
+ * Писатель резервирует место под сообщение целиком (LDREX/STREX на слове
+ * состояния), копирует данные и фиксирует запись. Читателю (USB ISR)
+ * становится видна граница, до которой все зарезервированные сообщения
+ * уже записаны, — рваных сообщений в потоке не бывает. Передача идёт
+ * прямо из кольца, цепочкой из CDC_TransmitCplt_FS.
+ *
+ * Переполнение: USBLOG_DROP_NEWEST отбрасывает новое сообщение,
+ * USBLOG_DROP_OLDEST вытесняет старейшие ещё не переданные сообщения
+ * (если старейшее уже отдано в USB — всё же отбрасывается новое).
+ * Потери отмечаются в самом потоке строкой "[LOG] dropped ...".
+ */
+#ifndef USB_LOG_H
+#define USB_LOG_H
+
+#include <stdint.h>
+
+#define USBLOG_RING_SZ   2048u   /* степень двойки, не больше 32768 */
+#define USBLOG_TX_MAX    1024u   /* одна передача CDC */
+#define USBLOG_MSG_SLOTS 64u     /* сообщений в кольце одновременно, степень двойки */
+
+typedef enum {
+    USBLOG_DROP_NEWEST = 0,
+    USBLOG_DROP_OLDEST
+} UsbLog_Policy_t;
+
+#ifndef USBLOG_POLICY
+#define USBLOG_POLICY USBLOG_DROP_OLDEST
+#endif
+
+typedef struct {
+    uint32_t tx_bytes;
+    uint32_t xfers;
+    uint32_t dropped_msgs;       /* новые сообщения, не поместившиеся в кольцо */
+    uint32_t dropped_bytes;
+    uint32_t overwritten_msgs;   /* старые сообщения, вытесненные новыми */
+    uint32_t overwritten_bytes;
+} UsbLog_Stats_t;
+
+/* Любой контекст. Сообщение попадает в поток целиком или не попадает вовсе */
+void UsbLog_Write(const uint8_t *data, uint16_t len);
+void UsbLog_Printf(const char *fmt, ...);
+
+/* main loop: запуск остановившейся цепочки передач, отчёт о потерях */
+void UsbLog_Task(void);
+
+/* Из CDC_TransmitCplt_FS */
+void UsbLog_OnTxCplt(void);
+
+/* Сколько байт поместится без вытеснения (0 — кончились слоты сообщений).
+   Для длинных отчётов, которые выводятся порциями */
+uint16_t UsbLog_Free(void);
+
+void UsbLog_SetPolicy(UsbLog_Policy_t policy);
+void UsbLog_GetStats(UsbLog_Stats_t *out);
+
+#endif // USB_LOG_H
@@ -0,0 +1,237 @@
+#include "app_tasks.h"
+#include "main.h"
+#include "spi.h"
+#include "ui_manager.h"
+#include "dispenser.h"
+#include "eeprom_at24.h"
+#include "config_store.h"
+#include "dwt_cycles.h"
+#include "usb_log.h"
+#include "prof.h"
+#include "bench.h"
+#include "boot.h"
+#include "sched.h"
+#include <stdint.h>
+
+/* Клиентские панели ведомых на том же SPI2: включаются, когда в CubeMX
+   назначены пины OLED_U1_CS / OLED_U2_CS (RST общий с операторской панелью) */
+#if defined(OLED_U1_CS_Pin) && defined(OLED_U2_CS_Pin)
+#define OLED_UNIT_PANELS 1
+#else
+#define OLED_UNIT_PANELS 0
+#endif
+
+/* OLED */
+SSD1309_t oled;
+SSD1309_Bus_t oled_bus;
+#if OLED_UNIT_PANELS
+static SSD1309_t oled_unit[2];
+#endif
+
+#if APP_USB_CMD
+
+/* ====== USB CDC commands ====== */
+
+/* Команда из USB CDC (один символ), обрабатывается в main loop */
+static volatile uint8_t usb_cmd = 0;
+
+/* Приём CDC (контекст USB ISR): печатать отсюда нельзя, только запомнить команду */
+void AppTasks_OnUsbRx(const uint8_t *buf, uint32_t len)
+{
+    if (len > 0u) usb_cmd = buf[len - 1u];
+}
+
+static void DisplayStats_Dump(void)
+{
+    for (uint8_t i = 0; i < oled_bus.count; i++) {
+        const SSD1309_Stats_t *st = SSD1309_GetStats(oled_bus.panels[i]);
+        UsbLog_Printf("OLED%u: frames=%lu upd=%lu busy=%lu coal=%lu drop=%lu err=%lu bytes=%lu xfer=%luus max=%luus\r\n",
+                      i,
+                      (unsigned long)st->frames, (unsigned long)st->updates,
+                      (unsigned long)st->update_busy, (unsigned long)st->coalesced,
+                      (unsigned long)st->dropped, (unsigned long)st->spi_errors,
+                      (unsigned long)st->bytes,
+                      (unsigned long)DWT_CyclesToUs(st->xfer_cycles_last),
+                      (unsigned long)DWT_CyclesToUs(st->xfer_cycles_max));
+    }
+
+    const UI_Stats_t *ui = UI_GetStats();
+    UsbLog_Printf("UI: renders=%lu widgets=%lu render=%luus max=%luus\r\n",
+                  (unsigned long)ui->renders, (unsigned long)ui->widgets,
+                  (unsigned long)DWT_CyclesToUs(ui->render_cycles_last),
+                  (unsigned long)DWT_CyclesToUs(ui->render_cycles_max));
+
+    UsbLog_Stats_t log;
+    UsbLog_GetStats(&log);
+    UsbLog_Printf("USB log: tx=%lu xfers=%lu drop=%lu/%luB over=%lu/%luB\r\n",
+                  (unsigned long)log.tx_bytes, (unsigned long)log.xfers,
+                  (unsigned long)log.dropped_msgs, (unsigned long)log.dropped_bytes,
+                  (unsigned long)log.overwritten_msgs, (unsigned long)log.overwritten_bytes);
+}
+
+/* Включение/выключение обоих кэшей на ходу. SCB_DisableDCache сначала
+   выписывает грязные линии, DMA-буферы кэш не затрагивает (mem_layout.h) */
+static void Cache_Toggle(void)
+{
+    if (SCB->CCR & SCB_CCR_DC_Msk) {
+        SCB_DisableDCache();
+        SCB_DisableICache();
+    } else {
+        SCB_EnableICache();
+        SCB_EnableDCache();
+    }
+    Prof_Reset();
+    UsbLog_Printf("Caches %s\r\n", (SCB->CCR & SCB_CCR_DC_Msk) ? "on" : "off");
+}
+
+/* D - счётчики дисплея, R - сброс счётчиков, O/o - отладочная строка вкл/выкл,
+   C - кэши вкл/выкл, P - отчёт профилировщика (prof.h),
+   T - задачи main loop: доля CPU и задержки (sched.h),
+   B - микробенчмарки JSON (bench.h, при BENCH_ENABLED) */
+static void UsbCmd_Task(void)
+{
+    uint8_t cmd = usb_cmd;
+    if (cmd == 0u) return;
+    usb_cmd = 0u;
+
+    switch (cmd) {
+    case 'D':
+        DisplayStats_Dump();
+        break;
+    case 'R':
+        for (uint8_t i = 0; i < oled_bus.count; i++) SSD1309_ResetStats(oled_bus.panels[i]);
+        UI_ResetStats();
+        Prof_Reset();
+        Sched_ResetStats();
+        UsbLog_Printf("Stats reset\r\n");
+        break;
+    case 'O':
+        UI_SetDebugOverlay(1);
+        break;
+    case 'o':
+        UI_SetDebugOverlay(0);
+        break;
+    case 'C':
+        Cache_Toggle();
+        break;
+    case 'P':
+        Prof_DumpStart();
+        break;
+    case 'T':
+        Sched_DumpStart();
+        break;
+    case 'B':
+        Bench_Start();
+        break;
+    default:
+        break;
+    }
+}
+
+#else
+
+/* Команды выключены: принятое из CDC отбрасывается */
+void AppTasks_OnUsbRx(const uint8_t *buf, uint32_t len)
+{
+    (void)buf;
+    (void)len;
+}
+
+#endif // APP_USB_CMD
+
+/* ====== Задачи main loop (sched.h) ====== */
+
+static void Task_OledBus(void)
+{
+    /* OLED driver task: все панели SPI2 по кругу */
+    SSD1309_Bus_Task(&oled_bus);
+}
+
+/* Ввод и отрисовка — после загрузки настроек (Boot_Task вызывает UI_Init) */
+static void Task_UiInput(void)
+{
+    if (Boot_Reached(BOOT_PHASE_UI)) UI_ProcessInput();
+}
+
+static uint8_t Task_UiDraw(Sched_Task_t *t)
+{
+    /* Начатая отрисовка доводится до конца, новая — только на готовом дисплее */
+    if (t->pt == 0u && (!Boot_Reached(BOOT_PHASE_UI) || !SSD1309_IsReady(&oled))) return SCHED_DONE;
+    return UI_DrawTask(t);
+}
+
+/* Опрос ТРК (протокол) идёт и между шагами всех остальных задач */
+static Sched_Task_t tasks[] = {
+    SCHED_CALL("dispenser", Dispenser_Update, SCHED_PRIO_PROTOCOL, PROF_DISPENSER),
+    SCHED_CALL("eeprom",    EEPROM_Task,      SCHED_PRIO_INPUT,    PROF_EEPROM_TASK),
+    SCHED_CALL("boot",      Boot_Task,        SCHED_PRIO_INPUT,    SCHED_NO_ZONE),
+    SCHED_CALL("ui_input",  Task_UiInput,     SCHED_PRIO_INPUT,    PROF_UI_INPUT),
+    SCHED_CALL("usb_log",   UsbLog_Task,      SCHED_PRIO_LOGGING,  PROF_USBLOG_TASK),
+#if APP_USB_CMD
+    SCHED_CALL("usb_cmd",   UsbCmd_Task,      SCHED_PRIO_LOGGING,  SCHED_NO_ZONE),
+#endif
+    SCHED_CALL("prof",      Prof_Task,        SCHED_PRIO_LOGGING,  SCHED_NO_ZONE),
+    SCHED_CALL("sched",     Sched_DumpTask,   SCHED_PRIO_LOGGING,  SCHED_NO_ZONE),
+    SCHED_CALL("bench",     Bench_Task,       SCHED_PRIO_LOGGING,  SCHED_NO_ZONE),
+    SCHED_STEP("ui_draw",   Task_UiDraw,      SCHED_PRIO_RENDER,   PROF_UI_DRAW),
+    SCHED_CALL("oled_bus",  Task_OledBus,     SCHED_PRIO_RENDER,   PROF_OLED_TASK),
+};
+
+void AppTasks_Init(void)
+{
+    /* Загрузка по стадиям (boot.c): опрос ведомых сразу, на умолчаниях;
+       EEPROM, дисплей и USB поднимаются параллельно из main loop */
+    Boot_Start();
+
+    /* OLED init: reset идёт, пока грузятся настройки; контраст и инверсия
+       из EEPROM — через Boot_Task */
+    SSD1309_Config_t cfg = {
+        .hspi = &hspi2,
+        .cs_port  = SPI2_CS_GPIO_Port,  .cs_pin  = SPI2_CS_Pin,
+        .dc_port  = SPI2_DC_GPIO_Port,  .dc_pin  = SPI2_DC_Pin,
+        .rst_port = SPI2_RST_GPIO_Port, .rst_pin = SPI2_RST_Pin,
+        .col_offset = 2u,
+        .refresh = SSD1309_REFRESH_WINDOW,
+        .invert = Config_Get()->invert,
+        .contrast = Config_Get()->contrast
+    };
+
+    SSD1309_Bus_Init(&oled_bus, &hspi2);
+
+    SSD1309_Init(&oled, &cfg);
+    SSD1309_Bus_Attach(&oled_bus, &oled);
+    SSD1309_BeginAsync(&oled);
+    Boot_AttachDisplay(&oled);
+
+#if OLED_UNIT_PANELS
+    {
+        GPIO_TypeDef *const cs_port[2] = { OLED_U1_CS_GPIO_Port, OLED_U2_CS_GPIO_Port };
+        const uint16_t cs_pin[2] = { OLED_U1_CS_Pin, OLED_U2_CS_Pin };
+
+        for (uint8_t u = 0; u < 2u; u++) {
+            SSD1309_Config_t ucfg = cfg;
+            ucfg.cs_port = cs_port[u];
+            ucfg.cs_pin = cs_pin[u];
+            ucfg.rst_port = NULL;
+            SSD1309_Init(&oled_unit[u], &ucfg);
+            SSD1309_Bus_Attach(&oled_bus, &oled_unit[u]);
+            SSD1309_BeginAsync(&oled_unit[u]);
+            Boot_AttachDisplay(&oled_unit[u]);
+            UI_AttachUnitPanel(u, &oled_unit[u]);
+        }
+    }
+#endif
+
+    /* Без ожидания USB: до перечисления лог копится в кольце usb_log */
+    UsbLog_Printf("=== System Started ===\r\n");
+
+    Sched_Init(tasks, (uint8_t)(sizeof(tasks) / sizeof(tasks[0])));
+}
+
+void AppTasks_Run(void)
+{
+    Prof_LoopTick();
+
+    /* Все задачи по уровням приоритета: протокол, ввод, лог, отрисовка */
+    Sched_Run();
+}
@@ -0,0 +1,303 @@
+#include "bench.h"
+
+#if BENCH_ENABLED
+
+#include "main.h"
+#include "gaskitlink.h"
+#include "ssd1309.h"
+#include "ui_manager.h"
+#include "ui_widgets.h"
+#include "usb_log.h"
+#include "dispenser.h"
+#include "dwt_cycles.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    uint32_t iters;
+    void (*setup)(void);
+    void (*run)(uint32_t n, uint32_t arg);
+    uint32_t arg;
+} Bench_Case_t;
+
+/* Замеры рисуют в свой framebuffer: экран оператора и его DMA не трогаем */
+static SSD1309_t bench_disp;
+static UI_View_t bench_view;
+
+static volatile uint32_t sink;
+static uint8_t frame[32];
+static uint16_t frame_len;
+static GasFrame_t status_frames[4];
+
+/* ====== Случаи ====== */
+
+static void Setup_TFrame(void)
+{
+    frame_len = Gas_BuildFrame(frame, 0x00, 0x01, 'T', "1q8;005500;000500;1100");
+}
+
+static void Run_GasBuild(uint32_t n, uint32_t arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < n; i++) {
+        sink += Gas_BuildFrame(frame, 0x00, 0x01, 'V', "1;000500;1100");
+    }
+}
+
+static void Run_GasParse(uint32_t n, uint32_t arg)
+{
+    GasFrame_t f;
+    (void)arg;
+    for (uint32_t i = 0; i < n; i++) {
+        sink += (uint32_t)Gas_ParseFrame(frame, frame_len, &f) + f.data_len;
+    }
+}
+
+static void Run_GasCrc(uint32_t n, uint32_t arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < n; i++) {
+        sink += Gas_CalculateCRC(&frame[1], (uint16_t)(frame_len - 2u));
+    }
+}
+
+/* Строка, как у SendFrame при каждой команде с данными */
+static void Run_UsbLogPrintf(uint32_t n, uint32_t arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < n; i++) {
+        UsbLog_Printf("UNIT%d TX: %c%s\r\n", 1, 'V', "1;000500;1100");
+    }
+}
+
+static void Run_DrawString(uint32_t n, uint32_t arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < n; i++) {
+        SSD1309_DrawString8x8(&bench_disp, 0, (uint16_t)((i & 7u) * 8u), "PRICE 1100.00 L", SSD1309_COLOR_WHITE);
+    }
+}
+
+static void Run_Clear(uint32_t n, uint32_t arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < n; i++) {
+        SSD1309_Clear(&bench_disp);
+    }
+}
+
+static void Setup_View(void)
+{
+    UI_View_Init(&bench_view, &bench_disp);
+}
+
+/* Полная отрисовка экрана — то, что UI_Draw делает при смене состояния */
+static void Run_UiShow(uint32_t n, uint32_t arg)
+{
+    const UI_Screen_t *scr = UI_GetScreen((UI_State_t)arg);
+    for (uint32_t i = 0; i < n; i++) {
+        UI_View_Show(&bench_view, scr);
+    }
+}
+
+/* Обычный проход UI_Draw на экране налива: значения не менялись */
+static void Run_UiRefresh(uint32_t n, uint32_t arg)
+{
+    UI_View_Show(&bench_view, UI_GetScreen((UI_State_t)arg));
+    for (uint32_t i = 0; i < n; i++) {
+        sink += UI_View_Refresh(&bench_view);
+    }
+}
+
+static void Setup_Status(void)
+{
+    static const char *const st[4] = { "10", "31", "61", "81" };
+    uint8_t buf[16];
+
+    for (uint8_t i = 0; i < 4u; i++) {
+        uint16_t len = Gas_BuildFrame(buf, 0x00, 0x02, 'S', st[i]);
+        Gas_ParseFrame(buf, len, &status_frames[i]);
+    }
+}
+
+/* Ответы S по кругу: ветви статусов вместе с их BLOG */
+static void Run_StatusResponse(uint32_t n, uint32_t arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < n; i++) {
+        sink += Dispenser_ProcessStatus(1, &status_frames[i & 3u]);
+    }
+}
+
+static const Bench_Case_t cases[] = {
+    { "gas_build_frame",        20000u, NULL,         Run_GasBuild,       0u },
+    { "gas_parse_frame",        20000u, Setup_TFrame, Run_GasParse,       0u },
+    { "gas_crc",                20000u, Setup_TFrame, Run_GasCrc,         0u },
+    { "usb_log_printf",          2000u, NULL,         Run_UsbLogPrintf,   0u },
+    { "oled_draw_string",        5000u, NULL,         Run_DrawString,     0u },
+    { "oled_clear",             10000u, NULL,         Run_Clear,          0u },
+    { "ui_main",                  400u, Setup_View,   Run_UiShow,         UI_STATE_MAIN },
+    { "ui_totalizer",             400u, Setup_View,   Run_UiShow,         UI_STATE_TOTALIZER },
+    { "ui_set_price",             400u, Setup_View,   Run_UiShow,         UI_STATE_SET_PRICE },
+    { "ui_input_volume",          400u, Setup_View,   Run_UiShow,         UI_STATE_INPUT_VOLUME },
+    { "ui_input_amount",          400u, Setup_View,   Run_UiShow,         UI_STATE_INPUT_AMOUNT },
+    { "ui_fuelling",              400u, Setup_View,   Run_UiShow,         UI_STATE_FUELLING },
+    { "ui_transaction_result",    400u, Setup_View,   Run_UiShow,         UI_STATE_TRANSACTION_RESULT },
+    { "ui_error_message",         400u, Setup_View,   Run_UiShow,         UI_STATE_ERROR_MESSAGE },
+    { "ui_refresh_fuelling",     4000u, Setup_View,   Run_UiRefresh,      UI_STATE_FUELLING },
+    { "process_status_response", 4000u, Setup_Status, Run_StatusResponse, 0u },
+};
+
+#define BENCH_CASES ((uint8_t)(sizeof(cases) / sizeof(cases[0])))
+
+uint8_t Bench_Count(void)
+{
+    return BENCH_CASES;
+}
+
+const char *Bench_Name(uint8_t idx)
+{
+    return (idx < BENCH_CASES) ? cases[idx].name : NULL;
+}
+
+void Bench_Run(uint8_t idx, uint32_t div, Bench_Result_t *res)
+{
+    const Bench_Case_t *c = &cases[idx];
+    uint32_t iters = c->iters / (div ? div : 1u);
+
+    memset(res, 0, sizeof(*res));
+    res->batch = iters / BENCH_BATCHES;
+    if (res->batch == 0u) res->batch = 1u;
+
+    if (c->setup) c->setup();
+    for (uint32_t b = 0; b < BENCH_BATCHES; b++) {
+        Bench_Stamp_t t0, t1;
+
+        Bench_Idle();
+        Bench_Now(&t0);
+        c->run(res->batch, c->arg);
+        Bench_Now(&t1);
+
+        uint64_t cyc = t1.cycles - t0.cycles;
+        uint64_t ns = t1.ns - t0.ns;
+        if (res->iters == 0u || cyc < res->min_cycles) res->min_cycles = cyc;
+        if (res->iters == 0u || ns < res->min_ns) res->min_ns = ns;
+        res->cycles += cyc;
+        res->ns += ns;
+        res->iters += res->batch;
+    }
+    Bench_Idle();
+
+    /* Платформа без часов в нс (плата): из тактов */
+    if (res->ns == 0u && res->cycles != 0u) {
+        uint32_t mhz = SystemCoreClock / 1000000u;
+        res->ns = res->cycles * 1000u / mhz;
+        res->min_ns = res->min_cycles * 1000u / mhz;
+    }
+}
+
+/* ====== JSON ====== */
+
+/* total / n с двумя знаками; printf без плавающей точки (newlib-nano) */
+static int Fixed2(char *out, size_t max, uint64_t total, uint32_t n)
+{
+    unsigned long v = (unsigned long)(total * 100u / (n ? n : 1u));
+    return snprintf(out, max, "%lu.%02lu", v / 100u, v % 100u);
+}
+
+uint16_t Bench_FormatResult(char *out, uint16_t max, const char *name, const Bench_Result_t *res)
+{
+    char ns[24], min_ns[24], cyc[24] = "null", min_cyc[24] = "null";
+
+    Fixed2(ns, sizeof(ns), res->ns, res->iters);
+    Fixed2(min_ns, sizeof(min_ns), res->min_ns, res->batch);
+    if (res->cycles != 0u) {
+        Fixed2(cyc, sizeof(cyc), res->cycles, res->iters);
+        Fixed2(min_cyc, sizeof(min_cyc), res->min_cycles, res->batch);
+    }
+
+    int len = snprintf(out, max,
+                       "{\"bench\":\"%s\",\"platform\":\"%s\",\"iters\":%lu,"
+                       "\"ns_per_op\":%s,\"min_ns_per_op\":%s,"
+                       "\"cycles_per_op\":%s,\"min_cycles_per_op\":%s}\r\n",
+                       name, Bench_Platform(), (unsigned long)res->iters, ns, min_ns, cyc, min_cyc);
+    return (len < 0) ? 0u : (uint16_t)((len < max) ? len : max - 1);
+}
+
+/* ====== Отчёт в USB-лог ====== */
+
+/* Строка, которую выведет Bench_Task; BENCH_CASES + 1 — отчёта нет */
+static uint8_t task_idx = BENCH_CASES + 1u;
+
+void Bench_Start(void)
+{
+    task_idx = 0u;
+}
+
+void Bench_Task(void)
+{
+    char line[BENCH_LINE_MAX];
+    uint16_t len;
+
+    if (task_idx > BENCH_CASES) return;
+    if (UsbLog_Free() < BENCH_LINE_MAX) return;
+
+    if (task_idx == 0u) {
+        len = Bench_FormatHeader(line, sizeof(line));
+    } else {
+        Bench_Result_t res;
+        uint8_t idx = (uint8_t)(task_idx - 1u);
+        Bench_Run(idx, 1u, &res);
+        len = Bench_FormatResult(line, sizeof(line), cases[idx].name, &res);
+    }
+    UsbLog_Write((const uint8_t *)line, len);
+    task_idx++;
+}
+
+/* ====== Платформа: плата (хост — Host/bench/bench_port.c) ====== */
+
+#ifndef HOST_BUILD
+
+static uint32_t dwt_last;
+static uint64_t dwt_total;
+
+/* 64-битные такты: пачки короче переполнения CYCCNT (8.9 с на 480 МГц).
+   Деления здесь нет — оно попало бы в замер; нс считает Bench_Run */
+void Bench_Now(Bench_Stamp_t *t)
+{
+    uint32_t now = DWT_Cycles();
+    dwt_total += (uint32_t)(now - dwt_last);
+    dwt_last = now;
+    t->cycles = dwt_total;
+    t->ns = 0u;
+}
+
+/* Кольцо лога успевает уйти в USB, иначе usb_log_printf мерил бы вытеснение */
+void Bench_Idle(void)
+{
+    uint32_t t0 = HAL_GetTick();
+    do {
+        UsbLog_Task();
+    } while (UsbLog_Free() < USBLOG_RING_SZ / 2u && HAL_GetTick() - t0 < 20u);
+}
+
+const char *Bench_Platform(void)
+{
+    return "stm32h750";
+}
+
+uint16_t Bench_FormatHeader(char *out, uint16_t max)
+{
+    int len = snprintf(out, max,
+                       "{\"suite\":\"pult\",\"platform\":\"%s\",\"cpu_mhz\":%lu,"
+                       "\"icache\":%u,\"dcache\":%u,\"cases\":%u}\r\n",
+                       Bench_Platform(), (unsigned long)(SystemCoreClock / 1000000u),
+                       (SCB->CCR & SCB_CCR_IC_Msk) ? 1u : 0u,
+                       (SCB->CCR & SCB_CCR_DC_Msk) ? 1u : 0u, (unsigned)BENCH_CASES);
+    return (len < 0) ? 0u : (uint16_t)((len < max) ? len : max - 1);
+}
+
+#endif /* HOST_BUILD */
+
+#endif /* BENCH_ENABLED */
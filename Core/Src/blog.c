@@ -0,0 +1,65 @@
+#include "blog.h"
+#include <stdio.h>
+
+/* Запись собирается на стеке и уходит в кольцо одним UsbLog_Write — целиком */
+#define BLOG_REC_MAX (4u + BLOG_MAX_ARGS * 5u)
+
+static uint8_t *PutVarint(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x80u) {
+        *p++ = (uint8_t)(v | 0x80u);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+void Blog_Write(uint16_t id, uint32_t nargs, const uint32_t *args)
+{
+    uint8_t rec[BLOG_REC_MAX];
+    uint8_t *p = rec;
+
+    if (nargs > BLOG_MAX_ARGS) nargs = BLOG_MAX_ARGS;
+
+    *p++ = BLOG_SYNC;
+    *p++ = (uint8_t)id;
+    *p++ = (uint8_t)(id >> 8);
+    *p++ = (uint8_t)nargs;
+    for (uint32_t i = 0; i < nargs; i++) {
+        p = PutVarint(p, args[i]);
+    }
+    UsbLog_Write(rec, (uint16_t)(p - rec));
+}
+
+void Blog_Dump(uint16_t id, const uint8_t *data, uint16_t len)
+{
+    uint8_t rec[5u + 255u];
+
+    if (len > 255u) len = 255u;
+    rec[0] = BLOG_SYNC;
+    rec[1] = (uint8_t)id;
+    rec[2] = (uint8_t)(id >> 8);
+    rec[3] = BLOG_DUMP_MARK;
+    rec[4] = (uint8_t)len;
+    for (uint16_t i = 0; i < len; i++) rec[5u + i] = data[i];
+    UsbLog_Write(rec, (uint16_t)(5u + len));
+}
+
+/* Текстовый вариант BLOG_DUMP (BLOG_ENABLED = 0) — прежний формат дампа */
+void Blog_DumpText(const char *label, const uint8_t *data, uint16_t len)
+{
+    char line[256];
+    int n = snprintf(line, sizeof(line), "%s (%u): ", label, (unsigned)len);
+
+    for (uint16_t i = 0; i < len && n < (int)sizeof(line) - 8; i++) {
+        n += snprintf(&line[n], sizeof(line) - (size_t)n, "%02X ", data[i]);
+    }
+    n += snprintf(&line[n], sizeof(line) - (size_t)n, " | ");
+    for (uint16_t i = 0; i < len && n < (int)sizeof(line) - 3; i++) {
+        line[n++] = (data[i] >= 32u && data[i] <= 126u) ? (char)data[i] : '.';
+    }
+    if (n > (int)sizeof(line) - 3) n = (int)sizeof(line) - 3;
+    line[n++] = '\r';
+    line[n++] = '\n';
+    UsbLog_Write((const uint8_t *)line, (uint16_t)n);
+}
@@ -0,0 +1,144 @@
+#include "boot.h"
+#include "main.h"
+#include "dwt_cycles.h"
+#include "eeprom_at24.h"
+#include "config_store.h"
+#include "dispenser.h"
+#include "ui_manager.h"
+#include "usb_log.h"
+#include "usbd_cdc_if.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *const phase_names[BOOT_PHASES] = {
+    "start", "poll", "first_s", "config", "ui", "display", "usb"
+};
+
+static uint32_t stamp_us[BOOT_PHASES];
+static uint16_t reached;                   // бит на стадию
+
+// 64-битные такты: USB может перечисляться дольше переполнения CYCCNT
+static uint32_t cyc_last;
+static uint64_t cyc_total;
+
+static SSD1309_t *displays[BOOT_MAX_DISPLAYS];
+static uint8_t display_count;
+
+static volatile uint8_t mirror_loaded;
+static uint8_t reported;
+
+static uint64_t NowUs(void)
+{
+    uint32_t now = DWT_Cycles();
+    cyc_total += (uint32_t)(now - cyc_last);
+    cyc_last = now;
+    return cyc_total / (SystemCoreClock / 1000000u);
+}
+
+static void MirrorLoaded(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)status;   // при ошибке Config_Init читает с шины или берёт умолчания
+    (void)ctx;
+    mirror_loaded = 1u;
+}
+
+void Boot_Mark(Boot_Phase_t phase)
+{
+    if (phase >= BOOT_PHASES || (reached & (1u << phase))) return;
+    uint64_t us = NowUs();
+    stamp_us[phase] = (us < BOOT_NOT_REACHED) ? (uint32_t)us : BOOT_NOT_REACHED - 1u;
+    reached |= (uint16_t)(1u << phase);
+}
+
+uint8_t Boot_Reached(Boot_Phase_t phase)
+{
+    return (phase < BOOT_PHASES && (reached & (1u << phase))) ? 1u : 0u;
+}
+
+uint32_t Boot_GetUs(Boot_Phase_t phase)
+{
+    return Boot_Reached(phase) ? stamp_us[phase] : BOOT_NOT_REACHED;
+}
+
+void Boot_Start(void)
+{
+    memset(stamp_us, 0, sizeof(stamp_us));
+    reached = 0u;
+    cyc_last = DWT_Cycles();
+    cyc_total = cyc_last;
+    display_count = 0u;
+    mirror_loaded = 0u;
+    reported = 0u;
+
+    Boot_Mark(BOOT_PHASE_START);
+
+    // Адреса и скорости по умолчанию: сохранённые придут с зеркалом EEPROM,
+    // Dispenser_ApplyConfig переключит ведомых без перезапуска опроса
+    Config_InitDefaults();
+    Dispenser_Init();
+    Boot_Mark(BOOT_PHASE_POLL_START);
+
+    if (EEPROM_InitAsync(MirrorLoaded, NULL) != HAL_OK) {
+        mirror_loaded = 1u;
+    }
+}
+
+void Boot_AttachDisplay(SSD1309_t *d)
+{
+    if (display_count < BOOT_MAX_DISPLAYS) {
+        displays[display_count++] = d;
+    }
+}
+
+// Панели, уже прошедшие инициализацию, получат команду контраста между кадрами
+static void ApplyPanels(void)
+{
+    const Config_t *cfg = Config_Get();
+
+    for (uint8_t i = 0; i < display_count; i++) {
+        SSD1309_SetPanel(displays[i], cfg->contrast, cfg->invert);
+    }
+}
+
+static uint8_t DisplaysReady(void)
+{
+    for (uint8_t i = 0; i < display_count; i++) {
+        if (!SSD1309_IsSettled(displays[i])) return 0u;
+    }
+    return 1u;
+}
+
+static void Report(void)
+{
+    char line[128];
+    int len = snprintf(line, sizeof(line), "Boot [us]:");
+
+    for (uint8_t p = BOOT_PHASE_POLL_START; p < BOOT_PHASES && len > 0 && len < (int)sizeof(line); p++) {
+        len += snprintf(&line[len], sizeof(line) - (size_t)len, " %s %lu",
+                        phase_names[p], (unsigned long)(stamp_us[p] - stamp_us[BOOT_PHASE_START]));
+    }
+    UsbLog_Printf("%s\r\n", line);
+}
+
+void Boot_Task(void)
+{
+    if (reported) return;
+    (void)NowUs();   // не реже переполнения CYCCNT
+
+    if (mirror_loaded && !Boot_Reached(BOOT_PHASE_CONFIG)) {
+        Config_Init();
+        Dispenser_ApplyConfig();
+        ApplyPanels();
+        Boot_Mark(BOOT_PHASE_CONFIG);
+
+        UI_Init();
+        Boot_Mark(BOOT_PHASE_UI);
+    }
+    if (Boot_Reached(BOOT_PHASE_CONFIG) && DisplaysReady()) Boot_Mark(BOOT_PHASE_DISPLAY);
+    if (CDC_IsConfigured_FS()) Boot_Mark(BOOT_PHASE_USB);
+
+    if (reached == (1u << BOOT_PHASES) - 1u) {
+        Report();
+        reported = 1u;
+    }
+}
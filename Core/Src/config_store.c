@@ -0,0 +1,225 @@
+#include "config_store.h"
+#include "eeprom_at24.h"
+#include <stddef.h>
+#include <string.h>
+
+extern void UsbLog_Printf(const char *fmt, ...);
+
+#define CONFIG_MAGIC 0x4643u   // "CF"
+
+typedef struct {
+    uint16_t magic;
+    uint16_t version;
+    uint32_t seq;       // растёт с каждой записью, новее — больше
+    uint16_t len;       // байт Config_t в записи
+    uint16_t crc;       // CRC16 заголовка (без этого поля) и данных
+} ConfigHeader_t;
+
+_Static_assert(sizeof(ConfigHeader_t) + sizeof(Config_t) <= CONFIG_SLOT_SIZE,
+               "Config_t does not fit into a config slot");
+
+static Config_t config;
+static uint32_t config_seq = 0;
+static uint8_t config_slot = 1;   // последний записанный слот (0 = A, 1 = B)
+static Config_Source_t config_src = CONFIG_SRC_DEFAULTS;
+static uint32_t save_joined_seq = 0;   // запись без своего барьера: её итог — у ожидающего
+static uint8_t slot_buf[2 * CONFIG_SLOT_SIZE];
+
+// CRC-16/CCITT-FALSE
+static uint16_t Crc16(uint16_t crc, const uint8_t *data, uint32_t len) {
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t RecordCrc(const ConfigHeader_t *h, const uint8_t *payload) {
+    uint16_t crc = Crc16(0xFFFFu, (const uint8_t *)h, offsetof(ConfigHeader_t, crc));
+    return Crc16(crc, payload, h->len);
+}
+
+static void Defaults(Config_t *c) {
+    memset(c, 0, sizeof(*c));
+    for (uint32_t u = 0; u < CONFIG_UNITS; u++) {
+        for (uint32_t n = 0; n < CONFIG_NOZZLES; n++) {
+            c->price[u][n] = CONFIG_PRICE_DEFAULT;
+        }
+        c->slave_addr[u] = (uint8_t)(u + 1u);
+    }
+    c->baud[0] = 9600u;
+    c->baud[1] = 115200u;
+    c->poll_idle_ms = 500u;
+    c->poll_fuelling_ms = 200u;
+    c->reply_timeout_ms = 100u;
+    c->contrast = 0x7Fu;
+}
+
+// Значения вне допустимых пределов заменяются умолчаниями по одному полю
+static void Sanitize(Config_t *c) {
+    Config_t d;
+    Defaults(&d);
+
+    for (uint32_t u = 0; u < CONFIG_UNITS; u++) {
+        for (uint32_t n = 0; n < CONFIG_NOZZLES; n++) {
+            if (c->price[u][n] > CONFIG_PRICE_MAX) c->price[u][n] = d.price[u][n];
+        }
+        if (c->baud[u] < 1200u || c->baud[u] > 921600u) c->baud[u] = d.baud[u];
+        if (c->slave_addr[u] == 0u) c->slave_addr[u] = d.slave_addr[u];
+    }
+    if (c->poll_idle_ms == 0u) c->poll_idle_ms = d.poll_idle_ms;
+    if (c->poll_fuelling_ms == 0u) c->poll_fuelling_ms = d.poll_fuelling_ms;
+    if (c->reply_timeout_ms == 0u) c->reply_timeout_ms = d.reply_timeout_ms;
+    c->invert = c->invert ? 1u : 0u;
+    c->debug_overlay = c->debug_overlay ? 1u : 0u;
+}
+
+// Запись версии version длиной len -> текущая схема
+static void Migrate(uint16_t version, const uint8_t *payload, uint16_t len, Config_t *out) {
+    Defaults(out);
+    memcpy(out, payload, (len < sizeof(*out)) ? len : sizeof(*out));
+
+    switch (version) {
+    case CONFIG_VERSION:
+    default:
+        break;
+    }
+    Sanitize(out);
+}
+
+static const ConfigHeader_t *ValidSlot(const uint8_t *slot) {
+    const ConfigHeader_t *h = (const ConfigHeader_t *)slot;
+    if (h->magic != CONFIG_MAGIC) return NULL;
+    if (h->len == 0u || h->len > CONFIG_SLOT_SIZE - sizeof(ConfigHeader_t)) return NULL;
+    if (RecordCrc(h, slot + sizeof(ConfigHeader_t)) != h->crc) return NULL;
+    return h;
+}
+
+static uint32_t LegacyPrice(const uint8_t *b) {
+    return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+}
+
+void Config_InitDefaults(void) {
+    Defaults(&config);
+    config_seq = 0;
+    config_src = CONFIG_SRC_DEFAULTS;
+    save_joined_seq = 0;
+}
+
+Config_Source_t Config_Init(void) {
+    const ConfigHeader_t *a = NULL;
+    const ConfigHeader_t *b = NULL;
+
+    // Из зеркала EEPROM, если оно загружено, иначе одно чтение с шины
+    if (EEPROM_Read(CONFIG_SLOT_A, slot_buf, sizeof(slot_buf)) == HAL_OK) {
+        a = ValidSlot(slot_buf);
+        b = ValidSlot(slot_buf + CONFIG_SLOT_SIZE);
+    }
+
+    if (a || b) {
+        // Порядковые номера сравниваются через разность — переживают переполнение
+        uint8_t use_b = (b && (!a || (int32_t)(b->seq - a->seq) > 0)) ? 1u : 0u;
+        const ConfigHeader_t *h = use_b ? b : a;
+
+        Migrate(h->version, (const uint8_t *)h + sizeof(ConfigHeader_t), h->len, &config);
+        config_seq = h->seq;
+        config_slot = use_b;
+
+        UsbLog_Printf("Config: slot %c seq %lu v%u%s\r\n", use_b ? 'B' : 'A',
+                      (unsigned long)h->seq, h->version,
+                      (a && b) ? "" : " (other slot invalid)");
+        if (h->version != CONFIG_VERSION) {
+            Config_Save(&config);   // сразу в новой схеме
+        }
+        config_src = use_b ? CONFIG_SRC_SLOT_B : CONFIG_SRC_SLOT_A;
+        return config_src;
+    }
+
+    // Ни одной копии: перенос цен из старой раскладки, если они правдоподобны
+    Config_Source_t src = CONFIG_SRC_DEFAULTS;
+    uint8_t legacy[8];
+    Defaults(&config);
+
+    if (EEPROM_Read(CONFIG_LEGACY_PRICE0, legacy, sizeof(legacy)) == HAL_OK) {
+        uint32_t p0 = LegacyPrice(&legacy[CONFIG_LEGACY_PRICE0]);
+        uint32_t p1 = LegacyPrice(&legacy[CONFIG_LEGACY_PRICE1]);
+        if (p0 <= CONFIG_PRICE_MAX && p1 <= CONFIG_PRICE_MAX) {
+            config.price[0][0] = p0;
+            config.price[1][0] = p1;
+            src = CONFIG_SRC_LEGACY;
+        }
+    }
+
+    UsbLog_Printf("Config: no valid slot, %s\r\n",
+                  src == CONFIG_SRC_LEGACY ? "migrated legacy prices" : "using defaults");
+    config_seq = 0;
+    config_slot = 1;          // первая запись пойдёт в слот A
+    Config_Save(&config);
+    config_src = src;
+    return src;
+}
+
+const Config_t *Config_Get(void) {
+    return &config;
+}
+
+uint32_t Config_GetSeq(void) {
+    return config_seq;
+}
+
+Config_Source_t Config_GetSource(void) {
+    return config_src;
+}
+
+static void SaveDone(HAL_StatusTypeDef status, void *ctx) {
+    uint32_t seq = (uint32_t)(uintptr_t)ctx;
+    uint32_t last = save_joined_seq ? save_joined_seq : seq;
+
+    save_joined_seq = 0;
+    if (status != HAL_OK) {
+        if (last != seq) {
+            UsbLog_Printf("Config: save seq %lu..%lu failed\r\n", (unsigned long)seq, (unsigned long)last);
+        } else {
+            UsbLog_Printf("Config: save seq %lu failed\r\n", (unsigned long)seq);
+        }
+    }
+}
+
+HAL_StatusTypeDef Config_Save(const Config_t *cfg) {
+    static uint8_t rec[sizeof(ConfigHeader_t) + sizeof(Config_t)];
+    ConfigHeader_t h;
+    uint8_t slot = config_slot ^ 1u;
+
+    h.magic = CONFIG_MAGIC;
+    h.version = CONFIG_VERSION;
+    h.seq = config_seq + 1u;
+    h.len = sizeof(Config_t);
+    h.crc = RecordCrc(&h, (const uint8_t *)cfg);
+
+    memcpy(rec, &h, sizeof(h));
+    memcpy(rec + sizeof(h), cfg, sizeof(Config_t));
+
+    HAL_StatusTypeDef st = EEPROM_Stage(slot ? CONFIG_SLOT_B : CONFIG_SLOT_A, rec, sizeof(rec));
+    if (st != HAL_OK) return st;
+    // Настройки не ждут простоя шины: сразу в очередь, итог — в SaveDone.
+    // HAL_BUSY — барьер прошлого сохранения ещё не в очереди: встав туда, он
+    // допишет и эту запись, его итог относится к обеим
+    if (EEPROM_FlushBarrier(SaveDone, (void *)(uintptr_t)h.seq) != HAL_OK) {
+        save_joined_seq = h.seq;
+    }
+
+    if (cfg != &config) config = *cfg;
+    config_seq = h.seq;
+    config_slot = slot;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef Config_SetPrice(uint8_t unit, uint8_t nozzle, uint32_t price) {
+    if (unit >= CONFIG_UNITS || nozzle >= CONFIG_NOZZLES || price > CONFIG_PRICE_MAX) return HAL_ERROR;
+
+    Config_t c = config;
+    c.price[unit][nozzle] = price;
+    return Config_Save(&c);
+}
@@ -0,0 +1,14 @@
+#include "deadline.h"
+#include "mem_layout.h"
+
+uint32_t deadline_next DTCM_BSS;
+uint8_t deadline_set DTCM_BSS;
+
+uint8_t Deadline_Take(uint32_t *tick)
+{
+    uint8_t set = deadline_set;
+
+    *tick = deadline_next;
+    deadline_set = 0u;
+    return set;
+}
@@ -1,64 +1,82 @@
 #include "dispenser.h"
 #include "usart.h"
 #include "gaskitlink.h"
+#include "config_store.h"
+#include "blog.h"
+#include "mem_layout.h"
+#include "prof.h"
+#include "deadline.h"
+#include "boot.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 
-extern void UsbLog_Printf(const char *fmt, ...);
-
-Dispenser_t g_dispenser;
+Dispenser_t g_dispenser DTCM_BSS;
 
 // Буферы для каждого UART (для каждого ведомого)
-static uint8_t tx_buf[64];
+static uint8_t tx_buf[64] DMA_BUFFER;
 
 // Буферы для USART2 (ведущий 1)
-static uint8_t rx_dma_buf_uart2[64];
+static uint8_t rx_dma_buf_uart2[64] DMA_BUFFER;
 static uint8_t rx_frame_buf_uart2[64];
 static volatile uint16_t rx_len_uart2 = 0;
 static volatile uint8_t rx_ready_uart2 = 0;
 
 // Буферы для USART3 (ведущий 2)
-static uint8_t rx_dma_buf_uart3[64];
+static uint8_t rx_dma_buf_uart3[64] DMA_BUFFER;
 static uint8_t rx_frame_buf_uart3[64];
 static volatile uint16_t rx_len_uart3 = 0;
 static volatile uint8_t rx_ready_uart3 = 0;
 
-// Таймауты для машины состояний (мс)
-#define STATE_TIMEOUT_SHORT     100
-#define STATE_TIMEOUT_IDLE      500
-#define STATE_TIMEOUT_FUELLING  200
+// Таймауты для машины состояний (мс); опрос и ожидание ответа — из настроек
+#define STATE_TIMEOUT_SHORT     (Config_Get()->reply_timeout_ms)
+#define STATE_TIMEOUT_IDLE      (Config_Get()->poll_idle_ms)
+#define STATE_TIMEOUT_FUELLING  (Config_Get()->poll_fuelling_ms)
 #define STATE_TIMEOUT_N         3000
 
 // Счётчик попыток для повторных отправок
 static uint8_t retry_counts[2] = {0, 0};  // Для каждого ведомого
 #define MAX_RETRIES 3
 
+// Скорость из настроек, если отличается от заданной в MX_USARTx_UART_Init
+static void ApplyBaud(UART_HandleTypeDef *huart, uint32_t baud) {
+    if (huart->Init.BaudRate == baud) return;
+    huart->Init.BaudRate = baud;
+    if (HAL_UART_Init(huart) != HAL_OK) {
+        BLOG("UART baud %lu init failed\r\n", (unsigned long)baud);
+    }
+}
+
 void Dispenser_Init(void) {
+    const Config_t *cfg = Config_Get();
+
     memset(&g_dispenser, 0, sizeof(Dispenser_t));
     
-    // Инициализация первого ведомого (USART2, адрес 0x01)
+    // Инициализация первого ведомого (USART2, по умолчанию адрес 0x01)
     g_dispenser.units[0].status = DS_IDLE;
-    g_dispenser.units[0].state = STATE_IDLE;
+    g_dispenser.units[0].state = STATE_SEND_STATUS;   // первый S — без паузы простоя
     g_dispenser.units[0].state_entry_tick = HAL_GetTick();
     g_dispenser.units[0].huart = &huart2;
-    g_dispenser.units[0].slave_address = 0x01;
+    g_dispenser.units[0].slave_address = cfg->slave_addr[0];
     g_dispenser.units[0].t_command_sent = 0;
     g_dispenser.units[0].transaction_closed = 0;
     
-    // Инициализация второго ведомого (USART3, адрес 0x02)
+    // Инициализация второго ведомого (USART3, по умолчанию адрес 0x02)
     g_dispenser.units[1].status = DS_IDLE;
-    g_dispenser.units[1].state = STATE_IDLE;
+    g_dispenser.units[1].state = STATE_SEND_STATUS;
     g_dispenser.units[1].state_entry_tick = HAL_GetTick();
     g_dispenser.units[1].huart = &huart3;
-    g_dispenser.units[1].slave_address = 0x02;
+    g_dispenser.units[1].slave_address = cfg->slave_addr[1];
     g_dispenser.units[1].t_command_sent = 0;
     g_dispenser.units[1].transaction_closed = 0;
     
     // Установка активного ведомого по умолчанию (первый)
     g_dispenser.active_unit = 0;
     
+    ApplyBaud(&huart2, cfg->baud[0]);
+    ApplyBaud(&huart3, cfg->baud[1]);
+
     // Запуск приема данных для обоих UART
     HAL_UARTEx_ReceiveToIdle_DMA(&huart2, rx_dma_buf_uart2, sizeof(rx_dma_buf_uart2));
     HAL_UARTEx_ReceiveToIdle_DMA(&huart3, rx_dma_buf_uart3, sizeof(rx_dma_buf_uart3));
@@ -73,17 +91,47 @@ static void ChangeState(uint8_t unit_idx, DispenserState_t new_state) {
         unit->state = new_state;
         unit->state_entry_tick = HAL_GetTick();
         retry_counts[unit_idx] = 0;
+        Deadline_At(unit->state_entry_tick);   // новое состояние действует сразу
 
         const char* state_names[] = {
             "IDLE", "SEND_STATUS", "WAIT_STATUS", "SEND_L", "WAIT_L",
             "SEND_R", "WAIT_R", "SEND_T", "WAIT_T", "SEND_N", "WAIT_N", "ERROR"
         };
         if (new_state < sizeof(state_names) / sizeof(state_names[0])) {
-            UsbLog_Printf("[UNIT%d] [STATE] -> %s\r\n", unit_idx + 1, state_names[new_state]);
+            BLOG("[UNIT%d] [STATE] -> %s\r\n", unit_idx + 1, BLOG_STR(state_names[new_state]));
         }
     }
 }
 
+// Настройки, загруженные после Dispenser_Init (boot.c). Ведомый, у которого
+// сменились адрес или скорость, опрашивается заново: обмен, начатый на
+// умолчаниях, не в счёт
+void Dispenser_ApplyConfig(void) {
+    const Config_t *cfg = Config_Get();
+
+    for (uint8_t i = 0; i < 2; i++) {
+        DispenserUnit_t *unit = &g_dispenser.units[i];
+        UART_HandleTypeDef *huart = unit->huart;
+
+        if (unit->slave_address == cfg->slave_addr[i] && huart->Init.BaudRate == cfg->baud[i]) continue;
+        unit->slave_address = cfg->slave_addr[i];
+
+        if (huart->Init.BaudRate != cfg->baud[i]) {
+            // DMA приёма останавливается до HAL_UART_Init
+            HAL_UART_AbortReceive(huart);
+            ApplyBaud(huart, cfg->baud[i]);
+            if (i == 0) {
+                rx_ready_uart2 = 0;
+                HAL_UARTEx_ReceiveToIdle_DMA(huart, rx_dma_buf_uart2, sizeof(rx_dma_buf_uart2));
+            } else {
+                rx_ready_uart3 = 0;
+                HAL_UARTEx_ReceiveToIdle_DMA(huart, rx_dma_buf_uart3, sizeof(rx_dma_buf_uart3));
+            }
+        }
+        ChangeState(i, STATE_SEND_STATUS);
+    }
+}
+
 static void SendFrame(uint8_t unit_idx, char cmd, const char *data) {
     if (unit_idx >= 2) return;
     
@@ -93,15 +141,16 @@ static void SendFrame(uint8_t unit_idx, char cmd, const char *data) {
     
     uint16_t len = Gas_BuildFrame(tx_buf, addr_high, addr_low, cmd, data);
     
+    if (cmd == 'S') Boot_Mark(BOOT_PHASE_FIRST_POLL);
     HAL_StatusTypeDef status = HAL_UART_Transmit(unit->huart, tx_buf, len, 100);
     if (status != HAL_OK) {
-        UsbLog_Printf("TX ERROR UNIT%d: cmd=%c, status=%d\r\n", unit_idx + 1, cmd, status);
+        BLOG("TX ERROR UNIT%d: cmd=%c, status=%d\r\n", unit_idx + 1, cmd, status);
     }
 
     if (data && data[0] != '\0') {
         UsbLog_Printf("UNIT%d TX: %c%s\r\n", unit_idx + 1, cmd, data);
     } else {
-        UsbLog_Printf("UNIT%d TX: %c\r\n", unit_idx + 1, cmd);
+        BLOG("UNIT%d TX: %c\r\n", unit_idx + 1, cmd);
     }
 }
 
@@ -110,6 +159,7 @@ static uint8_t IsStateTimeout(uint8_t unit_idx, uint32_t timeout_ms) {
     
     DispenserUnit_t *unit = &g_dispenser.units[unit_idx];
     uint32_t now = HAL_GetTick();
+    Deadline_At(unit->state_entry_tick + timeout_ms + 1u);
     return (now - unit->state_entry_tick) > timeout_ms;
 }
 
@@ -127,12 +177,12 @@ static uint8_t ProcessStatusResponse(uint8_t unit_idx, const GasFrame_t *frame)
     unit->is_connected = 1;
     unit->last_update_tick = HAL_GetTick();
 
-    UsbLog_Printf("UNIT%d RX: S[nozzle=%c][status=%c] len=%d\r\n",
+    BLOG("UNIT%d RX: S[nozzle=%c][status=%c] len=%d\r\n",
         unit_idx + 1, nozzle_char, status_char, frame->data_len);
 
     if (nozzle_char == '9' && status_char == '0') {
         unit->status = DS_END;
-        UsbLog_Printf("UNIT%d S90 - Transaction end, nozzle hung\r\n", unit_idx + 1);
+        BLOG("UNIT%d S90 - Transaction end, nozzle hung\r\n", unit_idx + 1);
         return 1;
     }
     else if (nozzle_char == '1' && status_char == '0') {
@@ -141,43 +191,43 @@ static uint8_t ProcessStatusResponse(uint8_t unit_idx, const GasFrame_t *frame)
     }
     else if (nozzle_char == '2' && status_char == '1') {
         unit->status = DS_CALLING;
-        UsbLog_Printf("UNIT%d S21 - Nozzle lifted without authorization\r\n", unit_idx + 1);
+        BLOG("UNIT%d S21 - Nozzle lifted without authorization\r\n", unit_idx + 1);
         return 0;
     }
     else if (nozzle_char == '3' && status_char == '1') {
         unit->status = DS_AUTHORIZED;
         if (unit->volume_cl > 0 || unit->amount > 0) {
-            UsbLog_Printf("UNIT%d New transaction authorized - resetting previous data\r\n", unit_idx + 1);
+            BLOG("UNIT%d New transaction authorized - resetting previous data\r\n", unit_idx + 1);
             unit->volume_cl = 0;
             unit->amount = 0;
             unit->transaction_id = 0;
         }
-        UsbLog_Printf("UNIT%d S31 - Transaction authorized\r\n", unit_idx + 1);
+        BLOG("UNIT%d S31 - Transaction authorized\r\n", unit_idx + 1);
         return 0;
     }
     else if (nozzle_char == '4' && status_char == '1') {
         unit->status = DS_STARTED;
-        UsbLog_Printf("UNIT%d S41 - Transaction started\r\n", unit_idx + 1);
+        BLOG("UNIT%d S41 - Transaction started\r\n", unit_idx + 1);
         return 0;
     }
     else if (nozzle_char == '6' && status_char == '1') {
         unit->status = DS_FUELLING;
-        UsbLog_Printf("UNIT%d S61 - Fuelling in progress\r\n", unit_idx + 1);
+        BLOG("UNIT%d S61 - Fuelling in progress\r\n", unit_idx + 1);
         return 1;
     }
     else if (nozzle_char == '8' && status_char == '1') {
         unit->status = DS_STOP;
-        UsbLog_Printf("UNIT%d S81 - Transaction completed, nozzle not hung\r\n", unit_idx + 1);
+        BLOG("UNIT%d S81 - Transaction completed, nozzle not hung\r\n", unit_idx + 1);
         return 1;
     }
     else {
-        UsbLog_Printf("UNIT%d Unknown status S%c%c\r\n", unit_idx + 1, nozzle_char, status_char);
+        BLOG("UNIT%d Unknown status S%c%c\r\n", unit_idx + 1, nozzle_char, status_char);
         unit->status = DS_IDLE;
         return 0;
     }
 }
 
-static void ProcessUnitUpdate(uint8_t unit_idx) {
+ITCM_CODE static void ProcessUnitUpdate(uint8_t unit_idx) {
     if (unit_idx >= 2) return;
     
     DispenserUnit_t *unit = &g_dispenser.units[unit_idx];
@@ -238,11 +288,11 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
                         }
                         else if (unit->status == DS_STOP) {
                             if (!unit->t_command_sent) {
-                                UsbLog_Printf("UNIT%d S81 - Sending T command (first time)\r\n", unit_idx + 1);
+                                BLOG("UNIT%d S81 - Sending T command (first time)\r\n", unit_idx + 1);
                                 unit->t_command_sent = 1;
                                 ChangeState(unit_idx, STATE_SEND_T);
                             } else {
-                                UsbLog_Printf("UNIT%d S81 - T already sent, waiting for S90\r\n", unit_idx + 1);
+                                BLOG("UNIT%d S81 - T already sent, waiting for S90\r\n", unit_idx + 1);
                                 ChangeState(unit_idx, STATE_IDLE);
                             }
                         }
@@ -263,7 +313,7 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
                 has_data = 0;
             }
             else if (IsStateTimeout(unit_idx, STATE_TIMEOUT_SHORT)) {
-                UsbLog_Printf("[TIMEOUT] UNIT%d WAIT_STATUS\r\n", unit_idx + 1);
+                BLOG("[TIMEOUT] UNIT%d WAIT_STATUS\r\n", unit_idx + 1);
                 if (retry_counts[unit_idx] < MAX_RETRIES) {
                     retry_counts[unit_idx]++;
                     ChangeState(unit_idx, STATE_SEND_STATUS);
@@ -290,7 +340,7 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
                         memcpy(volume_str, &frame.data[4], 6);
                         unit->volume_cl = (uint32_t)atol(volume_str);
 
-                        UsbLog_Printf("UNIT%d L: nozzle=%d, tid='%c', volume=%lu cl\r\n",
+                        BLOG("UNIT%d L: nozzle=%d, tid='%c', volume=%lu cl\r\n",
                             unit_idx + 1, unit->nozzle, unit->transaction_id,
                             unit->volume_cl);
                     }
@@ -301,7 +351,7 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
                 has_data = 0;
             }
             else if (IsStateTimeout(unit_idx, STATE_TIMEOUT_SHORT)) {
-                UsbLog_Printf("[TIMEOUT] UNIT%d WAIT_L\r\n", unit_idx + 1);
+                BLOG("[TIMEOUT] UNIT%d WAIT_L\r\n", unit_idx + 1);
                 if (retry_counts[unit_idx] < MAX_RETRIES) {
                     retry_counts[unit_idx]++;
                     ChangeState(unit_idx, STATE_SEND_L);
@@ -325,7 +375,7 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
                         memcpy(amount_str, &frame.data[4], 6);
                         unit->amount = (uint32_t)atol(amount_str);
 
-                        UsbLog_Printf("UNIT%d R: amount=%lu\r\n", unit_idx + 1, unit->amount);
+                        BLOG("UNIT%d R: amount=%lu\r\n", unit_idx + 1, unit->amount);
                     }
 
                     // After R response, continue S-L-R-S cycle if still fuelling
@@ -339,7 +389,7 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
                 has_data = 0;
             }
             else if (IsStateTimeout(unit_idx, STATE_TIMEOUT_SHORT)) {
-                UsbLog_Printf("[TIMEOUT] UNIT%d WAIT_R\r\n", unit_idx + 1);
+                BLOG("[TIMEOUT] UNIT%d WAIT_R\r\n", unit_idx + 1);
                 if (retry_counts[unit_idx] < MAX_RETRIES) {
                     retry_counts[unit_idx]++;
                     ChangeState(unit_idx, STATE_SEND_R);
@@ -370,19 +420,19 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
                         memcpy(volume_str, &frame.data[11], 6);
                         unit->volume_cl = (uint32_t)atol(volume_str);
 
-                        UsbLog_Printf("UNIT%d T: nozzle=%d, tid='%c', amount=%lu, volume=%lu cl\r\n",
+                        BLOG("UNIT%d T: nozzle=%d, tid='%c', amount=%lu, volume=%lu cl\r\n",
                             unit_idx + 1, unit->nozzle, unit->transaction_id,
                             unit->amount, unit->volume_cl);
                     }
 
-                    UsbLog_Printf("UNIT%d T received - flag remains set until transaction closes\r\n", unit_idx + 1);
+                    BLOG("UNIT%d T received - flag remains set until transaction closes\r\n", unit_idx + 1);
                     ChangeState(unit_idx, STATE_IDLE);
                     // DMA перезапускается в прерывании UARTEx_RxEventCallback
                 }
                 has_data = 0;
             }
             else if (IsStateTimeout(unit_idx, STATE_TIMEOUT_SHORT)) {
-                UsbLog_Printf("[TIMEOUT] UNIT%d WAIT_T\r\n", unit_idx + 1);
+                BLOG("[TIMEOUT] UNIT%d WAIT_T\r\n", unit_idx + 1);
                 ChangeState(unit_idx, STATE_IDLE);
             }
             break;
@@ -397,7 +447,7 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
                 // Обрабатываем ответ на команду N (обычно пустой ответ)
                 GasFrame_t frame;
                 if (Gas_ParseFrame(local_rx_buf, local_rx_len, &frame) == 0) {
-                    UsbLog_Printf("UNIT%d N response received\r\n", unit_idx + 1);
+                    BLOG("UNIT%d N response received\r\n", unit_idx + 1);
                     // Сбрасываем флаги и возвращаемся к опросу статуса
                     unit->t_command_sent = 0;
                     unit->transaction_closed = 0;
@@ -412,11 +462,14 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
             break;
 
         case STATE_ERROR:
-            UsbLog_Printf("UNIT%d [ERROR] Communication error, resetting\r\n", unit_idx + 1);
+            // Сообщение — один раз, а не на каждой итерации 500 мс ожидания
+            if (unit->is_connected) {
+                BLOG("UNIT%d [ERROR] Communication error, resetting\r\n", unit_idx + 1);
+            }
             unit->is_connected = 0;
             unit->t_command_sent = 0;
             if (IsStateTimeout(unit_idx, 500)) {
-                UsbLog_Printf("UNIT%d [ERROR] Recovery, returning to IDLE\r\n", unit_idx + 1);
+                BLOG("UNIT%d [ERROR] Recovery, returning to IDLE\r\n", unit_idx + 1);
                 ChangeState(unit_idx, STATE_IDLE);
             }
             break;
@@ -460,19 +513,23 @@ static void ProcessUnitUpdate(uint8_t unit_idx) {
         HAL_UARTEx_ReceiveToIdle_DMA(huart, rx_dma_buf, sizeof(rx_dma_buf));
     }
     
+    if (unit->is_connected) Deadline_At(unit->last_update_tick + 2001u);
     if (now - unit->last_update_tick > 2000) {
         if (unit->is_connected) {
             unit->is_connected = 0;
-            UsbLog_Printf("UNIT%d Dispenser connection timeout!\r\n", unit_idx + 1);
+            BLOG("UNIT%d Dispenser connection timeout!\r\n", unit_idx + 1);
             ChangeState(unit_idx, STATE_ERROR);
         }
     }
 }
 
 void Dispenser_Update(void) {
-    // Обновление обоих ведомых устройств
-    ProcessUnitUpdate(0);  // Ведомый 1 (USART2)
-    ProcessUnitUpdate(1);  // Ведомый 2 (USART3)
+    // Обновление обоих ведомых устройств: 0 - USART2, 1 - USART3
+    for (uint8_t u = 0; u < 2u; u++) {
+        PROF_BEGIN(PROCESS_UNIT);
+        ProcessUnitUpdate(u);
+        PROF_END(PROCESS_UNIT);
+    }
 }
 
 void Dispenser_StartVolume(uint8_t unit_idx, uint8_t nozzle, uint32_t volume_cl, uint32_t price) {
@@ -486,7 +543,7 @@ void Dispenser_StartVolume(uint8_t unit_idx, uint8_t nozzle, uint32_t volume_cl,
     unit->t_command_sent = 0;
     unit->transaction_closed = 0;
 
-    UsbLog_Printf("UNIT%d Starting new volume transaction - reset T flag\r\n", unit_idx + 1);
+    BLOG("UNIT%d Starting new volume transaction - reset T flag\r\n", unit_idx + 1);
 
     char data[32];
     snprintf(data, sizeof(data), "%d;%06lu;%04lu",
@@ -505,7 +562,7 @@ void Dispenser_StartAmount(uint8_t unit_idx, uint8_t nozzle, uint32_t amount, ui
     unit->t_command_sent = 0;
     unit->transaction_closed = 0;
 
-    UsbLog_Printf("UNIT%d Starting new amount transaction - reset T flag\r\n", unit_idx + 1);
+    BLOG("UNIT%d Starting new amount transaction - reset T flag\r\n", unit_idx + 1);
 
     char data[32];
     snprintf(data, sizeof(data), "%d;%06lu;%04lu",
@@ -555,7 +612,11 @@ DispenserUnit_t* Dispenser_GetUnit(uint8_t unit_idx) {
     return NULL;
 }
 
-void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+uint8_t Dispenser_ProcessStatus(uint8_t unit_idx, const GasFrame_t *frame) {
+    return ProcessStatusResponse(unit_idx, frame);
+}
+
+ITCM_CODE void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
     if (huart == &huart2) {
         if (Size <= sizeof(rx_frame_buf_uart2)) {
             memcpy(rx_frame_buf_uart2, rx_dma_buf_uart2, Size);
@@ -563,19 +624,7 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
             rx_ready_uart2 = 1;
 
             #if 1
-            UsbLog_Printf("UART2 RAW RX (%d): ", Size);
-            for (uint16_t i = 0; i < Size; i++) {
-                UsbLog_Printf("%02X ", rx_dma_buf_uart2[i]);
-            }
-            UsbLog_Printf(" | ");
-            for (uint16_t i = 0; i < Size; i++) {
-                if (rx_dma_buf_uart2[i] >= 32 && rx_dma_buf_uart2[i] < 127) {
-                    UsbLog_Printf("%c", rx_dma_buf_uart2[i]);
-                } else {
-                    UsbLog_Printf(".");
-                }
-            }
-            UsbLog_Printf("\r\n");
+            BLOG_DUMP("UART2 RAW RX", rx_dma_buf_uart2, Size);
             #endif
         }
         // ВАЖНО: Перезапуск DMA для продолжения приема
@@ -588,19 +637,7 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
             rx_ready_uart3 = 1;
 
             #if 1
-            UsbLog_Printf("UART3 RAW RX (%d): ", Size);
-            for (uint16_t i = 0; i < Size; i++) {
-                UsbLog_Printf("%02X ", rx_dma_buf_uart3[i]);
-            }
-            UsbLog_Printf(" | ");
-            for (uint16_t i = 0; i < Size; i++) {
-                if (rx_dma_buf_uart3[i] >= 32 && rx_dma_buf_uart3[i] < 127) {
-                    UsbLog_Printf("%c", rx_dma_buf_uart3[i]);
-                } else {
-                    UsbLog_Printf(".");
-                }
-            }
-            UsbLog_Printf("\r\n");
+            BLOG_DUMP("UART3 RAW RX", rx_dma_buf_uart3, Size);
             #endif
         }
         // ВАЖНО: Перезапуск DMA для продолжения приема
@@ -1,27 +1,647 @@
 #include "eeprom_at24.h"
+#include "deadline.h"
+#include <string.h>
 
 #define EEPROM_PRICE_ADDR 0x0000
 #define EEPROM_PRICE2_ADDR 0x0004  // Второй адрес для второй цены
 
+#define MIRROR_PAGES (EEPROM_MIRROR_SIZE / EEPROM_PAGE_SIZE)
+
+extern void UsbLog_Printf(const char *fmt, ...);
+
+typedef enum {
+    OP_WRITE = 0,
+    OP_READ,
+    OP_BARRIER                         // без обмена: все запросы до него завершены
+} EepromOp_t;
+
+typedef struct {
+    uint8_t op;
+    uint16_t addr;
+    uint16_t size;
+    uint8_t *dst;                      // OP_READ
+    uint8_t buf[EEPROM_MAX_WRITE];     // OP_WRITE: копия данных
+    uint32_t fail_mark;                // OP_BARRIER: write_failures при постановке
+    EEPROM_Callback_t cb;
+    void *ctx;
+} EepromReq_t;
+
+typedef enum {
+    ST_IDLE = 0,
+    ST_DATA,        // идёт Mem_Write_IT / Mem_Read_IT
+    ST_POLL_WAIT,   // цикл записи, ждём следующего опроса
+    ST_POLLING      // идёт опрос ACK
+} EepromState_t;
+
+// Событие от ISR
+enum { EVT_NONE = 0, EVT_DONE, EVT_ERROR };
+
+static EepromReq_t queue[EEPROM_QUEUE_LEN];
+static uint8_t q_head = 0;   // пишет main loop
+static uint8_t q_tail = 0;   // текущий запрос
+static uint8_t q_count = 0;
+
+static EepromState_t state = ST_IDLE;
+static volatile uint8_t i2c_evt = EVT_NONE;
+static volatile uint32_t i2c_err = 0;
+
+static uint16_t done;        // байт текущего запроса уже записано
+static uint16_t chunk;       // размер текущей страничной порции
+static uint32_t cycle_start;
+static uint32_t last_poll;
+static uint8_t poll_dummy;
+static uint32_t write_failures;
+
+// Грязные страницы отложенной записи (вне зеркала)
+typedef struct {
+    uint8_t used;
+    uint8_t filling;         // идёт дочитывание промежутков между участками
+    uint8_t fill_failed;     // дочитать не удалось: участки пишутся по отдельности
+    uint16_t page;           // номер страницы (адрес / EEPROM_PAGE_SIZE)
+    uint64_t dirty;          // бит на байт страницы
+    uint64_t known;          // байты data, совпадающие с микросхемой или новее
+    uint64_t fill_span;      // что дочитывается в fill
+    uint32_t t_first;        // время первого изменения
+    uint8_t data[EEPROM_PAGE_SIZE];
+    uint8_t fill[EEPROM_PAGE_SIZE];
+} WbPage_t;
+
+static WbPage_t wb[EEPROM_WB_PAGES];
+static uint8_t wb_flush_req = 0;
+static EEPROM_Stats_t stats;
+
+// Зеркало начала EEPROM: само является буфером отложенной записи
+static uint8_t mirror[EEPROM_MIRROR_SIZE];
+static uint64_t mirror_dirty[MIRROR_PAGES];
+static uint32_t mirror_t[MIRROR_PAGES];
+static uint8_t mirror_valid = 0;
+static EEPROM_Callback_t mirror_cb;      // EEPROM_InitAsync: зеркало загружено
+static void *mirror_cb_ctx;
+
+// Отложенный барьер: очередь была полна в момент EEPROM_FlushBarrier
+static uint8_t barrier_pending = 0;
+static uint32_t barrier_mark;
+static EEPROM_Callback_t barrier_cb;
+static void *barrier_ctx;
+
+static void WbOverlay(uint16_t addr, uint8_t *dst, uint16_t size);
+static void QueueOverlay(uint16_t addr, uint8_t *dst, uint16_t size);
+
+static uint8_t InMirror(uint32_t addr, uint32_t size) {
+    return (mirror_valid && addr + size <= EEPROM_MIRROR_SIZE) ? 1u : 0u;
+}
+
+static HAL_StatusTypeDef Enqueue(const EepromReq_t *r) {
+    if (q_count >= EEPROM_QUEUE_LEN) return HAL_BUSY;
+    queue[q_head] = *r;
+    q_head = (uint8_t)((q_head + 1u) % EEPROM_QUEUE_LEN);
+    q_count++;
+    return HAL_OK;
+}
+
+static void Complete(HAL_StatusTypeDef status) {
+    EepromReq_t *r = &queue[q_tail];
+    EEPROM_Callback_t cb = r->cb;
+    void *ctx = r->ctx;
+
+    if (status == HAL_OK && r->op == OP_READ) {
+        // Сначала записи, вставшие в очередь после чтения, затем слоты — новее всех
+        QueueOverlay(r->addr, r->dst, r->size);
+        WbOverlay(r->addr, r->dst, r->size);
+    }
+
+    if (status != HAL_OK) {
+        if (r->op == OP_WRITE) write_failures++;
+        UsbLog_Printf("EEPROM: %s 0x%04X len %u failed (%d, i2c err 0x%lX)\r\n",
+                      r->op == OP_WRITE ? "write" : (r->op == OP_READ ? "read" : "barrier"),
+                      r->addr, r->size, (int)status, (unsigned long)i2c_err);
+    }
+
+    q_tail = (uint8_t)((q_tail + 1u) % EEPROM_QUEUE_LEN);
+    q_count--;
+    state = ST_IDLE;
+
+    // Запрос уже снят с очереди: из callback можно ставить новые
+    if (cb) cb(status, ctx);
+}
+
+// Порция до конца страницы: запись через границу страницы завернулась бы в её начало
+static HAL_StatusTypeDef StartChunk(EepromReq_t *r) {
+    uint16_t addr = (uint16_t)(r->addr + done);
+    uint16_t room = (uint16_t)(EEPROM_PAGE_SIZE - (addr % EEPROM_PAGE_SIZE));
+    uint16_t left = (uint16_t)(r->size - done);
+    chunk = (left < room) ? left : room;
+
+    i2c_evt = EVT_NONE;
+    state = ST_DATA;
+    return HAL_I2C_Mem_Write_IT(&hi2c1, AT24C256_ADDR, addr, I2C_MEMADD_SIZE_16BIT, &r->buf[done], chunk);
+}
+
+static void StartNext(void) {
+    if (q_count == 0) return;
+    EepromReq_t *r = &queue[q_tail];
+    HAL_StatusTypeDef st;
+
+    done = 0;
+    if (r->op == OP_BARRIER) {
+        // Все записи, поставленные до барьера, уже завершены (очередь FIFO)
+        Complete((write_failures != r->fail_mark) ? HAL_ERROR : HAL_OK);
+        return;
+    }
+    if (r->op == OP_READ && InMirror(r->addr, r->size)) {
+        memcpy(r->dst, &mirror[r->addr], r->size);
+        stats.mirror_hits++;
+        Complete(HAL_OK);
+        return;
+    }
+
+    if (r->op == OP_WRITE) {
+        st = StartChunk(r);
+    } else {
+        i2c_evt = EVT_NONE;
+        state = ST_DATA;
+        st = HAL_I2C_Mem_Read_IT(&hi2c1, AT24C256_ADDR, r->addr, I2C_MEMADD_SIZE_16BIT, r->dst, r->size);
+    }
+
+    if (st == HAL_BUSY) {
+        state = ST_IDLE;     // шина занята — попробуем на следующем проходе
+    } else if (st != HAL_OK) {
+        Complete(st);
+    }
+}
+
+/* ---------- Отложенная запись ---------- */
+
+static uint8_t QueueIdle(void) {
+    return (state == ST_IDLE && q_count == 0) ? 1u : 0u;
+}
+
+// Свежие байты из грязных страниц поверх прочитанного из микросхемы
+static void WbOverlay(uint16_t addr, uint8_t *dst, uint16_t size) {
+    for (uint32_t i = 0; i < EEPROM_WB_PAGES; i++) {
+        WbPage_t *p = &wb[i];
+        if (!p->used) continue;
+        uint32_t base = (uint32_t)p->page * EEPROM_PAGE_SIZE;
+        if (base + EEPROM_PAGE_SIZE <= addr || base >= (uint32_t)addr + size) continue;
+        for (uint32_t b = 0; b < EEPROM_PAGE_SIZE; b++) {
+            uint32_t a = base + b;
+            if (a >= addr && a < (uint32_t)addr + size && (p->dirty & (1ull << b))) {
+                dst[a - addr] = p->data[b];
+            }
+        }
+    }
+}
+
+// Запись, стоящая в очереди за текущим чтением: страница, сброшенная из
+// слота после постановки чтения, уже не в wb, а только в этих копиях
+static void QueueOverlay(uint16_t addr, uint8_t *dst, uint16_t size) {
+    for (uint8_t k = 1; k < q_count; k++) {
+        const EepromReq_t *w = &queue[(q_tail + k) % EEPROM_QUEUE_LEN];
+        if (w->op != OP_WRITE) continue;
+
+        uint32_t lo = (w->addr > addr) ? w->addr : addr;
+        uint32_t hi = ((uint32_t)w->addr + w->size < (uint32_t)addr + size) ? (uint32_t)w->addr + w->size
+                                                                             : (uint32_t)addr + size;
+        if (lo < hi) memcpy(&dst[lo - addr], &w->buf[lo - w->addr], hi - lo);
+    }
+}
+
+// Маска n байт страницы начиная с off; n == 64 нельзя сдвигать на всю ширину
+static uint64_t RunMask(uint32_t off, uint32_t n) {
+    return (n == 64u) ? ~0ull : (((1ull << n) - 1u) << off);
+}
+
+// Каждый непрерывный грязный участок страницы — один запрос в очередь.
+// Если очередь заполнилась, оставшиеся участки остаются грязными.
+static HAL_StatusTypeDef FlushRuns(uint32_t base, const uint8_t *data, uint64_t *dirty) {
+    uint32_t b = 0;
+
+    while (b < EEPROM_PAGE_SIZE) {
+        if (!(*dirty & (1ull << b))) { b++; continue; }
+        uint32_t e = b;
+        while (e < EEPROM_PAGE_SIZE && (*dirty & (1ull << e))) e++;
+
+        if (EEPROM_WriteAsync((uint16_t)(base + b), &data[b], (uint16_t)(e - b), NULL, NULL) != HAL_OK) {
+            return HAL_BUSY;
+        }
+        stats.page_writes++;
+        stats.write_bytes += e - b;
+        *dirty &= ~RunMask(b, e - b);
+        b = e;
+    }
+    return HAL_OK;
+}
+
+// Участок от первого до последнего грязного байта страницы
+static uint64_t SpanMask(uint64_t dirty) {
+    uint32_t first = (uint32_t)__builtin_ctzll(dirty);
+    uint32_t last = 63u - (uint32_t)__builtin_clzll(dirty);
+    return RunMask(first, last - first + 1u);
+}
+
+static HAL_StatusTypeDef FlushSpan(uint32_t base, const uint8_t *data, uint64_t *dirty) {
+    uint32_t first = (uint32_t)__builtin_ctzll(*dirty);
+    uint32_t n = 64u - (uint32_t)__builtin_clzll(*dirty) - first;
+
+    if (EEPROM_WriteAsync((uint16_t)(base + first), &data[first], (uint16_t)n, NULL, NULL) != HAL_OK) {
+        return HAL_BUSY;
+    }
+    stats.page_writes++;
+    stats.write_bytes += n;
+    *dirty = 0;
+    return HAL_OK;
+}
+
+// Промежутки прочитаны: свежие (грязные) байты слота не трогаются. Слот,
+// который ждёт чтения, не вытесняется, поэтому он всё ещё за той же страницей
+static void WbFilled(HAL_StatusTypeDef status, void *ctx) {
+    WbPage_t *p = (WbPage_t *)ctx;
+    uint64_t span = p->fill_span;
+
+    p->filling = 0;
+    if (status != HAL_OK) {
+        p->fill_failed = 1;
+        return;
+    }
+    for (uint32_t b = 0; b < EEPROM_PAGE_SIZE; b++) {
+        if ((span & (1ull << b)) && !(p->known & (1ull << b))) p->data[b] = p->fill[b];
+    }
+    p->known |= span;
+}
+
+// Страница — одним циклом записи: промежутки между грязными участками
+// сначала дочитываются из микросхемы. split — без дочитывания, по участкам
+// (вытеснение ради свободного слота, сбой чтения)
+static HAL_StatusTypeDef WbFlushPage(WbPage_t *p, uint8_t split) {
+    uint32_t base = (uint32_t)p->page * EEPROM_PAGE_SIZE;
+    uint64_t span = SpanMask(p->dirty);
+
+    if (p->filling) return HAL_BUSY;
+    if ((span & ~p->known) == 0) {
+        if (FlushSpan(base, p->data, &p->dirty) != HAL_OK) return HAL_BUSY;
+    } else if (split || p->fill_failed) {
+        if (FlushRuns(base, p->data, &p->dirty) != HAL_OK) return HAL_BUSY;
+    } else {
+        uint32_t first = (uint32_t)__builtin_ctzll(span);
+        uint32_t n = (uint32_t)__builtin_popcountll(span);
+        if (EEPROM_ReadAsync((uint16_t)(base + first), &p->fill[first], (uint16_t)n, WbFilled, p) != HAL_OK) {
+            return HAL_BUSY;
+        }
+        stats.fill_reads++;
+        p->fill_span = span;
+        p->filling = 1;
+        return HAL_BUSY;
+    }
+    p->used = 0;
+    return HAL_OK;
+}
+
+// Зеркало держит страницу целиком: промежутки между изменёнными участками
+// уходят заодно, вся страница — один цикл записи
+static HAL_StatusTypeDef MirrorFlushPage(uint32_t pg) {
+    return FlushSpan(pg * EEPROM_PAGE_SIZE, &mirror[pg * EEPROM_PAGE_SIZE], &mirror_dirty[pg]);
+}
+
+static WbPage_t *WbSlot(uint16_t page, uint32_t now) {
+    WbPage_t *free_slot = NULL;
+    WbPage_t *oldest = NULL;
+
+    for (uint32_t i = 0; i < EEPROM_WB_PAGES; i++) {
+        WbPage_t *p = &wb[i];
+        if (p->used && p->page == page) return p;
+        if (!p->used) {
+            if (!free_slot) free_slot = p;
+        } else if (!p->filling && (!oldest || (int32_t)(p->t_first - oldest->t_first) < 0)) {
+            oldest = p;
+        }
+    }
+
+    if (!free_slot) {
+        // Все слоты заняты: старейшую страницу в очередь раньше срока
+        if (!oldest || WbFlushPage(oldest, 1u) != HAL_OK) return NULL;
+        stats.evictions++;
+        free_slot = oldest;
+    }
+
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->used = 1;
+    free_slot->page = page;
+    free_slot->t_first = now;
+    return free_slot;
+}
+
+// Грязными становятся только байты, которые действительно изменились
+static void MirrorStage(uint16_t page, uint16_t off, const uint8_t *data, uint16_t n, uint32_t now) {
+    uint8_t *m = &mirror[(uint32_t)page * EEPROM_PAGE_SIZE];
+    uint64_t changed = 0;
+
+    for (uint16_t i = 0; i < n; i++) {
+        if (m[off + i] != data[i]) {
+            m[off + i] = data[i];
+            changed |= 1ull << (off + i);
+        }
+    }
+    stats.unchanged_bytes += n - (uint32_t)__builtin_popcountll(changed);
+    if (!changed) return;
+
+    if (!mirror_dirty[page]) mirror_t[page] = now;
+    mirror_dirty[page] |= changed;
+}
+
+HAL_StatusTypeDef EEPROM_Stage(uint16_t mem_addr, const uint8_t *data, uint16_t size) {
+    if (size == 0 || (uint32_t)mem_addr + size > EEPROM_SIZE) return HAL_ERROR;
+    uint32_t now = HAL_GetTick();
+
+    stats.staged++;
+    while (size > 0) {
+        uint16_t page = (uint16_t)(mem_addr / EEPROM_PAGE_SIZE);
+        uint16_t off = (uint16_t)(mem_addr % EEPROM_PAGE_SIZE);
+        uint16_t n = (uint16_t)(EEPROM_PAGE_SIZE - off);
+        if (n > size) n = size;
+
+        if (InMirror(mem_addr, n)) {
+            MirrorStage(page, off, data, n, now);
+        } else {
+            WbPage_t *p = WbSlot(page, now);
+            if (!p) return HAL_BUSY;
+
+            memcpy(&p->data[off], data, n);
+            p->dirty |= RunMask(off, n);
+            p->known |= RunMask(off, n);
+        }
+        stats.staged_bytes += n;
+
+        mem_addr = (uint16_t)(mem_addr + n);
+        data += n;
+        size = (uint16_t)(size - n);
+    }
+    return HAL_OK;
+}
+
+// Все грязные страницы в очередь; HAL_BUSY — очередь заполнилась раньше
+// или страница ещё дочитывается
+static HAL_StatusTypeDef FlushAll(void) {
+    HAL_StatusTypeDef st = HAL_OK;
+
+    for (uint32_t pg = 0; pg < MIRROR_PAGES; pg++) {
+        if (mirror_dirty[pg] && MirrorFlushPage(pg) != HAL_OK) return HAL_BUSY;
+    }
+    for (uint32_t i = 0; i < EEPROM_WB_PAGES; i++) {
+        if (!wb[i].used || WbFlushPage(&wb[i], 0u) == HAL_OK) continue;
+        if (!wb[i].filling) return HAL_BUSY;
+        st = HAL_BUSY;
+    }
+    return st;
+}
+
+HAL_StatusTypeDef EEPROM_Flush(void) {
+    wb_flush_req = 1;
+    if (FlushAll() != HAL_OK) return HAL_BUSY;
+    wb_flush_req = 0;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef BarrierEnqueue(void) {
+    if (FlushAll() != HAL_OK) return HAL_BUSY;
+
+    EepromReq_t r = {0};
+    r.op = OP_BARRIER;
+    r.fail_mark = barrier_mark;
+    r.cb = barrier_cb;
+    r.ctx = barrier_ctx;
+    return Enqueue(&r);
+}
+
+HAL_StatusTypeDef EEPROM_FlushBarrier(EEPROM_Callback_t cb, void *ctx) {
+    if (barrier_pending) return HAL_BUSY;
+
+    barrier_mark = write_failures;
+    barrier_cb = cb;
+    barrier_ctx = ctx;
+    if (BarrierEnqueue() != HAL_OK) {
+        barrier_pending = 1;   // очередь полна — дозапишем и поставим из EEPROM_Task
+    }
+    return HAL_OK;
+}
+
+static void WbTask(uint32_t now) {
+    if (barrier_pending) {
+        if (BarrierEnqueue() != HAL_OK) return;
+        barrier_pending = 0;
+    }
+
+    // Зеркало пишется, пока шина свободна; при долгой занятости — не позже MAX_DELAY
+    uint8_t bus_idle = QueueIdle();
+    for (uint32_t pg = 0; pg < MIRROR_PAGES; pg++) {
+        if (!mirror_dirty[pg]) continue;
+        uint32_t age = now - mirror_t[pg];
+        Deadline_At(mirror_t[pg] + (bus_idle ? EEPROM_WB_DELAY_MS : EEPROM_MIRROR_MAX_DELAY_MS));
+        if (wb_flush_req || (bus_idle && age >= EEPROM_WB_DELAY_MS) || age >= EEPROM_MIRROR_MAX_DELAY_MS) {
+            if (MirrorFlushPage(pg) != HAL_OK) return;
+        }
+    }
+
+    for (uint32_t i = 0; i < EEPROM_WB_PAGES; i++) {
+        WbPage_t *p = &wb[i];
+        if (!p->used) continue;
+        Deadline_At(p->t_first + EEPROM_WB_DELAY_MS);
+        if (wb_flush_req || (now - p->t_first) >= EEPROM_WB_DELAY_MS) {
+            if (WbFlushPage(p, 0u) == HAL_OK) continue;
+            if (p->filling) continue;               // запись — после чтения промежутков
+            return;                                 // очередь полна — в следующий раз
+        }
+    }
+    for (uint32_t i = 0; i < EEPROM_WB_PAGES; i++) {
+        if (wb[i].used) return;                     // дочитывается: EEPROM_Flush ещё не выполнен
+    }
+    wb_flush_req = 0;
+}
+
+void EEPROM_GetStats(EEPROM_Stats_t *out) {
+    *out = stats;
+}
+
+void EEPROM_ResetStats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+/* ---------- Очередь запросов ---------- */
+
+void EEPROM_Task(void) {
+    uint8_t evt = i2c_evt;
+    uint32_t now = HAL_GetTick();
+
+    WbTask(now);
+
+    switch (state) {
+    case ST_IDLE:
+        StartNext();
+        break;
+
+    case ST_DATA:
+        if (evt == EVT_NONE) break;
+        if (evt == EVT_ERROR) {
+            Complete(HAL_ERROR);
+        } else if (queue[q_tail].op == OP_READ) {
+            Complete(HAL_OK);
+        } else {
+            // Страница принята в буфер микросхемы, идёт внутренний цикл записи
+            cycle_start = now;
+            last_poll = now;
+            state = ST_POLL_WAIT;
+        }
+        break;
+
+    case ST_POLL_WAIT:
+        Deadline_At(last_poll + 1u);
+        if (now == last_poll) break;       // не чаще раза в миллисекунду
+        last_poll = now;
+        i2c_evt = EVT_NONE;
+        if (HAL_I2C_Master_Transmit_IT(&hi2c1, AT24C256_ADDR, &poll_dummy, 0) == HAL_OK) {
+            state = ST_POLLING;
+        } else if ((now - cycle_start) > EEPROM_WRITE_TIMEOUT_MS) {
+            Complete(HAL_TIMEOUT);
+        }
+        break;
+
+    case ST_POLLING:
+        if (evt == EVT_NONE) break;
+        if (evt == EVT_DONE) {
+            // ACK: цикл записи завершён
+            EepromReq_t *r = &queue[q_tail];
+            done = (uint16_t)(done + chunk);
+            if (done >= r->size) {
+                Complete(HAL_OK);
+            } else if (StartChunk(r) != HAL_OK) {
+                Complete(HAL_ERROR);
+            }
+        } else if ((now - cycle_start) > EEPROM_WRITE_TIMEOUT_MS) {
+            Complete(HAL_TIMEOUT);
+        } else {
+            state = ST_POLL_WAIT;          // NACK: ещё пишет
+        }
+        break;
+    }
+}
+
+uint8_t EEPROM_IsIdle(void) {
+    if (!QueueIdle() || barrier_pending) return 0;
+    for (uint32_t pg = 0; pg < MIRROR_PAGES; pg++) {
+        if (mirror_dirty[pg]) return 0;
+    }
+    for (uint32_t i = 0; i < EEPROM_WB_PAGES; i++) {
+        if (wb[i].used) return 0;
+    }
+    return 1;
+}
+
+void EEPROM_OnI2cDone(I2C_HandleTypeDef *hi2c) {
+    if (hi2c != &hi2c1) return;
+    i2c_evt = EVT_DONE;
+}
+
+void EEPROM_OnI2cError(I2C_HandleTypeDef *hi2c) {
+    if (hi2c != &hi2c1) return;
+    i2c_err = HAL_I2C_GetError(hi2c);
+    i2c_evt = EVT_ERROR;
+}
+
+HAL_StatusTypeDef EEPROM_WriteAsync(uint16_t mem_addr, const uint8_t *data, uint16_t size,
+                                    EEPROM_Callback_t cb, void *ctx) {
+    if (size == 0 || size > EEPROM_MAX_WRITE || (uint32_t)mem_addr + size > EEPROM_SIZE) return HAL_ERROR;
+
+    EepromReq_t r = {0};
+    r.op = OP_WRITE;
+    r.addr = mem_addr;
+    r.size = size;
+    memcpy(r.buf, data, size);
+    r.cb = cb;
+    r.ctx = ctx;
+    return Enqueue(&r);
+}
+
+HAL_StatusTypeDef EEPROM_ReadAsync(uint16_t mem_addr, uint8_t *data, uint16_t size,
+                                   EEPROM_Callback_t cb, void *ctx) {
+    if (size == 0 || (uint32_t)mem_addr + size > EEPROM_SIZE) return HAL_ERROR;
+
+    EepromReq_t r = {0};
+    r.op = OP_READ;
+    r.addr = mem_addr;
+    r.size = size;
+    r.dst = data;
+    r.cb = cb;
+    r.ctx = ctx;
+    return Enqueue(&r);
+}
+
+static void MirrorLoaded(HAL_StatusTypeDef status, void *ctx) {
+    (void)ctx;
+    mirror_valid = (status == HAL_OK) ? 1u : 0u;
+    if (status != HAL_OK) {
+        UsbLog_Printf("EEPROM: mirror load failed (%d), reads go to the bus\r\n", (int)status);
+    }
+    if (mirror_cb) mirror_cb(status, mirror_cb_ctx);
+}
+
+HAL_StatusTypeDef EEPROM_InitAsync(EEPROM_Callback_t cb, void *ctx) {
+    q_head = q_tail = q_count = 0;
+    state = ST_IDLE;
+    i2c_evt = EVT_NONE;
+    memset(wb, 0, sizeof(wb));
+    wb_flush_req = 0;
+    barrier_pending = 0;
+    memset(mirror_dirty, 0, sizeof(mirror_dirty));
+    mirror_valid = 0;
+    mirror_cb = cb;
+    mirror_cb_ctx = ctx;
+
+    // Одно последовательное чтение всей используемой области
+    return EEPROM_ReadAsync(0, mirror, EEPROM_MIRROR_SIZE, MirrorLoaded, NULL);
+}
+
+// По страницам, как StartChunk: запись через границу страницы завернулась бы
+// на её начало. После каждой порции — ожидание конца цикла записи
 HAL_StatusTypeDef EEPROM_Write(uint16_t mem_addr, uint8_t *data, uint16_t size) {
-    HAL_StatusTypeDef status = HAL_I2C_Mem_Write(&hi2c1, AT24C256_ADDR, mem_addr, I2C_MEMADD_SIZE_16BIT, data, size, 100);
-    if (status == HAL_OK) {
-        HAL_Delay(5); // Typical write cycle time for AT24C
+    if (size == 0 || (uint32_t)mem_addr + size > EEPROM_SIZE) return HAL_ERROR;
+    if (!EEPROM_IsIdle()) return HAL_BUSY;
+
+    HAL_StatusTypeDef status = HAL_OK;
+    uint16_t pos = 0;
+
+    while (pos < size && status == HAL_OK) {
+        uint16_t addr = (uint16_t)(mem_addr + pos);
+        uint16_t room = (uint16_t)(EEPROM_PAGE_SIZE - (addr % EEPROM_PAGE_SIZE));
+        uint16_t n = (uint16_t)(size - pos);
+        if (n > room) n = room;
+
+        status = HAL_I2C_Mem_Write(&hi2c1, AT24C256_ADDR, addr, I2C_MEMADD_SIZE_16BIT, &data[pos], n, 100);
+        if (status == HAL_OK) {
+            status = HAL_I2C_IsDeviceReady(&hi2c1, AT24C256_ADDR, EEPROM_WRITE_TIMEOUT_MS, EEPROM_WRITE_TIMEOUT_MS);
+        }
+        if (status == HAL_OK && InMirror(addr, n)) {
+            memcpy(&mirror[addr], &data[pos], n);
+        }
+        pos = (uint16_t)(pos + n);
     }
     return status;
 }
 
 HAL_StatusTypeDef EEPROM_Read(uint16_t mem_addr, uint8_t *data, uint16_t size) {
-    return HAL_I2C_Mem_Read(&hi2c1, AT24C256_ADDR, mem_addr, I2C_MEMADD_SIZE_16BIT, data, size, 100);
+    if (InMirror(mem_addr, size)) {
+        memcpy(data, &mirror[mem_addr], size);
+        stats.mirror_hits++;
+        return HAL_OK;
+    }
+    if (!QueueIdle()) return HAL_BUSY;
+    HAL_StatusTypeDef status = HAL_I2C_Mem_Read(&hi2c1, AT24C256_ADDR, mem_addr, I2C_MEMADD_SIZE_16BIT, data, size, 100);
+    if (status == HAL_OK) {
+        WbOverlay(mem_addr, data, size);
+    }
+    return status;
 }
 
 HAL_StatusTypeDef EEPROM_SavePrice(uint32_t price) {
-    uint8_t buf[4];
-    buf[0] = (price >> 24) & 0xFF;
-    buf[1] = (price >> 16) & 0xFF;
-    buf[2] = (price >> 8) & 0xFF;
-    buf[3] = price & 0xFF;
-    return EEPROM_Write(EEPROM_PRICE_ADDR, buf, 4);
+    return EEPROM_SavePriceToAddr(EEPROM_PRICE_ADDR, price);
 }
 
 uint32_t EEPROM_LoadPrice(void) {
@@ -36,7 +656,7 @@ HAL_StatusTypeDef EEPROM_SavePriceToAddr(uint16_t addr, uint32_t price) {
     buf[1] = (price >> 16) & 0xFF;
     buf[2] = (price >> 8) & 0xFF;
     buf[3] = price & 0xFF;
-    return EEPROM_Write(addr, buf, 4);
+    return EEPROM_Stage(addr, buf, 4);
 }
 
 uint32_t EEPROM_LoadPriceFromAddr(uint16_t addr) {
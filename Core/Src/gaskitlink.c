@@ -1,6 +1,7 @@
 #include "gaskitlink.h"
+#include "mem_layout.h"
 
-uint8_t Gas_CalculateCRC(const uint8_t *data, uint16_t len) {
+ITCM_CODE uint8_t Gas_CalculateCRC(const uint8_t *data, uint16_t len) {
     uint8_t crc = 0;
     for (uint16_t i = 0; i < len; i++) {
         crc ^= data[i];
@@ -8,7 +9,7 @@ uint8_t Gas_CalculateCRC(const uint8_t *data, uint16_t len) {
     return crc;
 }
 
-uint16_t Gas_BuildFrame(uint8_t *buffer, uint8_t addr_high, uint8_t addr_low, char cmd, const char *data) {
+ITCM_CODE uint16_t Gas_BuildFrame(uint8_t *buffer, uint8_t addr_high, uint8_t addr_low, char cmd, const char *data) {
     uint16_t pos = 0;
     buffer[pos++] = GAS_STX;
     buffer[pos++] = addr_high;
@@ -28,7 +29,7 @@ uint16_t Gas_BuildFrame(uint8_t *buffer, uint8_t addr_high, uint8_t addr_low, ch
     return pos;
 }
 
-int Gas_ParseFrame(const uint8_t *buffer, uint16_t len, GasFrame_t *frame) {
+ITCM_CODE int Gas_ParseFrame(const uint8_t *buffer, uint16_t len, GasFrame_t *frame) {
     if (len < 5) return -1; // Too short
     if (buffer[0] != GAS_STX) return -2; // No STX
     
@@ -77,10 +77,14 @@ void MX_GPIO_Init(void)
 
   /*Configure GPIO pins : KeyCol_1_Pin KeyCol_2_Pin KeyCol_3_Pin KeyCol_4_Pin */
   GPIO_InitStruct.Pin = KeyCol_1_Pin|KeyCol_2_Pin|KeyCol_3_Pin|KeyCol_4_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
   GPIO_InitStruct.Pull = GPIO_PULLUP;
   HAL_GPIO_Init(GPIOE, &GPIO_InitStruct);
 
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI15_10_IRQn, 10, 0);
+  HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+
 }
 
 /* USER CODE BEGIN 2 */
@@ -1,4 +1,9 @@
 #include "keyboard.h"
+#include "tim.h"
+#include "mem_layout.h"
+#include <string.h>
+
+#define KEY_COUNT (KEY_ROWS * KEY_COLS)
 
 static const char key_map[KEY_ROWS][KEY_COLS] = {
     {'H', 'G', 'F', 'A'},
@@ -24,49 +29,455 @@ static uint16_t col_pins[KEY_COLS] = {
     KeyCol_1_Pin, KeyCol_2_Pin, KeyCol_3_Pin, KeyCol_4_Pin
 };
 
-static char last_key = 0;
-static uint32_t last_scan_time = 0;
+// Состояние клавиши (только ISR)
+typedef struct {
+    uint8_t integ;      // 0..KEY_DEBOUNCE_SCANS
+    uint8_t pressed;    // подтверждённое состояние
+    uint8_t long_sent;
+    uint16_t held_ms;
+    uint16_t next_repeat_ms;
+} KeyState_t;
 
-void Keyboard_Init(void) {
+static KeyState_t keys[KEY_COUNT];
+static uint8_t scan_row = 0;
+
+// Очередь событий: head пишет только сканер (ISR или ScanDma_Poll), tail — только main loop
+static Keyboard_Event_t queue[KEY_QUEUE_SIZE];
+static volatile uint8_t q_head = 0;
+static volatile uint8_t q_tail = 0;
+static volatile uint32_t q_dropped = 0;
+
+static volatile uint16_t repeat_delay_ms = KEY_REPEAT_DELAY_MS;
+static volatile uint16_t repeat_rate_ms = KEY_REPEAT_RATE_MS;
+
+static void PushEvent(char key, Keyboard_EventType_t type) {
+    uint8_t head = q_head;
+    uint8_t next = (uint8_t)((head + 1u) & (KEY_QUEUE_SIZE - 1u));
+    if (next == q_tail) {
+        q_dropped++;
+        return;
+    }
+    queue[head].key = key;
+    queue[head].type = (uint8_t)type;
+    __DMB();  // событие записано раньше, чем его увидит читатель
+    q_head = next;
+}
+
+static uint8_t IsRepeatKey(char key) {
+    return (key != 0 && strchr(KEY_REPEAT_KEYS, key) != NULL) ? 1u : 0u;
+}
+
+// Подтверждённое нажатие / отпускание (после антидребезга)
+static void KeyDown(uint8_t idx) {
+    KeyState_t* k = &keys[idx];
+    k->pressed = 1;
+    k->long_sent = 0;
+    k->held_ms = 0;
+    k->next_repeat_ms = repeat_delay_ms;
+    PushEvent(key_map[idx / KEY_COLS][idx % KEY_COLS], KEY_EV_PRESS);
+}
+
+static void KeyUp(uint8_t idx) {
+    keys[idx].pressed = 0;
+    PushEvent(key_map[idx / KEY_COLS][idx % KEY_COLS], KEY_EV_RELEASE);
+}
+
+// Раз в проход матрицы, пока клавиша нажата: длинное нажатие и автоповтор
+static void KeyHeld(uint8_t idx) {
+    KeyState_t* k = &keys[idx];
+    char key = key_map[idx / KEY_COLS][idx % KEY_COLS];
+
+    if (k->held_ms < 0xFFFFu - KEY_SCAN_PERIOD_MS) k->held_ms += KEY_SCAN_PERIOD_MS;
+
+    if (!k->long_sent && k->held_ms >= KEY_LONGPRESS_MS) {
+        k->long_sent = 1;
+        PushEvent(key, KEY_EV_LONG);
+    }
+
+    uint16_t delay = repeat_delay_ms;
+    if (delay != 0 && IsRepeatKey(key) && k->held_ms >= k->next_repeat_ms) {
+        k->next_repeat_ms = (uint16_t)(k->held_ms + repeat_rate_ms);
+        PushEvent(key, KEY_EV_REPEAT);
+    }
+}
+
+// Один опрос клавиши (режим ISR): sample = 1 если контакт замкнут
+static void UpdateKey(uint8_t idx, uint8_t sample) {
+    KeyState_t* k = &keys[idx];
+
+    if (sample) {
+        if (k->integ < KEY_DEBOUNCE_SCANS) k->integ++;
+    } else {
+        if (k->integ > 0) k->integ--;
+    }
+
+    if (!k->pressed && k->integ == KEY_DEBOUNCE_SCANS) {
+        KeyDown(idx);
+    } else if (k->pressed && k->integ == 0) {
+        KeyUp(idx);
+    } else if (k->pressed) {
+        KeyHeld(idx);
+    }
+}
+
+// Ожидание нажатия: все строки low, столбцы — EXTI по спаду, сканер остановлен
+#define KEY_IDLE_PASSES ((KEY_IDLE_MS + KEY_SCAN_PERIOD_MS - 1u) / KEY_SCAN_PERIOD_MS)
+
+static volatile uint8_t scan_idle = 0;
+static uint8_t exti_ready = 0;
+static uint16_t quiet_passes = 0;
+static uint32_t col_exti_mask = 0;   // линии EXTI столбцов (номер линии = номер пина)
+
+static void EnterIdle(void);
+
+#if KEYBOARD_SCAN_DMA
+// ============================================================================
+// Режим DMA: TIM3 UP/CC2 пишут шаблоны строк в BSRR, CC1 в середине периода
+// снимает IDR столбцов. CPU только разбирает готовые проходы.
+// ============================================================================
+#define KB_DMA_PASSES   16u                          // проходов в кольце (80 мс)
+#define KB_SNAP_LEN     (KB_DMA_PASSES * KEY_ROWS)   // 80 halfword = 160 байт
+
+static DMA_HandleTypeDef hdma_kb_row_a;   // порт строк A, запрос TIM3_UP
+static DMA_HandleTypeDef hdma_kb_row_b;   // порт строк B (если строки на двух портах), TIM3_CH2
+static DMA_HandleTypeDef hdma_kb_cols;    // IDR столбцов, TIM3_CH1
+
+// Некэшируемая D2 SRAM (mem_layout.h): обслуживание кэша не нужно
+static uint32_t row_bsrr_a[KEY_ROWS] DMA_BUFFER;
+static uint32_t row_bsrr_b[KEY_ROWS] DMA_BUFFER;
+static uint16_t col_snap[KB_SNAP_LEN] DMA_BUFFER;
+
+static GPIO_TypeDef* row_port_a;
+static GPIO_TypeDef* row_port_b;
+static uint8_t dma_active = 0;
+static uint16_t snap_rd = 0;
+static uint32_t snap_ms = 0;              // HAL_GetTick() прошлого разбора
+static uint32_t snap_overruns = 0;
+
+// Вертикальные счётчики: бит N = клавиша N (r * KEY_COLS + c), 4 одинаковых прохода до смены
+static uint32_t vc0 = 0, vc1 = 0, deb_state = 0;
+
+// BSRR для порта port, чтобы активной (low) была строка r
+static uint32_t RowPattern(GPIO_TypeDef* port, uint8_t r) {
+    uint32_t v = 0;
     for (uint8_t i = 0; i < KEY_ROWS; i++) {
-        HAL_GPIO_WritePin(row_ports[i], row_pins[i], GPIO_PIN_SET);
+        if (row_ports[i] != port) continue;
+        v |= (i == r) ? ((uint32_t)row_pins[i] << 16) : row_pins[i];
     }
+    return v;
 }
 
-char Keyboard_Scan(void) {
-    for (uint8_t r = 0; r < KEY_ROWS; r++) {
-        HAL_GPIO_WritePin(row_ports[r], row_pins[r], GPIO_PIN_RESET);
-        
-        for(volatile int i=0; i<50; i++);
+static HAL_StatusTypeDef InitStream(DMA_HandleTypeDef* h, DMA_Stream_TypeDef* inst, uint32_t request, uint32_t dir,
+                                    uint32_t palign, uint32_t malign) {
+    h->Instance = inst;
+    h->Init.Request = request;
+    h->Init.Direction = dir;
+    h->Init.PeriphInc = DMA_PINC_DISABLE;
+    h->Init.MemInc = DMA_MINC_ENABLE;
+    h->Init.PeriphDataAlignment = palign;
+    h->Init.MemDataAlignment = malign;
+    h->Init.Mode = DMA_CIRCULAR;
+    h->Init.Priority = DMA_PRIORITY_LOW;
+    h->Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    return HAL_DMA_Init(h);
+}
+
+// Возвращает 0, если разводка не подходит (столбцы не на одном порту, строки больше чем на двух)
+static uint8_t ScanDma_Setup(void) {
+    GPIO_TypeDef* col_port = col_ports[0];
+    for (uint8_t c = 1; c < KEY_COLS; c++) {
+        if (col_ports[c] != col_port) return 0;
+    }
 
+    row_port_a = row_ports[0];
+    row_port_b = NULL;
+    for (uint8_t r = 1; r < KEY_ROWS; r++) {
+        if (row_ports[r] == row_port_a || row_ports[r] == row_port_b) continue;
+        if (row_port_b != NULL) return 0;
+        row_port_b = row_ports[r];
+    }
+
+    // Строка 0 выставлена заранее: первым придёт CC1 (середина периода) и снимет её,
+    // затем UP запишет строку 1 — поэтому таблица сдвинута на одну строку
+    for (uint8_t k = 0; k < KEY_ROWS; k++) {
+        uint8_t r = (uint8_t)((k + 1u) % KEY_ROWS);
+        row_bsrr_a[k] = RowPattern(row_port_a, r);
+        row_bsrr_b[k] = row_port_b ? RowPattern(row_port_b, r) : 0;
+    }
+
+    if (InitStream(&hdma_kb_row_a, DMA1_Stream4, DMA_REQUEST_TIM3_UP, DMA_MEMORY_TO_PERIPH,
+                   DMA_PDATAALIGN_WORD, DMA_MDATAALIGN_WORD) != HAL_OK ||
+        InitStream(&hdma_kb_cols, DMA1_Stream6, DMA_REQUEST_TIM3_CH1, DMA_PERIPH_TO_MEMORY,
+                   DMA_PDATAALIGN_HALFWORD, DMA_MDATAALIGN_HALFWORD) != HAL_OK) {
+        return 0;
+    }
+    if (row_port_b != NULL &&
+        InitStream(&hdma_kb_row_b, DMA1_Stream7, DMA_REQUEST_TIM3_CH2, DMA_MEMORY_TO_PERIPH,
+                   DMA_PDATAALIGN_WORD, DMA_MDATAALIGN_WORD) != HAL_OK) {
+        return 0;
+    }
+
+    // CC1 — снимок столбцов в середине периода, CC2 — одновременно с UP
+    TIM_OC_InitTypeDef oc = {0};
+    oc.OCMode = TIM_OCMODE_TIMING;
+    oc.Pulse = (htim3.Init.Period + 1u) / 2u;
+    HAL_TIM_OC_ConfigChannel(&htim3, &oc, TIM_CHANNEL_1);
+    oc.Pulse = 0;
+    HAL_TIM_OC_ConfigChannel(&htim3, &oc, TIM_CHANNEL_2);
+    return 1;
+}
+
+// Строка 0 уже выставлена вызывающим
+static void ScanDma_Run(void) {
+    memset(col_snap, 0xFF, sizeof(col_snap));
+    snap_rd = 0;
+    snap_ms = HAL_GetTick();
+    vc0 = vc1 = deb_state = 0;
+
+    HAL_DMA_Start(&hdma_kb_row_a, (uint32_t)row_bsrr_a, (uint32_t)&row_port_a->BSRR, KEY_ROWS);
+    if (row_port_b != NULL) {
+        HAL_DMA_Start(&hdma_kb_row_b, (uint32_t)row_bsrr_b, (uint32_t)&row_port_b->BSRR, KEY_ROWS);
+    }
+    HAL_DMA_Start(&hdma_kb_cols, (uint32_t)&col_ports[0]->IDR, (uint32_t)col_snap, KB_SNAP_LEN);
+
+    __HAL_TIM_SET_COUNTER(&htim3, 0);
+    __HAL_TIM_ENABLE_DMA(&htim3, TIM_DMA_UPDATE | TIM_DMA_CC1 | (row_port_b ? TIM_DMA_CC2 : 0u));
+    HAL_TIM_Base_Start(&htim3);  // без прерываний
+}
+
+static void ScanDma_Stop(void) {
+    HAL_TIM_Base_Stop(&htim3);
+    __HAL_TIM_DISABLE_DMA(&htim3, TIM_DMA_UPDATE | TIM_DMA_CC1 | TIM_DMA_CC2);
+    HAL_DMA_Abort(&hdma_kb_row_a);
+    if (row_port_b != NULL) HAL_DMA_Abort(&hdma_kb_row_b);
+    HAL_DMA_Abort(&hdma_kb_cols);
+}
+
+// Пять снимков IDR одного прохода -> слово "нажато" по клавишам
+static uint32_t PackPass(const uint16_t* snap) {
+    uint32_t word = 0;
+    for (uint8_t r = 0; r < KEY_ROWS; r++) {
+        uint16_t idr = snap[r];
         for (uint8_t c = 0; c < KEY_COLS; c++) {
-            if (HAL_GPIO_ReadPin(col_ports[c], col_pins[c]) == GPIO_PIN_RESET) {
-                HAL_GPIO_WritePin(row_ports[r], row_pins[r], GPIO_PIN_SET);
-                return key_map[r][c];
+            if ((idr & col_pins[c]) == 0) word |= 1u << (r * KEY_COLS + c);
+        }
+    }
+    return word;
+}
+
+// Разбор готовых проходов (main loop). Пока всё отпущено и не менялось — только сравнение.
+static void ScanDma_Poll(void) {
+    if (scan_idle) return;
+
+    uint16_t wr = (uint16_t)(KB_SNAP_LEN - __HAL_DMA_GET_COUNTER(&hdma_kb_cols));
+    wr = (uint16_t)(wr - (wr % KEY_ROWS));   // только завершённые проходы
+    if (wr >= KB_SNAP_LEN) wr = 0;
+
+    // По NDTR обгон кольца не виден: разбор стоял почти KB_DMA_PASSES проходов —
+    // берём последние KB_DMA_PASSES - 1 целых проходов, старые уже затёрты
+    uint32_t now = HAL_GetTick();
+    if ((now - snap_ms) >= (KB_DMA_PASSES - 1u) * KEY_SCAN_PERIOD_MS) {
+        snap_rd = (uint16_t)((wr + KEY_ROWS) % KB_SNAP_LEN);
+        snap_overruns++;
+    }
+    snap_ms = now;
+
+    if (wr == snap_rd) return;
+
+    while (snap_rd != wr) {
+        uint32_t sample = PackPass(&col_snap[snap_rd]);
+        snap_rd = (uint16_t)((snap_rd + KEY_ROWS) % KB_SNAP_LEN);
+
+        uint32_t delta = sample ^ deb_state;
+        vc1 = (vc1 ^ vc0) & delta;
+        vc0 = ~vc0 & delta;
+        uint32_t toggle = delta & ~(vc0 | vc1);
+        deb_state ^= toggle;
+
+        uint32_t held = deb_state & ~toggle;
+        if ((toggle | held) == 0) {
+            // Всё отпущено и дребезг улёгся: после паузы — обратно в ожидание EXTI
+            if ((sample | vc0 | vc1) == 0 && ++quiet_passes >= KEY_IDLE_PASSES) {
+                EnterIdle();
+                return;
+            }
+            continue;
+        }
+        quiet_passes = 0;
+
+        for (uint8_t i = 0; i < KEY_COUNT; i++) {
+            uint32_t bit = 1u << i;
+            if (toggle & bit) {
+                if (deb_state & bit) KeyDown(i);
+                else KeyUp(i);
+            } else if (held & bit) {
+                KeyHeld(i);
             }
         }
-        HAL_GPIO_WritePin(row_ports[r], row_pins[r], GPIO_PIN_SET);
+    }
+}
+#endif /* KEYBOARD_SCAN_DMA */
+
+// Строки в режим сканирования (активна строка 0) и запуск сканера
+static void Scan_Run(void) {
+    for (uint8_t i = 1; i < KEY_ROWS; i++) {
+        HAL_GPIO_WritePin(row_ports[i], row_pins[i], GPIO_PIN_SET);
+    }
+    HAL_GPIO_WritePin(row_ports[0], row_pins[0], GPIO_PIN_RESET);
+    scan_row = 0;
+    quiet_passes = 0;
+
+#if KEYBOARD_SCAN_DMA
+    if (dma_active) {
+        ScanDma_Run();
+        return;
+    }
+#endif
+    __HAL_TIM_SET_COUNTER(&htim3, 0);
+    HAL_TIM_Base_Start_IT(&htim3);
+}
+
+static void Scan_Stop(void) {
+#if KEYBOARD_SCAN_DMA
+    if (dma_active) {
+        ScanDma_Stop();
+        return;
+    }
+#endif
+    HAL_TIM_Base_Stop_IT(&htim3);
+}
+
+static uint8_t ColsActive(void) {
+    for (uint8_t c = 0; c < KEY_COLS; c++) {
+        if (HAL_GPIO_ReadPin(col_ports[c], col_pins[c]) == GPIO_PIN_RESET) return 1;
     }
     return 0;
 }
 
+// Из режима ожидания в сканирование; вызывается при запрещённых прерываниях или из EXTI
+static void Wake(void) {
+    CLEAR_BIT(EXTI_D1->IMR1, col_exti_mask);
+    if (!scan_idle) return;
+    scan_idle = 0;
+    Scan_Run();
+}
+
+static void EnterIdle(void) {
+    Scan_Stop();
+
+    // Любая нажатая клавиша теперь тянет свой столбец вниз
+    for (uint8_t i = 0; i < KEY_ROWS; i++) {
+        HAL_GPIO_WritePin(row_ports[i], row_pins[i], GPIO_PIN_RESET);
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    WRITE_REG(EXTI_D1->PR1, col_exti_mask);
+    scan_idle = 1;
+    SET_BIT(EXTI_D1->IMR1, col_exti_mask);
+    // Нажатие между последним проходом и включением EXTI фронта уже не даст
+    if (ColsActive()) Wake();
+    __set_PRIMASK(primask);
+}
+
+void Keyboard_Init(void) {
+    memset(keys, 0, sizeof(keys));
+    q_head = q_tail = 0;
+    q_dropped = 0;
+
+    col_exti_mask = 0;
+    for (uint8_t c = 0; c < KEY_COLS; c++) col_exti_mask |= col_pins[c];
+    CLEAR_BIT(EXTI_D1->IMR1, col_exti_mask);
+
+#if KEYBOARD_SCAN_DMA
+    dma_active = ScanDma_Setup();
+#endif
+
+    scan_idle = 0;
+    exti_ready = 1;
+    EnterIdle();
+}
+
+void Keyboard_OnExti(uint16_t pin) {
+    if ((pin & col_exti_mask) == 0) return;
+    if (!exti_ready) {
+        CLEAR_BIT(EXTI_D1->IMR1, col_exti_mask);  // до Keyboard_Init()
+        return;
+    }
+    Wake();
+}
+
+bool Keyboard_IsIdle(void) {
+    return scan_idle != 0;
+}
+
+void Keyboard_OnTick(void) {
+    if (scan_idle) return;
+
+    uint8_t r = scan_row;
+
+    // Строка r выставлена на прошлом тике и уже установилась
+    for (uint8_t c = 0; c < KEY_COLS; c++) {
+        uint8_t down = (HAL_GPIO_ReadPin(col_ports[c], col_pins[c]) == GPIO_PIN_RESET) ? 1u : 0u;
+        UpdateKey((uint8_t)(r * KEY_COLS + c), down);
+    }
+
+    HAL_GPIO_WritePin(row_ports[r], row_pins[r], GPIO_PIN_SET);
+    r = (uint8_t)((r + 1u) % KEY_ROWS);
+    HAL_GPIO_WritePin(row_ports[r], row_pins[r], GPIO_PIN_RESET);
+    scan_row = r;
+
+    if (r != 0) return;
+
+    // Конец прохода: всё отпущено и интеграторы на нуле -> считаем паузу
+    uint8_t quiet = 1;
+    for (uint8_t i = 0; i < KEY_COUNT; i++) {
+        if (keys[i].pressed || keys[i].integ) { quiet = 0; break; }
+    }
+    if (!quiet) {
+        quiet_passes = 0;
+    } else if (++quiet_passes >= KEY_IDLE_PASSES) {
+        EnterIdle();
+    }
+}
+
+bool Keyboard_GetEvent(Keyboard_Event_t *ev) {
+#if KEYBOARD_SCAN_DMA
+    if (dma_active) ScanDma_Poll();
+#endif
+
+    uint8_t tail = q_tail;
+    if (tail == q_head) return false;
+
+    __DMB();
+    *ev = queue[tail];
+    q_tail = (uint8_t)((tail + 1u) & (KEY_QUEUE_SIZE - 1u));
+    return true;
+}
+
 char Keyboard_GetKey(void) {
-    uint32_t now = HAL_GetTick();
-    
-    // ИСПРАВЛЕНИЕ #5: Убрана избыточная проверка переполнения
-    // Unsigned arithmetic автоматически обрабатывает wrap-around
-    if ((now - last_scan_time) >= 50) {
-        last_scan_time = now;
-        
-        char current_key = Keyboard_Scan();
-        
-        if (current_key != last_key) {
-            last_key = current_key;
-            if (current_key != 0) {
-                return current_key;
-            }
+    Keyboard_Event_t ev;
+    while (Keyboard_GetEvent(&ev)) {
+        if (ev.type == KEY_EV_PRESS || ev.type == KEY_EV_REPEAT) {
+            return ev.key;
         }
     }
-    
     return 0;
 }
+
+void Keyboard_SetAutoRepeat(uint16_t delay_ms, uint16_t rate_ms) {
+    repeat_rate_ms = (rate_ms < KEY_SCAN_PERIOD_MS) ? KEY_SCAN_PERIOD_MS : rate_ms;
+    repeat_delay_ms = delay_ms;
+}
+
+uint32_t Keyboard_GetDropped(void) {
+    return q_dropped;
+}
+
+uint32_t Keyboard_GetOverruns(void) {
+#if KEYBOARD_SCAN_DMA
+    return snap_overruns;
+#else
+    return 0;
+#endif
+}
@@ -29,13 +29,10 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "ssd1309.h"
-#include "ui_manager.h"
-#include "dispenser.h"
-#include <stdint.h>
-#include <string.h>
-#include <stdarg.h>
-#include <stdio.h>
-#include "usbd_cdc_if.h"
+#include "keyboard.h"
+#include "eeprom_at24.h"
+#include "dwt_cycles.h"
+#include "app_tasks.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -63,16 +60,6 @@
 
 /* USER CODE BEGIN PV */
 
-/* OLED */
-SSD1309_t oled;
-
-/* USB log ring buffer */
-#define USBLOG_RING_SZ        (2048u)
-#define USBLOG_CHUNK_SZ       (64u)
-static uint8_t usblog_ring[USBLOG_RING_SZ];
-static volatile uint16_t usblog_wr = 0;
-static volatile uint16_t usblog_rd = 0;
-
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -80,60 +67,11 @@ void SystemClock_Config(void);
 static void MPU_Config(void);
 /* USER CODE BEGIN PFP */
 
-static void UsbLog_Push(const uint8_t *data, uint16_t len);
-void UsbLog_Printf(const char *fmt, ...);
-static void UsbLog_Task(void);
-
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-/* ====== USB CDC logger (non-blocking) ====== */
-static void UsbLog_Push(const uint8_t *data, uint16_t len)
-{
-  for (uint16_t i = 0; i < len; i++) {
-    uint16_t next = (uint16_t)((usblog_wr + 1u) % USBLOG_RING_SZ);
-    if (next == usblog_rd) {
-      usblog_rd = (uint16_t)((usblog_rd + 1u) % USBLOG_RING_SZ);
-    }
-    usblog_ring[usblog_wr] = data[i];
-    usblog_wr = next;
-  }
-}
-
-void UsbLog_Printf(const char *fmt, ...)
-{
-  char tmp[256];
-  va_list ap;
-  va_start(ap, fmt);
-  int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
-  va_end(ap);
-
-  if (n <= 0) return;
-  if ((size_t)n > sizeof(tmp)) n = (int)sizeof(tmp);
-  UsbLog_Push((const uint8_t*)tmp, (uint16_t)n);
-}
-
-static void UsbLog_Task(void)
-{
-  if (usblog_rd == usblog_wr) return;
-
-  uint8_t  chunk[USBLOG_CHUNK_SZ];
-  uint16_t rd_snapshot = usblog_rd;
-  uint16_t cnt = 0;
-
-  while ((usblog_rd != usblog_wr) && (cnt < USBLOG_CHUNK_SZ)) {
-    chunk[cnt++] = usblog_ring[usblog_rd];
-    usblog_rd = (uint16_t)((usblog_rd + 1u) % USBLOG_RING_SZ);
-  }
-
-  uint8_t res = CDC_Transmit_FS(chunk, cnt);
-  if (res != 0) { // USBD_OK is 0
-    usblog_rd = rd_snapshot;
-  }
-}
-
 /* USER CODE END 0 */
 
 /**
@@ -150,6 +88,12 @@ int main(void)
   /* MPU Configuration--------------------------------------------------------*/
   MPU_Config();
 
+  /* Enable I-Cache---------------------------------------------------------*/
+  SCB_EnableICache();
+
+  /* Enable D-Cache---------------------------------------------------------*/
+  SCB_EnableDCache();
+
   /* MCU Configuration--------------------------------------------------------*/
 
   /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
@@ -163,6 +107,7 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
+  DWT_CyclesInit();
 
   /* USER CODE END SysInit */
 
@@ -178,23 +123,9 @@ int main(void)
   MX_USART3_UART_Init();
   /* USER CODE BEGIN 2 */
 
-  /* OLED init */
-  SSD1309_Config_t cfg = {
-    .hspi = &hspi2,
-    .cs_port  = SPI2_CS_GPIO_Port,  .cs_pin  = SPI2_CS_Pin,
-    .dc_port  = SPI2_DC_GPIO_Port,  .dc_pin  = SPI2_DC_Pin,
-    .rst_port = SPI2_RST_GPIO_Port, .rst_pin = SPI2_RST_Pin,
-    .col_offset = 2u,
-    .invert = 0u
-  };
-
-  SSD1309_Init(&oled, &cfg);
-  SSD1309_BeginAsync(&oled);
-
-  HAL_Delay(1000); // More delay for USB
-  UsbLog_Printf("=== System Started ===\r\n");
-
-  UI_Init();
+  /* Дисплеи и задачи main loop (app_tasks.c); опрос ведомых — сразу,
+     EEPROM, дисплей и USB поднимаются параллельно из main loop */
+  AppTasks_Init();
 
   /* USER CODE END 2 */
 
@@ -202,23 +133,8 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-    /* Dispenser polling and UART handling - MUST BE CALLED EVERY LOOP */
-    Dispenser_Update();
-    
-    /* OLED driver task */
-    SSD1309_Task(&oled);
-    
-    /* USB logger task */
-    UsbLog_Task();
-    
-    /* Process keyboard input - ALWAYS, regardless of display state */
-    UI_ProcessInput();
-    
-    /* Update display only when ready */
-    if (SSD1309_IsReady(&oled)) {
-      UI_Draw();
-    }
-    
+    AppTasks_Run();
+
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -291,18 +207,51 @@ void SystemClock_Config(void)
 void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
 {
   if (hspi == &hspi2) {
-    SSD1309_OnSpiTxCplt(&oled, hspi);
+    SSD1309_Bus_OnSpiTxCplt(&oled_bus, hspi);
   }
 }
 
 void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
 {
   if (hspi == &hspi2) {
-    SSD1309_OnSpiError(&oled, hspi);
+    SSD1309_Bus_OnSpiError(&oled_bus, hspi);
   }
 }
 #endif
 
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  if (htim == &htim3) {
+    Keyboard_OnTick();
+  }
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  Keyboard_OnExti(GPIO_Pin);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  EEPROM_OnI2cDone(hi2c);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  EEPROM_OnI2cDone(hi2c);
+}
+
+/* Опрос ACK после цикла записи: передача адреса без данных */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  EEPROM_OnI2cDone(hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  EEPROM_OnI2cError(hi2c);
+}
+
 /* USER CODE END 4 */
 
  /* MPU Configuration */
@@ -328,6 +277,18 @@ void MPU_Config(void)
   MPU_InitStruct.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
   MPU_InitStruct.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
 
+  HAL_MPU_ConfigRegion(&MPU_InitStruct);
+
+  /** Initializes and configures the Region and the memory to be protected
+  */
+  MPU_InitStruct.Number = MPU_REGION_NUMBER1;
+  MPU_InitStruct.BaseAddress = 0x30000000;
+  MPU_InitStruct.Size = MPU_REGION_SIZE_32KB;
+  MPU_InitStruct.SubRegionDisable = 0x0;
+  MPU_InitStruct.TypeExtField = MPU_TEX_LEVEL1;
+  MPU_InitStruct.AccessPermission = MPU_REGION_FULL_ACCESS;
+  MPU_InitStruct.IsShareable = MPU_ACCESS_NOT_SHAREABLE;
+
   HAL_MPU_ConfigRegion(&MPU_InitStruct);
   /* Enables the MPU */
   HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
@@ -0,0 +1,126 @@
+#include "prof.h"
+#include "usb_log.h"
+#include "mem_layout.h"
+#include "dwt_cycles.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PROF_LINE_MAX 384u
+
+static const char *const zone_name[PROF_ZONE_COUNT] = {
+#define PROF_NAME_(id, name) name,
+    PROF_ZONE_LIST(PROF_NAME_)
+#undef PROF_NAME_
+};
+
+static Prof_Stat_t zones[PROF_ZONE_COUNT] DTCM_BSS;
+
+static uint32_t loop_prev;
+static uint32_t loop_period;
+static uint8_t loop_samples;   /* 0 - нет метки, 1 - нет периода, 2 - есть оба */
+
+/* Строка отчёта, которую выведет Prof_Task; PROF_ZONE_COUNT + 1 - отчёта нет */
+static uint8_t dump_idx = PROF_ZONE_COUNT + 1u;
+
+ITCM_CODE void Prof_Record(Prof_Zone_t zone, uint32_t cycles)
+{
+    Prof_Stat_t *s = &zones[zone];
+    uint32_t bin = 31u - __CLZ(cycles | 1u);
+
+    if (bin >= PROF_HIST_BINS) bin = PROF_HIST_BINS - 1u;
+    if (s->count == 0u || cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+    s->sum += cycles;
+    s->count++;
+    s->hist[bin]++;
+}
+
+void Prof_LoopTick(void)
+{
+#if PROF_ENABLED
+    uint32_t now = DWT->CYCCNT;
+    uint32_t period = now - loop_prev;
+    loop_prev = now;
+
+    if (loop_samples == 0u) {
+        loop_samples = 1u;
+        return;
+    }
+    Prof_Record(PROF_LOOP, period);
+    if (loop_samples == 2u) {
+        Prof_Record(PROF_JITTER, (period > loop_period) ? period - loop_period : loop_period - period);
+    }
+    loop_period = period;
+    loop_samples = 2u;
+#endif
+}
+
+void Prof_Reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(zones, 0, sizeof(zones));
+    loop_samples = 0u;
+    __set_PRIMASK(primask);
+}
+
+/* Снимок под запретом прерываний: строка отчёта не смешивает два состояния */
+void Prof_Get(Prof_Zone_t zone, Prof_Stat_t *out)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = zones[zone];
+    __set_PRIMASK(primask);
+}
+
+void Prof_DumpStart(void)
+{
+    dump_idx = 0u;
+}
+
+static uint16_t FormatZone(char *line, Prof_Zone_t zone)
+{
+    Prof_Stat_t s;
+    Prof_Get(zone, &s);
+
+    uint32_t avg = s.count ? (uint32_t)(s.sum / s.count) : 0u;
+    int n = snprintf(line, PROF_LINE_MAX, "PROF %-18s n=%lu min=%lu avg=%lu max=%lu cyc (%luus) h:",
+                     zone_name[zone], (unsigned long)s.count, (unsigned long)s.min,
+                     (unsigned long)avg, (unsigned long)s.max,
+                     (unsigned long)DWT_CyclesToUs(s.max));
+
+    for (uint32_t b = 0; b < PROF_HIST_BINS && n < (int)PROF_LINE_MAX - 16; b++) {
+        if (s.hist[b] == 0u) continue;
+        n += snprintf(&line[n], PROF_LINE_MAX - (size_t)n, " %lu:%lu",
+                      (unsigned long)b, (unsigned long)s.hist[b]);
+    }
+    n += snprintf(&line[n], PROF_LINE_MAX - (size_t)n, "\r\n");
+    if (n > (int)PROF_LINE_MAX - 1) n = (int)PROF_LINE_MAX - 1;
+    return (uint16_t)n;
+}
+
+/* По строке за вызов и только при свободном месте в кольце — иначе длинный
+   отчёт вытеснил бы сам себя (или остальной лог) */
+void Prof_Task(void)
+{
+    char line[PROF_LINE_MAX];
+    uint16_t len;
+
+    if (dump_idx > PROF_ZONE_COUNT) return;
+    if (UsbLog_Free() < PROF_LINE_MAX) return;
+
+    if (dump_idx == 0u) {
+        len = (uint16_t)snprintf(line, sizeof(line),
+                                 "PROF begin: %lu MHz, I$=%s D$=%s, bins log2(cycles)\r\n",
+                                 (unsigned long)(SystemCoreClock / 1000000u),
+                                 (SCB->CCR & SCB_CCR_IC_Msk) ? "on" : "off",
+                                 (SCB->CCR & SCB_CCR_DC_Msk) ? "on" : "off");
+    } else {
+        len = FormatZone(line, (Prof_Zone_t)(dump_idx - 1u));
+    }
+    UsbLog_Write((const uint8_t *)line, len);
+
+    if (++dump_idx > PROF_ZONE_COUNT) {
+        UsbLog_Printf("PROF end\r\n");
+    }
+}
@@ -0,0 +1,170 @@
+#include "sched.h"
+#include "main.h"
+#include "dwt_cycles.h"
+#include "usb_log.h"
+#include "deadline.h"
+#include <stdio.h>
+
+static Sched_Task_t *tasks;
+static uint8_t task_count;
+static uint8_t urgent_count;           // задачи уровня протокола — первые в таблице
+static uint8_t urgent_stale;           // после их прогона был шаг задачи ниже
+
+// 64-битное время для доли CPU: отчёт может быть реже переполнения CYCCNT
+static uint32_t cyc_last;
+static uint64_t cyc_total;
+static uint64_t cyc_reset;
+
+// Строка отчёта, которую выведет Sched_DumpTask; больше task_count — отчёта нет
+#define SCHED_LINE_MAX  160u
+static uint8_t dump_line = SCHED_MAX_TASKS + 1u;
+
+static uint64_t Now(void)
+{
+    uint32_t now = DWT_Cycles();
+    cyc_total += (uint32_t)(now - cyc_last);
+    cyc_last = now;
+    return cyc_total;
+}
+
+void Sched_Init(Sched_Task_t *table, uint8_t count)
+{
+    if (count > SCHED_MAX_TASKS) count = SCHED_MAX_TASKS;
+
+    // Вставками: в уровне сохраняется порядок таблицы
+    for (uint8_t i = 1; i < count; i++) {
+        Sched_Task_t t = table[i];
+        uint8_t j = i;
+        while (j > 0 && table[j - 1u].prio > t.prio) {
+            table[j] = table[j - 1u];
+            j--;
+        }
+        table[j] = t;
+    }
+
+    tasks = table;
+    task_count = count;
+    urgent_count = 0;
+    while (urgent_count < count && tasks[urgent_count].prio == SCHED_PRIO_PROTOCOL) urgent_count++;
+    urgent_stale = 0;
+    dump_line = SCHED_MAX_TASKS + 1u;
+    for (uint8_t i = 0; i < count; i++) {
+        tasks[i].pt = 0u;
+    }
+    Sched_ResetStats();
+}
+
+static void Step(Sched_Task_t *t)
+{
+    uint32_t t0 = DWT_Cycles();
+    uint8_t res = SCHED_DONE;
+
+    if (t->call) {
+        t->call();
+    } else {
+        res = t->step(t);
+    }
+    uint32_t cyc = DWT_Cycles() - t0;
+
+    Sched_Stats_t *s = &t->stats;
+    if (t->started && t0 - t->t_start > s->max_latency) s->max_latency = t0 - t->t_start;
+    t->t_start = t0;
+    t->started = 1u;
+
+    s->runs++;
+    if (res == SCHED_YIELD) {
+        s->yields++;
+        Deadline_At(HAL_GetTick());    // продолжение — на следующем проходе, без сна
+    }
+    s->cycles += cyc;
+    if (cyc > s->max_step) s->max_step = cyc;
+#if PROF_ENABLED
+    if (t->zone < PROF_ZONE_COUNT) Prof_Record(t->zone, cyc);
+#endif
+}
+
+static void RunUrgent(void)
+{
+    for (uint8_t i = 0; i < urgent_count; i++) {
+        Step(&tasks[i]);
+    }
+    urgent_stale = 0;
+}
+
+void Sched_Run(void)
+{
+    (void)Now();
+
+    RunUrgent();
+    for (uint8_t i = urgent_count; i < task_count; i++) {
+        if (urgent_stale) RunUrgent();
+        Step(&tasks[i]);
+        urgent_stale = 1u;
+    }
+}
+
+uint8_t Sched_Count(void)
+{
+    return task_count;
+}
+
+const Sched_Task_t *Sched_GetTask(uint8_t idx)
+{
+    return (idx < task_count) ? &tasks[idx] : NULL;
+}
+
+void Sched_ResetStats(void)
+{
+    for (uint8_t i = 0; i < task_count; i++) {
+        Sched_Task_t *t = &tasks[i];
+        t->started = 0u;
+        t->stats = (Sched_Stats_t){ 0 };
+    }
+    cyc_reset = Now();
+}
+
+void Sched_DumpStart(void)
+{
+    dump_line = 0u;
+}
+
+/* Строка на задачу: доля CPU — от времени на момент строки, а не начала
+   отчёта, счётчики задачи к этому времени тоже подросли */
+static uint16_t FormatTask(char *line, const Sched_Task_t *t)
+{
+    const Sched_Stats_t *s = &t->stats;
+    uint64_t elapsed = Now() - cyc_reset;
+    uint32_t permille = elapsed ? (uint32_t)(s->cycles * 1000u / elapsed) : 0u;
+    uint32_t avg = s->runs ? (uint32_t)(s->cycles / s->runs) : 0u;
+
+    int n = snprintf(line, SCHED_LINE_MAX,
+                     "TASK %-12s p%u runs=%lu yields=%lu cpu=%lu.%lu%% avg=%luus max=%luus lat=%luus\r\n",
+                     t->name, t->prio, (unsigned long)s->runs, (unsigned long)s->yields,
+                     (unsigned long)(permille / 10u), (unsigned long)(permille % 10u),
+                     (unsigned long)DWT_CyclesToUs(avg),
+                     (unsigned long)DWT_CyclesToUs(s->max_step),
+                     (unsigned long)DWT_CyclesToUs(s->max_latency));
+    if (n > (int)SCHED_LINE_MAX - 1) n = (int)SCHED_LINE_MAX - 1;
+    return (uint16_t)n;
+}
+
+/* Как Prof_Task: по строке за вызов и только при свободном месте в кольце */
+void Sched_DumpTask(void)
+{
+    char line[SCHED_LINE_MAX];
+    uint16_t len;
+
+    if (dump_line > task_count) return;
+    if (UsbLog_Free() < SCHED_LINE_MAX) return;   // место освободит передача (прерывание)
+
+    if (dump_line == 0u) {
+        len = (uint16_t)snprintf(line, sizeof(line), "TASK %lu ms, %u tasks\r\n",
+                                 (unsigned long)((Now() - cyc_reset) / (SystemCoreClock / 1000u)),
+                                 task_count);
+    } else {
+        len = FormatTask(line, &tasks[dump_line - 1u]);
+    }
+    UsbLog_Write((const uint8_t *)line, len);
+
+    if (++dump_line <= task_count) Deadline_At(HAL_GetTick());   // следующая строка — на следующем проходе
+}
@@ -1,16 +1,42 @@
 #include "ssd1309.h"
 #include "font8x8_basic.h"
+#include "font_digits.h"
+#include "dwt_cycles.h"
+#include "mem_layout.h"
+#include "deadline.h"
 #include <string.h>
 
 /* Внутренние фазы */
-enum { PHASE_IDLE = 0, PHASE_INIT = 1, PHASE_PAGE_CMD = 2, PHASE_PAGE_DATA = 3 };
+enum { PHASE_IDLE = 0, PHASE_INIT = 1, PHASE_PAGE_CMD = 2, PHASE_PAGE_DATA = 3,
+       PHASE_WIN_CMD = 4, PHASE_WIN_DATA = 5, PHASE_PANEL = 6 };
 
 static inline void cs_low (SSD1309_t *d){ HAL_GPIO_WritePin(d->cfg.cs_port,  d->cfg.cs_pin,  GPIO_PIN_RESET); }
 static inline void cs_high(SSD1309_t *d){ HAL_GPIO_WritePin(d->cfg.cs_port,  d->cfg.cs_pin,  GPIO_PIN_SET);   }
 static inline void dc_cmd (SSD1309_t *d){ HAL_GPIO_WritePin(d->cfg.dc_port,  d->cfg.dc_pin,  GPIO_PIN_RESET); }
 static inline void dc_data(SSD1309_t *d){ HAL_GPIO_WritePin(d->cfg.dc_port,  d->cfg.dc_pin,  GPIO_PIN_SET);   }
-static inline void rst_low(SSD1309_t *d){ HAL_GPIO_WritePin(d->cfg.rst_port, d->cfg.rst_pin, GPIO_PIN_RESET); }
-static inline void rst_high(SSD1309_t *d){HAL_GPIO_WritePin(d->cfg.rst_port, d->cfg.rst_pin, GPIO_PIN_SET);   }
+static inline void rst_low(SSD1309_t *d){ if (d->cfg.rst_port) HAL_GPIO_WritePin(d->cfg.rst_port, d->cfg.rst_pin, GPIO_PIN_RESET); }
+static inline void rst_high(SSD1309_t *d){if (d->cfg.rst_port) HAL_GPIO_WritePin(d->cfg.rst_port, d->cfg.rst_pin, GPIO_PIN_SET);   }
+
+/* Захват общей шины перед передачей. Вызывается и из ISR при продолжении цепочки —
+   тогда owner уже равен d; из NULL в d переводит только main loop. */
+static bool bus_claim(SSD1309_t *d)
+{
+    SSD1309_Bus_t *b = d->bus;
+    if (!b) return true;
+    if (b->owner == d) return true;
+    if (b->owner != NULL) return false;
+
+    b->owner = d;
+    b->rr = (uint8_t)((d->bus_slot + 1u) % b->count);
+    return true;
+}
+
+/* Цепочка закончилась (или оборвалась): шина свободна для следующей панели */
+static void bus_release(SSD1309_t *d)
+{
+    SSD1309_Bus_t *b = d->bus;
+    if (b && b->owner == d) b->owner = NULL;
+}
 
 /* DCache clean helper: округление по 32 байта (cache line) */
 static void dcache_clean(const void *addr, uint32_t len)
@@ -38,13 +64,24 @@ static void build_init_seq(SSD1309_t *d)
     d->init_seq[i++] = 0xD3; d->init_seq[i++] = 0x00; /* display offset */
     d->init_seq[i++] = 0x40;                 /* start line */
 
-    /* addressing: page */
-    d->init_seq[i++] = 0x20; d->init_seq[i++] = 0x02;
+    if (d->window) {
+        /* addressing: horizontal, окно на весь экран; столбцы со сдвигом col_offset */
+        d->init_seq[i++] = 0x20; d->init_seq[i++] = 0x00;
+        d->init_seq[i++] = 0x21; d->init_seq[i++] = d->cfg.col_offset;
+        d->init_seq[i++] = (uint8_t)(d->cfg.col_offset + SSD1309_WIDTH - 1u);
+        d->init_seq[i++] = 0x22; d->init_seq[i++] = 0x00; d->init_seq[i++] = 0x07;
+        d->win_first = 0u;
+        d->win_last = 7u;
+        d->win_valid = 1u;
+    } else {
+        /* addressing: page */
+        d->init_seq[i++] = 0x20; d->init_seq[i++] = 0x02;
+    }
 
     d->init_seq[i++] = 0xA1;                 /* seg remap */
     d->init_seq[i++] = 0xC8;                 /* COM scan dec */
     d->init_seq[i++] = 0xDA; d->init_seq[i++] = 0x12; /* COM pins */
-    d->init_seq[i++] = 0x81; d->init_seq[i++] = 0x7F; /* contrast */
+    d->init_seq[i++] = 0x81; d->init_seq[i++] = (d->cfg.contrast ? d->cfg.contrast : 0x7F); /* contrast */
     d->init_seq[i++] = 0xD9; d->init_seq[i++] = 0xF1; /* precharge */
     d->init_seq[i++] = 0xDB; d->init_seq[i++] = 0x40; /* VCOMH */
     d->init_seq[i++] = 0xA4;                 /* resume RAM */
@@ -68,9 +105,13 @@ static void start_init_chunk(SSD1309_t *d)
         d->ready = 1u;
         d->phase = PHASE_IDLE;
         d->init_step = 5u; /* done */
+        d->resend = 0xFFu; /* ОЗУ контроллера после reset не определено: первый кадр целиком */
+        bus_release(d);
         return;
     }
 
+    if (!bus_claim(d)) return; /* шина занята другой панелью: повторим в SSD1309_Task() */
+
     uint8_t rem = (uint8_t)(d->init_len - d->init_pos);
     d->tx_len = (rem > (uint8_t)sizeof(d->tx_cmd)) ? (uint8_t)sizeof(d->tx_cmd) : rem;
 
@@ -82,15 +123,17 @@ static void start_init_chunk(SSD1309_t *d)
 
     if (HAL_SPI_Transmit_DMA(d->cfg.hspi, d->tx_cmd, d->tx_len) == HAL_OK) {
         d->busy = 1u;
+        d->stats.bytes += d->tx_len;
         d->phase = PHASE_INIT;
     } else {
         cs_high(d); /* повторим позже в SSD1309_Task() */
+        bus_release(d);
     }
 }
 
-static void start_page_cmd(SSD1309_t *d)
+static bool start_page_cmd(SSD1309_t *d)
 {
-    if (d->busy) return;
+    if (d->busy || !bus_claim(d)) return false;
 
     const uint8_t col = d->cfg.col_offset;
 
@@ -106,15 +149,18 @@ static void start_page_cmd(SSD1309_t *d)
 
     if (HAL_SPI_Transmit_DMA(d->cfg.hspi, d->tx_cmd, d->tx_len) == HAL_OK) {
         d->busy = 1u;
+        d->stats.bytes += d->tx_len;
         d->phase = PHASE_PAGE_CMD;
-    } else {
-        cs_high(d);
+        return true;
     }
+
+    cs_high(d);
+    return false;
 }
 
-static void start_page_data(SSD1309_t *d)
+static bool start_page_data(SSD1309_t *d)
 {
-    if (d->busy) return;
+    if (d->busy || !bus_claim(d)) return false;
 
     uint8_t *p = &d->fb[(uint32_t)d->page * SSD1309_WIDTH];
 
@@ -126,17 +172,175 @@ static void start_page_data(SSD1309_t *d)
 
     if (HAL_SPI_Transmit_DMA(d->cfg.hspi, p, SSD1309_WIDTH) == HAL_OK) {
         d->busy = 1u;
+        d->stats.bytes += SSD1309_WIDTH;
         d->phase = PHASE_PAGE_DATA;
+        return true;
+    }
+
+    cs_high(d);
+    return false;
+}
+
+/* Контраст и инверсия на работающей панели: три байта команд, между кадрами.
+   Указатель адреса GDDRAM они не трогают — окно остаётся в силе */
+static void start_panel_cmd(SSD1309_t *d)
+{
+    if (d->busy || d->phase != PHASE_IDLE || !bus_claim(d)) return;
+
+    d->tx_cmd[0] = 0x81u;
+    d->tx_cmd[1] = (d->cfg.contrast ? d->cfg.contrast : 0x7Fu);
+    d->tx_cmd[2] = (d->cfg.invert ? 0xA7u : 0xA6u);
+    d->tx_len = 3u;
+
+    dcache_clean(d->tx_cmd, d->tx_len);
+
+    dc_cmd(d);
+    cs_low(d);
+
+    if (HAL_SPI_Transmit_DMA(d->cfg.hspi, d->tx_cmd, d->tx_len) == HAL_OK) {
+        d->busy = 1u;
+        d->stats.bytes += d->tx_len;
+        d->phase = PHASE_PANEL;
+        d->panel_pending = 0u;
     } else {
-        cs_high(d);
+        cs_high(d); /* повторим в SSD1309_Task() */
+        bus_release(d);
     }
 }
 
+/* Следующая страница из mask начиная с from, 8 = нет */
+static uint8_t next_page(uint8_t mask, uint8_t from)
+{
+    while (from < 8u && (mask & (1u << from)) == 0u) from++;
+    return from;
+}
+
+/* Страницы текущей передачи, ещё не ушедшие в дисплей (включая текущую) */
+static inline uint8_t pages_left(const SSD1309_t *d)
+{
+    return (uint8_t)(d->tx_pages & (uint8_t)(0xFFu << d->page));
+}
+
+/* WINDOW: команда окна страниц page..win_last */
+static bool start_window_cmd(SSD1309_t *d)
+{
+    if (d->busy || !bus_claim(d)) return false;
+
+    d->tx_cmd[0] = 0x21u; d->tx_cmd[1] = d->cfg.col_offset;
+    d->tx_cmd[2] = (uint8_t)(d->cfg.col_offset + SSD1309_WIDTH - 1u);
+    d->tx_cmd[3] = 0x22u; d->tx_cmd[4] = d->page; d->tx_cmd[5] = d->win_last;
+    d->tx_len = 6u;
+
+    dcache_clean(d->tx_cmd, d->tx_len);
+
+    dc_cmd(d);
+    cs_low(d);
+
+    if (HAL_SPI_Transmit_DMA(d->cfg.hspi, d->tx_cmd, d->tx_len) == HAL_OK) {
+        d->busy = 1u;
+        d->stats.bytes += d->tx_len;
+        d->phase = PHASE_WIN_CMD;
+        d->win_valid = 0u;
+        return true;
+    }
+
+    cs_high(d);
+    return false;
+}
+
+/* WINDOW: все страницы окна одной передачей */
+static bool start_window_data(SSD1309_t *d)
+{
+    if (d->busy || !bus_claim(d)) return false;
+
+    uint8_t *p = &d->fb[(uint32_t)d->page * SSD1309_WIDTH];
+    uint16_t len = (uint16_t)((d->win_last - d->page + 1u) * SSD1309_WIDTH);
+
+    dcache_clean(p, len);
+
+    dc_data(d);
+    cs_low(d);
+
+    if (HAL_SPI_Transmit_DMA(d->cfg.hspi, p, len) == HAL_OK) {
+        d->busy = 1u;
+        d->stats.bytes += len;
+        d->phase = PHASE_WIN_DATA;
+        d->win_valid = 0u; /* до завершения указатель адреса в середине окна */
+        return true;
+    }
+
+    cs_high(d);
+    return false;
+}
+
+/* Старт кадра — только из main loop: dirty меняют только main-функции рисования */
+static void start_frame(SSD1309_t *d)
+{
+    if (d->busy || d->dirty == 0u) return;
+
+    d->tx_pages = d->dirty;
+    d->dirty = 0u;
+    d->page = next_page(d->tx_pages, 0u);
+
+    bool ok;
+    if (d->window) {
+        uint8_t last = 7u;
+        while ((d->tx_pages & (1u << last)) == 0u) last--;
+
+        /* чистые страницы внутри окна уходят заодно: это дешевле лишних фаз команд */
+        if (d->win_valid && d->win_first == d->page && d->win_last == last) {
+            ok = start_window_data(d);
+        } else {
+            d->win_first = d->page;
+            d->win_last = last;
+            ok = start_window_cmd(d);
+        }
+    } else {
+        ok = start_page_cmd(d);
+    }
+
+    if (!ok) {
+        d->dirty |= d->tx_pages;
+        d->tx_pages = 0u;
+        bus_release(d);
+        return;
+    }
+
+    d->stats.t_start = DWT_Cycles();
+}
+
+/* Кадр целиком ушёл в дисплей (контекст ISR) */
+static void frame_done(SSD1309_t *d)
+{
+    uint32_t cyc = DWT_Cycles() - d->stats.t_start;
+
+    d->stats.frames++;
+    d->stats.xfer_cycles_last = cyc;
+    if (cyc > d->stats.xfer_cycles_max) d->stats.xfer_cycles_max = cyc;
+
+    d->phase = PHASE_IDLE;
+    d->tx_pages = 0u;
+    bus_release(d);
+}
+
+/* Сбой внутри цепочки (контекст ISR): недоотправленные страницы вернёт SSD1309_Task() */
+static void abort_frame(SSD1309_t *d)
+{
+    d->resend |= pages_left(d);
+    d->stats.dropped++;
+    d->tx_pages = 0u;
+    d->phase = PHASE_IDLE;
+    d->win_valid = 0u;
+    bus_release(d);
+}
+
 void SSD1309_Init(SSD1309_t *d, const SSD1309_Config_t *cfg)
 {
     memset(d, 0, sizeof(*d));
     d->cfg = *cfg;
 
+    d->window = (cfg->refresh == SSD1309_REFRESH_WINDOW) ? 1u : 0u;
+
     d->ready = 0u;
     d->busy = 0u;
     d->dirty = 0u;
@@ -151,9 +355,14 @@ void SSD1309_Init(SSD1309_t *d, const SSD1309_Config_t *cfg)
 
 void SSD1309_BeginAsync(SSD1309_t *d)
 {
+    bus_release(d);
     d->ready = 0u;
     d->busy = 0u;
     d->dirty = 0u;
+    d->hold = 0u;
+    d->panel_pending = 0u;
+    d->tx_pages = 0u;
+    d->resend = 0u;
     d->phase = PHASE_IDLE;
     d->init_step = 0u;
 
@@ -162,6 +371,19 @@ void SSD1309_BeginAsync(SSD1309_t *d)
     rst_high(d);
 }
 
+void SSD1309_SetPanel(SSD1309_t *d, uint8_t contrast, uint8_t invert)
+{
+    if (d->cfg.contrast == contrast && d->cfg.invert == invert) return;
+    d->cfg.contrast = contrast;
+    d->cfg.invert = invert;
+
+    /* Последовательность ещё не собрана (идёт reset) — значения войдут в неё;
+       иначе короткая команда из SSD1309_Task, без reset и повторной инициализации */
+    if (d->ready || d->init_step >= 4u) {
+        d->panel_pending = 1u;
+    }
+}
+
 void SSD1309_Task(SSD1309_t *d)
 {
     uint32_t now = HAL_GetTick();
@@ -178,6 +400,7 @@ void SSD1309_Task(SSD1309_t *d)
             break;
 
         case 1u:
+            Deadline_At(d->t0_ms + 20u);
             if ((now - d->t0_ms) >= 20u) { /* чуть дольше reset */
                 rst_high(d);
                 d->t0_ms = now;
@@ -186,6 +409,7 @@ void SSD1309_Task(SSD1309_t *d)
             break;
 
         case 2u:
+            Deadline_At(d->t0_ms + 120u);
             if ((now - d->t0_ms) >= 120u) { /* чуть дольше после reset */
                 build_init_seq(d);
                 d->init_step = 4u;
@@ -203,32 +427,50 @@ void SSD1309_Task(SSD1309_t *d)
         return;
     }
 
-    /* Обновление экрана по dirty */
-    if (d->dirty && !d->busy) {
-        d->page = 0u;
-        start_page_cmd(d);
+    /* Страницы, которые цепочка DMA вернула после сбоя */
+    if (d->resend && !d->busy) {
+        d->dirty |= d->resend;
+        d->resend = 0u;
     }
+
+    /* Контраст/инверсия из SSD1309_SetPanel — раньше кадра */
+    if (d->panel_pending) start_panel_cmd(d);
+
+    /* Обновление экрана по dirty */
+    if (!d->hold) start_frame(d);
 }
 
 void SSD1309_UpdateAsync(SSD1309_t *d)
 {
-    d->dirty = 1u;
+    d->hold = 0u;
+    d->stats.updates++;
+    if (d->phase != PHASE_IDLE) {
+        d->stats.update_busy++;
+        /* новые изменения уйдут одним кадром с теми, что накопятся до конца передачи */
+        if (d->dirty) d->stats.coalesced++;
+    }
 
-    if (d->ready && !d->busy) {
-        d->page = 0u;
-        start_page_cmd(d);
+    if (d->ready) {
+        start_frame(d);
     }
 }
 
+void SSD1309_ResetStats(SSD1309_t *d)
+{
+    uint32_t t_start = d->stats.t_start; /* кадр может быть в полёте */
+    memset(&d->stats, 0, sizeof(d->stats));
+    d->stats.t_start = t_start;
+}
+
 /* ===== graphics ===== */
 
 void SSD1309_Clear(SSD1309_t *d)
 {
     memset(d->fb, 0x00, sizeof(d->fb));
-    d->dirty = 1u;
+    d->dirty = 0xFFu;
 }
 
-void SSD1309_DrawPixel(SSD1309_t *d, uint16_t x, uint16_t y, SSD1309_Color_t c)
+ITCM_CODE void SSD1309_DrawPixel(SSD1309_t *d, uint16_t x, uint16_t y, SSD1309_Color_t c)
 {
     if (x >= SSD1309_WIDTH || y >= SSD1309_HEIGHT) return;
 
@@ -238,10 +480,10 @@ void SSD1309_DrawPixel(SSD1309_t *d, uint16_t x, uint16_t y, SSD1309_Color_t c)
     if (c == SSD1309_COLOR_WHITE) d->fb[index] |= mask;
     else                         d->fb[index] &= (uint8_t)~mask;
 
-    d->dirty = 1u;
+    d->dirty |= (uint8_t)(1u << (y >> 3));
 }
 
-void SSD1309_DrawChar8x8(SSD1309_t *d, uint16_t x, uint16_t y, char ch, SSD1309_Color_t c)
+ITCM_CODE void SSD1309_DrawChar8x8(SSD1309_t *d, uint16_t x, uint16_t y, char ch, SSD1309_Color_t c)
 {
     uint8_t uch = (uint8_t)ch;
     if (uch < 0x20u || uch > 0x7Fu) uch = 0x20u;
@@ -258,7 +500,7 @@ void SSD1309_DrawChar8x8(SSD1309_t *d, uint16_t x, uint16_t y, char ch, SSD1309_
     }
 }
 
-void SSD1309_DrawString8x8(SSD1309_t *d, uint16_t x, uint16_t y, const char *s, SSD1309_Color_t c)
+ITCM_CODE void SSD1309_DrawString8x8(SSD1309_t *d, uint16_t x, uint16_t y, const char *s, SSD1309_Color_t c)
 {
     while (*s) {
         SSD1309_DrawChar8x8(d, x, y, *s++, c);
@@ -267,6 +509,176 @@ void SSD1309_DrawString8x8(SSD1309_t *d, uint16_t x, uint16_t y, const char *s,
     }
 }
 
+void SSD1309_ClearPages(SSD1309_t *d, uint8_t first, uint8_t count)
+{
+    if (first >= 8u) return;
+    if (count > (uint8_t)(8u - first)) count = (uint8_t)(8u - first);
+
+    memset(&d->fb[(uint32_t)first * SSD1309_WIDTH], 0x00, (uint32_t)count * SSD1309_WIDTH);
+    d->dirty |= (uint8_t)(((1u << count) - 1u) << first);
+}
+
+ITCM_CODE void SSD1309_FillRect(SSD1309_t *d, uint16_t x, uint16_t y, uint16_t w, uint16_t h, SSD1309_Color_t c)
+{
+    if (x >= SSD1309_WIDTH || y >= SSD1309_HEIGHT || w == 0u || h == 0u) return;
+    if (x + w > SSD1309_WIDTH)  w = (uint16_t)(SSD1309_WIDTH - x);
+    if (y + h > SSD1309_HEIGHT) h = (uint16_t)(SSD1309_HEIGHT - y);
+
+    /* по страницам: одна маска на страницу вместо попиксельного вывода */
+    uint16_t y_end = (uint16_t)(y + h);
+    for (uint16_t page = (uint16_t)(y >> 3); page <= (uint16_t)((y_end - 1u) >> 3); page++) {
+        uint16_t top = (uint16_t)(page * 8u);
+        uint16_t y0 = (y > top) ? y : top;
+        uint16_t y1 = (y_end < (uint16_t)(top + 8u)) ? y_end : (uint16_t)(top + 8u);
+        uint8_t mask = (uint8_t)(((1u << (y1 - y0)) - 1u) << (y0 - top));
+
+        uint8_t *row = &d->fb[(uint32_t)page * SSD1309_WIDTH + x];
+        for (uint16_t i = 0; i < w; i++) {
+            if (c == SSD1309_COLOR_WHITE) row[i] |= mask;
+            else                         row[i] &= (uint8_t)~mask;
+        }
+        d->dirty |= (uint8_t)(1u << page);
+    }
+}
+
+/* ===== big digits ===== */
+
+static bool big_font_get(SSD1309_BigFont_t font, const uint8_t **tiles, const uint8_t **widths, uint8_t *pages)
+{
+    switch (font) {
+#if FONT_DIGITS_16X24
+    case SSD1309_FONT_16X24:
+        *tiles = &font_digits_16x24[0][0][0];
+        *widths = font_digits_16x24_w;
+        *pages = 3u;
+        return true;
+#endif
+#if FONT_DIGITS_16X32
+    case SSD1309_FONT_16X32:
+        *tiles = &font_digits_16x32[0][0][0];
+        *widths = font_digits_16x32_w;
+        *pages = 4u;
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+/* Глиф, не вошедший в сборку (символ или весь размер шрифта, font_digits.h):
+   рамка во всю высоту знакоместа. Пропуск виден на экране, а не прячется
+   за пробелом */
+#define BIG_MISSING_W  16u
+#define BIG_MISSING_R  12u     /* правый край рамки — по краю цифр */
+
+static uint8_t big_char_width(const uint8_t *widths, char ch)
+{
+    int idx = widths ? font_digits_index(ch) : -1;
+    return (idx < 0) ? (uint8_t)BIG_MISSING_W : widths[idx];
+}
+
+static void big_draw_missing(SSD1309_t *d, uint16_t x, uint8_t page, uint8_t pages, uint16_t cw)
+{
+    for (uint8_t p = 0; p < pages && (uint8_t)(page + p) < 8u; p++) {
+        uint8_t *col = &d->fb[(uint32_t)(page + p) * SSD1309_WIDTH + x];
+        uint8_t edge = (uint8_t)((p == 0u ? 0x01u : 0u) | (p + 1u == pages ? 0x80u : 0u));
+
+        for (uint16_t c = 0; c < cw; c++) {
+            col[c] = (c == 0u || c == BIG_MISSING_R) ? 0xFFu : (c < BIG_MISSING_R ? edge : 0x00u);
+        }
+        d->dirty |= (uint8_t)(1u << (page + p));
+    }
+}
+
+ITCM_CODE uint16_t SSD1309_DrawBigChar(SSD1309_t *d, uint16_t x, uint8_t page, char ch, SSD1309_BigFont_t font)
+{
+    const uint8_t *tiles = NULL;
+    const uint8_t *widths = NULL;
+    uint8_t pages = (font == SSD1309_FONT_16X32) ? 4u : 3u;
+
+    (void)big_font_get(font, &tiles, &widths, &pages);
+
+    int idx = widths ? font_digits_index(ch) : -1;
+    uint8_t w = big_char_width(widths, ch);
+    if (x >= SSD1309_WIDTH || page >= 8u) return w;
+
+    uint16_t cw = (uint16_t)((x + w > SSD1309_WIDTH) ? (SSD1309_WIDTH - x) : w);
+    if (idx < 0) {
+        big_draw_missing(d, x, page, pages, cw);
+        return w;
+    }
+
+    const uint8_t *g = tiles + (uint32_t)idx * pages * 16u;
+
+    /* тайл целиком замещает старое содержимое — стирать перед выводом не нужно */
+    for (uint8_t p = 0; p < pages && (uint8_t)(page + p) < 8u; p++) {
+        memcpy(&d->fb[(uint32_t)(page + p) * SSD1309_WIDTH + x], &g[(uint32_t)p * 16u], cw);
+        d->dirty |= (uint8_t)(1u << (page + p));
+    }
+
+    return w;
+}
+
+uint8_t SSD1309_FormatFixed(char *out, uint8_t out_sz, uint32_t value, uint8_t int_digits, uint8_t decimals)
+{
+    if (int_digits == 0u) int_digits = 1u;
+
+    uint8_t len = (uint8_t)(int_digits + (decimals ? (uint8_t)(decimals + 1u) : 0u));
+    if ((uint16_t)len + 1u > out_sz) return 0u;
+
+    /* насыщение: 3.2 знака -> максимум 999.99 */
+    uint32_t limit = 1u;
+    for (uint8_t i = 0; i < (uint8_t)(int_digits + decimals); i++) {
+        if (limit > (UINT32_MAX / 10u)) { limit = 0u; break; }
+        limit *= 10u;
+    }
+    if (limit != 0u && value >= limit) value = limit - 1u;
+
+    uint8_t pos = len;
+    out[pos] = '\0';
+
+    for (uint8_t i = 0; i < decimals; i++) {
+        out[--pos] = (char)('0' + (value % 10u));
+        value /= 10u;
+    }
+    if (decimals) out[--pos] = '.';
+
+    do {
+        out[--pos] = (char)('0' + (value % 10u));
+        value /= 10u;
+    } while (value != 0u && pos > 0u);
+
+    while (pos > 0u) out[--pos] = ' ';
+
+    return len;
+}
+
+void SSD1309_DrawNumber(SSD1309_t *d, SSD1309_NumField_t *f, uint32_t value)
+{
+    const uint8_t *tiles = NULL;
+    const uint8_t *widths = NULL;
+    uint8_t pages;
+    char txt[SSD1309_NUM_MAX_SLOTS + 1u];
+
+    /* размер без глифов рисуется рамками (SSD1309_DrawBigChar) */
+    (void)big_font_get((SSD1309_BigFont_t)f->font, &tiles, &widths, &pages);
+
+    uint8_t len = SSD1309_FormatFixed(txt, (uint8_t)sizeof(txt), value, f->int_digits, f->decimals);
+    uint16_t x = f->x;
+
+    /* позиция точки фиксирована, поэтому знакоместа не сдвигаются между кадрами */
+    for (uint8_t i = 0; i < len; i++) {
+        if (!f->valid || f->shown[i] != txt[i]) {
+            x = (uint16_t)(x + SSD1309_DrawBigChar(d, x, f->page, txt[i], (SSD1309_BigFont_t)f->font));
+            f->shown[i] = txt[i];
+        } else {
+            x = (uint16_t)(x + big_char_width(widths, txt[i]));
+        }
+    }
+
+    f->valid = 1u;
+}
+
 /* ===== callbacks routing target ===== */
 
 void SSD1309_OnSpiTxCplt(SSD1309_t *d, SPI_HandleTypeDef *hspi)
@@ -285,21 +697,37 @@ void SSD1309_OnSpiTxCplt(SSD1309_t *d, SPI_HandleTypeDef *hspi)
         break;
 
     case PHASE_PAGE_CMD:
-        start_page_data(d);
+        if (!start_page_data(d)) abort_frame(d);
         break;
 
     case PHASE_PAGE_DATA:
-        d->page++;
+        /* чистые страницы пропускаем */
+        d->page = next_page(d->tx_pages, (uint8_t)(d->page + 1u));
         if (d->page < 8u) {
-            start_page_cmd(d);
+            if (!start_page_cmd(d)) abort_frame(d);
         } else {
-            d->phase = PHASE_IDLE;
-            d->dirty = 0u;
+            frame_done(d);
         }
         break;
 
+    case PHASE_WIN_CMD:
+        if (!start_window_data(d)) abort_frame(d);
+        break;
+
+    case PHASE_WIN_DATA:
+        /* окно записано целиком: указатель адреса вернулся в его начало */
+        d->win_valid = 1u;
+        frame_done(d);
+        break;
+
+    case PHASE_PANEL:
+        d->phase = PHASE_IDLE;
+        bus_release(d);
+        break;
+
     default:
         d->phase = PHASE_IDLE;
+        bus_release(d);
         break;
     }
 }
@@ -310,6 +738,53 @@ void SSD1309_OnSpiError(SSD1309_t *d, SPI_HandleTypeDef *hspi)
 
     cs_high(d);
     d->busy = 0u;
+    d->stats.spi_errors++;
+
+    /* недоотправленные страницы вернутся в dirty в SSD1309_Task() */
+    if (d->phase == PHASE_PAGE_CMD || d->phase == PHASE_PAGE_DATA ||
+        d->phase == PHASE_WIN_CMD  || d->phase == PHASE_WIN_DATA) {
+        abort_frame(d);
+    }
+    if (d->phase == PHASE_PANEL) d->panel_pending = 1u;
     d->phase = PHASE_IDLE;
-    /* dirty не сбрасываем: можно повторить UpdateAsync() */
+    bus_release(d);
+}
+
+/* ===== общая шина ===== */
+
+void SSD1309_Bus_Init(SSD1309_Bus_t *b, SPI_HandleTypeDef *hspi)
+{
+    memset(b, 0, sizeof(*b));
+    b->hspi = hspi;
+}
+
+HAL_StatusTypeDef SSD1309_Bus_Attach(SSD1309_Bus_t *b, SSD1309_t *d)
+{
+    if (b->count >= SSD1309_BUS_MAX_PANELS || d->cfg.hspi != b->hspi) return HAL_ERROR;
+
+    d->bus = b;
+    d->bus_slot = b->count;
+    b->panels[b->count++] = d;
+    return HAL_OK;
+}
+
+void SSD1309_Bus_Task(SSD1309_Bus_t *b)
+{
+    /* первой получает шину панель, следующая за последним владельцем */
+    const uint8_t first = b->rr;
+    for (uint8_t k = 0; k < b->count; k++) {
+        SSD1309_Task(b->panels[(uint8_t)((first + k) % b->count)]);
+    }
+}
+
+void SSD1309_Bus_OnSpiTxCplt(SSD1309_Bus_t *b, SPI_HandleTypeDef *hspi)
+{
+    SSD1309_t *d = b->owner;
+    if (d && hspi == b->hspi) SSD1309_OnSpiTxCplt(d, hspi);
+}
+
+void SSD1309_Bus_OnSpiError(SSD1309_Bus_t *b, SPI_HandleTypeDef *hspi)
+{
+    SSD1309_t *d = b->owner;
+    if (d && hspi == b->hspi) SSD1309_OnSpiError(d, hspi);
 }
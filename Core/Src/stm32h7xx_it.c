@@ -22,6 +22,7 @@
 #include "stm32h7xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "prof.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -194,11 +195,11 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
-
+  PROF_BEGIN(SYSTICK);
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
-
+  PROF_END(SYSTICK);
   /* USER CODE END SysTick_IRQn 1 */
 }
 
@@ -215,11 +216,11 @@ void SysTick_Handler(void)
 void DMA1_Stream0_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream0_IRQn 0 */
-
+  PROF_BEGIN(DMA1_S0);
   /* USER CODE END DMA1_Stream0_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart3_rx);
   /* USER CODE BEGIN DMA1_Stream0_IRQn 1 */
-
+  PROF_END(DMA1_S0);
   /* USER CODE END DMA1_Stream0_IRQn 1 */
 }
 
@@ -229,11 +230,11 @@ void DMA1_Stream0_IRQHandler(void)
 void DMA1_Stream1_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream1_IRQn 0 */
-
+  PROF_BEGIN(DMA1_S1);
   /* USER CODE END DMA1_Stream1_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart2_rx);
   /* USER CODE BEGIN DMA1_Stream1_IRQn 1 */
-
+  PROF_END(DMA1_S1);
   /* USER CODE END DMA1_Stream1_IRQn 1 */
 }
 
@@ -243,11 +244,11 @@ void DMA1_Stream1_IRQHandler(void)
 void DMA1_Stream2_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream2_IRQn 0 */
-
+  PROF_BEGIN(DMA1_S2);
   /* USER CODE END DMA1_Stream2_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart2_tx);
   /* USER CODE BEGIN DMA1_Stream2_IRQn 1 */
-
+  PROF_END(DMA1_S2);
   /* USER CODE END DMA1_Stream2_IRQn 1 */
 }
 
@@ -257,11 +258,11 @@ void DMA1_Stream2_IRQHandler(void)
 void DMA1_Stream3_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream3_IRQn 0 */
-
+  PROF_BEGIN(DMA1_S3);
   /* USER CODE END DMA1_Stream3_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart3_tx);
   /* USER CODE BEGIN DMA1_Stream3_IRQn 1 */
-
+  PROF_END(DMA1_S3);
   /* USER CODE END DMA1_Stream3_IRQn 1 */
 }
 
@@ -271,11 +272,11 @@ void DMA1_Stream3_IRQHandler(void)
 void DMA1_Stream5_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Stream5_IRQn 0 */
-
+  PROF_BEGIN(DMA1_S5);
   /* USER CODE END DMA1_Stream5_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_spi2_tx);
   /* USER CODE BEGIN DMA1_Stream5_IRQn 1 */
-
+  PROF_END(DMA1_S5);
   /* USER CODE END DMA1_Stream5_IRQn 1 */
 }
 
@@ -285,11 +286,11 @@ void DMA1_Stream5_IRQHandler(void)
 void TIM2_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM2_IRQn 0 */
-
+  PROF_BEGIN(TIM2);
   /* USER CODE END TIM2_IRQn 0 */
   HAL_TIM_IRQHandler(&htim2);
   /* USER CODE BEGIN TIM2_IRQn 1 */
-
+  PROF_END(TIM2);
   /* USER CODE END TIM2_IRQn 1 */
 }
 
@@ -299,11 +300,11 @@ void TIM2_IRQHandler(void)
 void TIM3_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM3_IRQn 0 */
-
+  PROF_BEGIN(TIM3);
   /* USER CODE END TIM3_IRQn 0 */
   HAL_TIM_IRQHandler(&htim3);
   /* USER CODE BEGIN TIM3_IRQn 1 */
-
+  PROF_END(TIM3);
   /* USER CODE END TIM3_IRQn 1 */
 }
 
@@ -313,11 +314,11 @@ void TIM3_IRQHandler(void)
 void I2C1_EV_IRQHandler(void)
 {
   /* USER CODE BEGIN I2C1_EV_IRQn 0 */
-
+  PROF_BEGIN(I2C1_EV);
   /* USER CODE END I2C1_EV_IRQn 0 */
   HAL_I2C_EV_IRQHandler(&hi2c1);
   /* USER CODE BEGIN I2C1_EV_IRQn 1 */
-
+  PROF_END(I2C1_EV);
   /* USER CODE END I2C1_EV_IRQn 1 */
 }
 
@@ -327,11 +328,11 @@ void I2C1_EV_IRQHandler(void)
 void I2C1_ER_IRQHandler(void)
 {
   /* USER CODE BEGIN I2C1_ER_IRQn 0 */
-
+  PROF_BEGIN(I2C1_ER);
   /* USER CODE END I2C1_ER_IRQn 0 */
   HAL_I2C_ER_IRQHandler(&hi2c1);
   /* USER CODE BEGIN I2C1_ER_IRQn 1 */
-
+  PROF_END(I2C1_ER);
   /* USER CODE END I2C1_ER_IRQn 1 */
 }
 
@@ -341,11 +342,11 @@ void I2C1_ER_IRQHandler(void)
 void SPI2_IRQHandler(void)
 {
   /* USER CODE BEGIN SPI2_IRQn 0 */
-
+  PROF_BEGIN(SPI2);
   /* USER CODE END SPI2_IRQn 0 */
   HAL_SPI_IRQHandler(&hspi2);
   /* USER CODE BEGIN SPI2_IRQn 1 */
-
+  PROF_END(SPI2);
   /* USER CODE END SPI2_IRQn 1 */
 }
 
@@ -355,25 +356,42 @@ void SPI2_IRQHandler(void)
 void USART2_IRQHandler(void)
 {
   /* USER CODE BEGIN USART2_IRQn 0 */
-
+  PROF_BEGIN(USART2);
   /* USER CODE END USART2_IRQn 0 */
   HAL_UART_IRQHandler(&huart2);
   /* USER CODE BEGIN USART2_IRQn 1 */
-
+  PROF_END(USART2);
   /* USER CODE END USART2_IRQn 1 */
 }
 
+/**
+  * @brief This function handles EXTI line[15:10] interrupts.
+  */
+void EXTI15_10_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI15_10_IRQn 0 */
+  PROF_BEGIN(EXTI15_10);
+  /* USER CODE END EXTI15_10_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(KeyCol_1_Pin);
+  HAL_GPIO_EXTI_IRQHandler(KeyCol_2_Pin);
+  HAL_GPIO_EXTI_IRQHandler(KeyCol_3_Pin);
+  HAL_GPIO_EXTI_IRQHandler(KeyCol_4_Pin);
+  /* USER CODE BEGIN EXTI15_10_IRQn 1 */
+  PROF_END(EXTI15_10);
+  /* USER CODE END EXTI15_10_IRQn 1 */
+}
+
 /**
   * @brief This function handles USART3 global interrupt.
   */
 void USART3_IRQHandler(void)
 {
   /* USER CODE BEGIN USART3_IRQn 0 */
-
+  PROF_BEGIN(USART3);
   /* USER CODE END USART3_IRQn 0 */
   HAL_UART_IRQHandler(&huart3);
   /* USER CODE BEGIN USART3_IRQn 1 */
-
+  PROF_END(USART3);
   /* USER CODE END USART3_IRQn 1 */
 }
 
@@ -383,11 +401,11 @@ void USART3_IRQHandler(void)
 void OTG_FS_EP1_OUT_IRQHandler(void)
 {
   /* USER CODE BEGIN OTG_FS_EP1_OUT_IRQn 0 */
-
+  PROF_BEGIN(OTG_FS_EP1_OUT);
   /* USER CODE END OTG_FS_EP1_OUT_IRQn 0 */
   HAL_PCD_IRQHandler(&hpcd_USB_OTG_FS);
   /* USER CODE BEGIN OTG_FS_EP1_OUT_IRQn 1 */
-
+  PROF_END(OTG_FS_EP1_OUT);
   /* USER CODE END OTG_FS_EP1_OUT_IRQn 1 */
 }
 
@@ -397,11 +415,11 @@ void OTG_FS_EP1_OUT_IRQHandler(void)
 void OTG_FS_EP1_IN_IRQHandler(void)
 {
   /* USER CODE BEGIN OTG_FS_EP1_IN_IRQn 0 */
-
+  PROF_BEGIN(OTG_FS_EP1_IN);
   /* USER CODE END OTG_FS_EP1_IN_IRQn 0 */
   HAL_PCD_IRQHandler(&hpcd_USB_OTG_FS);
   /* USER CODE BEGIN OTG_FS_EP1_IN_IRQn 1 */
-
+  PROF_END(OTG_FS_EP1_IN);
   /* USER CODE END OTG_FS_EP1_IN_IRQn 1 */
 }
 
@@ -411,11 +429,11 @@ void OTG_FS_EP1_IN_IRQHandler(void)
 void OTG_FS_IRQHandler(void)
 {
   /* USER CODE BEGIN OTG_FS_IRQn 0 */
-
+  PROF_BEGIN(OTG_FS);
   /* USER CODE END OTG_FS_IRQn 0 */
   HAL_PCD_IRQHandler(&hpcd_USB_OTG_FS);
   /* USER CODE BEGIN OTG_FS_IRQn 1 */
-
+  PROF_END(OTG_FS);
   /* USER CODE END OTG_FS_IRQn 1 */
 }
 
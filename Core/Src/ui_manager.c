@@ -1,15 +1,18 @@
 #include "ui_manager.h"
 #include "ssd1309.h"
+#include "ui_widgets.h"
+#include "font_digits_cfg.h"
 #include "keyboard.h"
 #include "dispenser.h"
-#include "eeprom_at24.h"
+#include "config_store.h"
+#include "blog.h"
+#include "dwt_cycles.h"
+#include "deadline.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 
-extern void UsbLog_Printf(const char *fmt, ...);
-
 // ============================================================================
 // НОВАЯ ФУНКЦИЯ: Парсинг дробного числа "5.5" → 550 сантилитров
 // ============================================================================
@@ -58,7 +61,8 @@ static UI_State_t ui_state = UI_STATE_MAIN;
 static UI_State_t prev_transaction_mode = UI_STATE_INPUT_VOLUME;
 
 // Цены для каждого ведомого устройства
-static uint32_t global_prices[2] = {0, 0};  // prices for unit 0 and unit 1
+// Цена (коп/л) пистолета 1 ведомого u — хранится в настройках
+static uint32_t UnitPrice(uint8_t u) { return Config_Get()->price[u][0]; }
 
 #define INPUT_BUF_MAX_CHARS 10  // Максимум символов для ввода (не включая '\0')
 static char input_buf[INPUT_BUF_MAX_CHARS + 1];  // +1 для '\0'
@@ -78,38 +82,30 @@ static char error_message[32];
 static uint32_t error_display_start = 0;
 static uint32_t error_display_duration = 3000;  // 3 seconds
 
+// Экран операторского дисплея
+static UI_View_t ui_view;
+
+// Клиентские панели ведомых (disp == NULL -> панели нет)
+static UI_View_t unit_view[2];
+
+static UI_Stats_t ui_stats;
+static uint8_t debug_overlay = 0;
+static char overlay_text[9];
+
 // Forward declaration
 static void ShowErrorMessage(const char* msg);
 
 void UI_Init(void) {
+    UI_View_Init(&ui_view, &oled);
     Keyboard_Init();
-    Dispenser_Init();
-    
-    // Загрузка цен для обоих ведомых устройств
-    global_prices[0] = EEPROM_LoadPrice();  // Цена для ведомого 1
-    global_prices[1] = EEPROM_LoadPriceFromAddr(0x0004);  // Цена для ведомого 2
     
-    // Строгая валидация с диапазоном 0-9999 для обеих цен
+    // Из Boot_Task после Config_Init(); опрос ведомых к этому времени уже идёт
+    UI_SetDebugOverlay(Config_Get()->debug_overlay);
     for (int i = 0; i < 2; i++) {
-        if (global_prices[i] > 9999) {
-            UsbLog_Printf("WARNING: Invalid price for unit %d from EEPROM: %lu, using default 1100\r\n", 
-                         i + 1, (unsigned long)global_prices[i]);
-            global_prices[i] = 1100;
-            
-            // Сохраняем корректное значение обратно в EEPROM
-            if (i == 0) {
-                EEPROM_SavePrice(global_prices[i]);
-            } else {
-                EEPROM_SavePriceToAddr(0x0004, global_prices[i]);  // Второй адрес
-            }
-            
-            // Show error message to user
-            char error_msg[32];
-            snprintf(error_msg, sizeof(error_msg), "EEPROM ERR U%d", i + 1);
-            ShowErrorMessage(error_msg);
-        } else {
-            UsbLog_Printf("Loaded price for unit %d from EEPROM: %lu\r\n", i + 1, (unsigned long)global_prices[i]);
-        }
+        BLOG("Price for unit %d: %lu\r\n", i + 1, (unsigned long)UnitPrice(i));
+    }
+    if (Config_GetSource() == CONFIG_SRC_DEFAULTS) {
+        ShowErrorMessage("EEPROM DEFAULTS");
     }
     
     memset(input_buf, 0, sizeof(input_buf));
@@ -118,215 +114,179 @@ void UI_Init(void) {
     target_amount = 0;
 }
 
-static void DrawMain(void) {
-    char buf[20];
-    SSD1309_Clear(&oled);
-    
-    uint8_t active_unit = Dispenser_GetActiveUnit();
-    
-    // Отображение информации о первом ведомом устройстве (верхняя половина экрана)
-    DispenserUnit_t* unit0 = Dispenser_GetUnit(0);
-    if (unit0 && unit0->status == DS_CALLING) {
-        SSD1309_DrawString8x8(&oled, 112, 0, "*", SSD1309_COLOR_WHITE);
-    }
-    
-    if (active_unit == 0) {
-        SSD1309_DrawString8x8(&oled, 0, 0,  "[UNIT1]", SSD1309_COLOR_WHITE);  // Активный выделен скобками
-    } else {
-        SSD1309_DrawString8x8(&oled, 0, 0,  " UNIT1 ", SSD1309_COLOR_WHITE);  // Неактивный в пробелах
-    }
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 9, SSD1309_COLOR_WHITE);
-    }
-    sprintf(buf, "P:%u", (unsigned int)global_prices[0]);
-    SSD1309_DrawString8x8(&oled, 0, 16, buf, SSD1309_COLOR_WHITE);
-
-    // Отображение информации о втором ведомом устройстве (нижняя половина экрана)
-    DispenserUnit_t* unit1 = Dispenser_GetUnit(1);
-    if (unit1 && unit1->status == DS_CALLING) {
-        SSD1309_DrawString8x8(&oled, 112, 32, "*", SSD1309_COLOR_WHITE);
-    }
-    
-    if (active_unit == 1) {
-        SSD1309_DrawString8x8(&oled, 0, 32,  "[UNIT2]", SSD1309_COLOR_WHITE);  // Активный выделен скобками
-    } else {
-        SSD1309_DrawString8x8(&oled, 0, 32,  " UNIT2 ", SSD1309_COLOR_WHITE);  // Неактивный в пробелах
-    }
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 41, SSD1309_COLOR_WHITE);
-    }
-    sprintf(buf, "P:%u", (unsigned int)global_prices[1]);
-    SSD1309_DrawString8x8(&oled, 0, 48, buf, SSD1309_COLOR_WHITE);
-    
-    // Дополнительно показываем статус подключения
-    sprintf(buf, "U1:%c U2:%c", 
-        Dispenser_GetUnit(0)->is_connected ? 'C' : 'D',
-        Dispenser_GetUnit(1)->is_connected ? 'C' : 'D');
-    SSD1309_DrawString8x8(&oled, 0, 56, buf, SSD1309_COLOR_WHITE);
-
-    SSD1309_UpdateAsync(&oled);
-}
-
-static void DrawTotalizer(void) {
-    char buf[20];
-    SSD1309_Clear(&oled);
-    
-    uint8_t active_unit = Dispenser_GetActiveUnit();
-    DispenserUnit_t* unit = Dispenser_GetUnit(active_unit);
-    
-    sprintf(buf, "UNIT%d TOTALIZER", active_unit + 1);
-    SSD1309_DrawString8x8(&oled, 0, 0, buf, SSD1309_COLOR_WHITE);
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 9, SSD1309_COLOR_WHITE);
-    }
-    sprintf(buf, "TOT: %u.%02u", 
-        (unsigned int)(unit->totalizer / 100), 
-        (unsigned int)(unit->totalizer % 100));
-    SSD1309_DrawString8x8(&oled, 0, 24, buf, SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 48, "ESC: Back", SSD1309_COLOR_WHITE);
-    SSD1309_UpdateAsync(&oled);
-}
-
-static void DrawSetPrice(void) {
-    SSD1309_Clear(&oled);
-    
-    uint8_t active_unit = Dispenser_GetActiveUnit();
-    char input_buf_temp[16];
-    sprintf(input_buf_temp, "%u", (unsigned int)global_prices[active_unit]);
-    
-    char buf[20];
-    sprintf(buf, "SET PRICE U%d:", active_unit + 1);
-    SSD1309_DrawString8x8(&oled, 0, 0, buf, SSD1309_COLOR_WHITE);
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 9, SSD1309_COLOR_WHITE);
-    }
-    SSD1309_DrawString8x8(&oled, 0, 16, input_buf_temp, SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 32, "OK:OK RES:Clr", SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 48, "ESC:Exit", SSD1309_COLOR_WHITE);
-    SSD1309_UpdateAsync(&oled);
-}
-
-// ВСЁ ОСТАЁТСЯ КАК БЫЛО - БЕЗ ИЗМЕНЕНИЙ!
-static void DrawInputVolume(void) {
-    SSD1309_Clear(&oled);
-    
-    uint8_t active_unit = Dispenser_GetActiveUnit();
-    char buf[20];
-    sprintf(buf, "VOL U%d...", active_unit + 1);
-    SSD1309_DrawString8x8(&oled, 0, 0, buf, SSD1309_COLOR_WHITE);
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 9, SSD1309_COLOR_WHITE);
-    }
-
-    SSD1309_DrawString8x8(&oled, 0, 16, input_buf, SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 32, "OK:OK RES:Clr", SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 48, "ESC:Exit", SSD1309_COLOR_WHITE);
-    SSD1309_UpdateAsync(&oled);
-}
-
-// ВСЁ ОСТАЁТСЯ КАК БЫЛО - БЕЗ ИЗМЕНЕНИЙ!
-static void DrawInputAmount(void) {
-    SSD1309_Clear(&oled);
-    
-    uint8_t active_unit = Dispenser_GetActiveUnit();
-    char buf[20];
-    sprintf(buf, "AMT U%d...", active_unit + 1);
-    SSD1309_DrawString8x8(&oled, 0, 0, buf, SSD1309_COLOR_WHITE);
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 9, SSD1309_COLOR_WHITE);
-    }
-    SSD1309_DrawString8x8(&oled, 0, 16, input_buf, SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 32, "OK:OK RES:Clr", SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 48, "ESC:Exit", SSD1309_COLOR_WHITE);
-    SSD1309_UpdateAsync(&oled);
+// ============================================================================
+// Источники данных для виджетов (arg = индекс ведомого)
+// ============================================================================
+static uint32_t GetPrice(uint8_t u)     { return UnitPrice(u); }
+static uint32_t GetUnitNo(uint8_t u)    { return (uint32_t)u + 1u; }
+static uint32_t GetCalling(uint8_t u)   { return Dispenser_GetUnit(u)->status == DS_CALLING; }
+static uint32_t GetConnected(uint8_t u) { return Dispenser_GetUnit(u)->is_connected ? 1u : 0u; }
+static uint32_t GetVolume(uint8_t u)    { return Dispenser_GetUnit(u)->volume_cl; }
+static uint32_t GetAmount(uint8_t u)    { return Dispenser_GetUnit(u)->amount; }
+
+static uint32_t GetTotalizer(uint8_t u) {
+    uint64_t tot = Dispenser_GetUnit(u)->totalizer;
+    return (tot > 999999999u) ? 999999999u : (uint32_t)tot;
 }
 
-static void DrawFuelling(void) {
-    char buf[20];
-    SSD1309_Clear(&oled);
-    
-    uint8_t active_unit = Dispenser_GetActiveUnit();
-    DispenserUnit_t* unit = Dispenser_GetUnit(active_unit);
-    
-    const char* st = "????";
-    switch (unit->status) {
-        case DS_IDLE: st = "IDLE"; break;
-        case DS_CALLING: st = "CALL"; break;
-        case DS_AUTHORIZED: st = "AUTH"; break;
-        case DS_STARTED: st = "START"; break;
-        case DS_FUELLING: st = "FUEL"; break;
-        case DS_STOP: st = "STOP"; break;
-        case DS_END: st = "END"; break;
-        default: st = "WAIT"; break;
-    }
-    
-    sprintf(buf, "U%d-%s", active_unit + 1, st);
-    SSD1309_DrawString8x8(&oled, 0, 0, buf, SSD1309_COLOR_WHITE);
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 9, SSD1309_COLOR_WHITE);
-    }
-
-    sprintf(buf, "L:%u.%02u", 
-        (unsigned int)(unit->volume_cl / 100), 
-        (unsigned int)(unit->volume_cl % 100));
-    SSD1309_DrawString8x8(&oled, 0, 16, buf, SSD1309_COLOR_WHITE);
-    
-    sprintf(buf, "A:%u", (unsigned int)unit->amount);
-    SSD1309_DrawString8x8(&oled, 0, 32, buf, SSD1309_COLOR_WHITE);
-    
-    uint8_t progress_percent = 0;
+static uint32_t GetProgress(uint8_t u) {
+    DispenserUnit_t* unit = Dispenser_GetUnit(u);
+    uint32_t progress_percent = 0;
     if (prev_transaction_mode == UI_STATE_INPUT_VOLUME && target_volume_cl > 0) {
         progress_percent = (unit->volume_cl * 100) / target_volume_cl;
     } else if (prev_transaction_mode == UI_STATE_INPUT_AMOUNT && target_amount > 0) {
         progress_percent = (unit->amount * 100) / target_amount;
     }
-    if (progress_percent > 100) progress_percent = 100;
-    
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 56, SSD1309_COLOR_WHITE);
-        SSD1309_DrawPixel(&oled, x, 63, SSD1309_COLOR_WHITE);
-    }
-    for (int y = 56; y <= 63; y++) {
-        SSD1309_DrawPixel(&oled, 0, y, SSD1309_COLOR_WHITE);
-        SSD1309_DrawPixel(&oled, 127, y, SSD1309_COLOR_WHITE);
-    }
-    
-    uint8_t fill_width = (progress_percent * 125) / 100;
-    for (int x = 1; x <= fill_width && x < 127; x++) {
-        for (int y = 57; y <= 62; y++) {
-            SSD1309_DrawPixel(&oled, x, y, SSD1309_COLOR_WHITE);
-        }
-    }
-    
-    SSD1309_UpdateAsync(&oled);
+    return (progress_percent > 100) ? 100 : progress_percent;
 }
 
-static void DrawTransactionResult(void) {
-    char buf[20];
-    SSD1309_Clear(&oled);
-    
-    uint8_t active_unit = Dispenser_GetActiveUnit();
-    DispenserUnit_t* unit = Dispenser_GetUnit(active_unit);
-    
-    sprintf(buf, "TRANS END U%d", active_unit + 1);
-    SSD1309_DrawString8x8(&oled, 0, 0, buf, SSD1309_COLOR_WHITE);
-    for (int x = 0; x < 128; x++) {
-        SSD1309_DrawPixel(&oled, x, 9, SSD1309_COLOR_WHITE);
+static const char* GetUnitTitle(uint8_t u) {
+    // Активный выделен скобками, неактивный в пробелах
+    static const char* const titles[2][2] = {
+        { " UNIT1 ", "[UNIT1]" },
+        { " UNIT2 ", "[UNIT2]" }
+    };
+    return titles[u][Dispenser_GetActiveUnit() == u];
+}
+
+static const char* GetStatusName(uint8_t u) {
+    switch (Dispenser_GetUnit(u)->status) {
+        case DS_IDLE: return "IDLE";
+        case DS_CALLING: return "CALL";
+        case DS_AUTHORIZED: return "AUTH";
+        case DS_STARTED: return "START";
+        case DS_FUELLING: return "FUEL";
+        case DS_STOP: return "STOP";
+        case DS_END: return "END";
+        default: return "WAIT";
     }
-    
-    sprintf(buf, "L:%u.%02u", 
-        (unsigned int)(unit->volume_cl / 100), 
-        (unsigned int)(unit->volume_cl % 100));
-    SSD1309_DrawString8x8(&oled, 0, 16, buf, SSD1309_COLOR_WHITE);
-    
-    sprintf(buf, "A:%u", (unsigned int)unit->amount);
-    SSD1309_DrawString8x8(&oled, 0, 32, buf, SSD1309_COLOR_WHITE);
-    
-    SSD1309_DrawString8x8(&oled, 0, 48, "ESC:Repeat", SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 56, "RES:Menu", SSD1309_COLOR_WHITE);
-    SSD1309_UpdateAsync(&oled);
 }
 
+static const char* GetInputBuf(uint8_t u)     { (void)u; return input_buf; }
+static const char* GetErrorMessage(uint8_t u) { (void)u; return error_message; }
+
+// ============================================================================
+// Экраны (UI_ARG_VIEW = активный ведомый)
+// ============================================================================
+static const UI_Widget_t scr_main[] = {
+    UI_TEXT(0, 0, 56, GetUnitTitle, 0),
+    UI_ICON(112, 0, " *", GetCalling, 0),
+    UI_HLINE(9),
+    UI_LABEL(0, 16, "P:"),
+    UI_NUM8(16, 16, 4, 0, GetPrice, 0),
+
+    UI_TEXT(0, 32, 56, GetUnitTitle, 1),
+    UI_ICON(112, 32, " *", GetCalling, 1),
+    UI_HLINE(41),
+    UI_LABEL(0, 48, "P:"),
+    UI_NUM8(16, 48, 4, 0, GetPrice, 1),
+
+    // Статус подключения
+    UI_LABEL(0, 56, "U1:"),
+    UI_ICON(24, 56, "DC", GetConnected, 0),
+    UI_LABEL(40, 56, "U2:"),
+    UI_ICON(64, 56, "DC", GetConnected, 1),
+};
+
+static const UI_Widget_t scr_totalizer[] = {
+    UI_LABEL(0, 0, "UNIT"),
+    UI_NUM8(32, 0, 1, 0, GetUnitNo, UI_ARG_VIEW),
+    UI_LABEL(40, 0, " TOTALIZER"),
+    UI_HLINE(9),
+    UI_LABEL(0, 24, "TOT:"),
+    UI_NUM8(40, 24, 7, 2, GetTotalizer, UI_ARG_VIEW),
+    UI_LABEL(0, 48, "ESC: Back"),
+};
+
+static const UI_Widget_t scr_set_price[] = {
+    UI_LABEL(0, 0, "SET PRICE U"),
+    UI_NUM8(88, 0, 1, 0, GetUnitNo, UI_ARG_VIEW),
+    UI_LABEL(96, 0, ":"),
+    UI_HLINE(9),
+    UI_NUM8(0, 16, 4, 0, GetPrice, UI_ARG_VIEW),
+    UI_LABEL(0, 32, "OK:OK RES:Clr"),
+    UI_LABEL(0, 48, "ESC:Exit"),
+};
+
+static const UI_Widget_t scr_input_volume[] = {
+    UI_LABEL(0, 0, "VOL U"),
+    UI_NUM8(40, 0, 1, 0, GetUnitNo, UI_ARG_VIEW),
+    UI_LABEL(48, 0, "..."),
+    UI_HLINE(9),
+    UI_TEXT(0, 16, 128, GetInputBuf, 0),
+    UI_LABEL(0, 32, "OK:OK RES:Clr"),
+    UI_LABEL(0, 48, "ESC:Exit"),
+};
+
+static const UI_Widget_t scr_input_amount[] = {
+    UI_LABEL(0, 0, "AMT U"),
+    UI_NUM8(40, 0, 1, 0, GetUnitNo, UI_ARG_VIEW),
+    UI_LABEL(48, 0, "..."),
+    UI_HLINE(9),
+    UI_TEXT(0, 16, 128, GetInputBuf, 0),
+    UI_LABEL(0, 32, "OK:OK RES:Clr"),
+    UI_LABEL(0, 48, "ESC:Exit"),
+};
+
+// Крупные числа экранов ниже: 16x24, объём с точкой (font_digits.h)
+_Static_assert(FONT_DIGITS_16X24, "UI_BIGNUM screens need FONT_DIGITS_16X24");
+_Static_assert(FONT_DIGITS_HAS_DOT, "UI_BIGNUM with decimals needs FONT_DIGITS_HAS_DOT");
+
+// Разметка: стр.0 - заголовок, стр.1-3 - объём, стр.4-6 - сумма, стр.7 - прогресс
+static const UI_Widget_t scr_fuelling[] = {
+    UI_LABEL(0, 0, "U"),
+    UI_NUM8(8, 0, 1, 0, GetUnitNo, UI_ARG_VIEW),
+    UI_LABEL(16, 0, "-"),
+    UI_TEXT(24, 0, 40, GetStatusName, UI_ARG_VIEW),
+    UI_LABEL(0, 16, "L"),
+    UI_BIGNUM(16, 1, SSD1309_FONT_16X24, 3, 2, GetVolume, UI_ARG_VIEW),
+    UI_LABEL(0, 40, "A"),
+    UI_BIGNUM(16, 4, SSD1309_FONT_16X24, 6, 0, GetAmount, UI_ARG_VIEW),
+    UI_BAR(0, 56, 128, 8, GetProgress, UI_ARG_VIEW),
+};
+
+static const UI_Widget_t scr_transaction_result[] = {
+    UI_LABEL(0, 0, "TRANS END U"),
+    UI_NUM8(88, 0, 1, 0, GetUnitNo, UI_ARG_VIEW),
+    UI_LABEL(0, 16, "L"),
+    UI_BIGNUM(16, 1, SSD1309_FONT_16X24, 3, 2, GetVolume, UI_ARG_VIEW),
+    UI_LABEL(0, 40, "A"),
+    UI_BIGNUM(16, 4, SSD1309_FONT_16X24, 6, 0, GetAmount, UI_ARG_VIEW),
+    UI_LABEL(0, 56, "ESC:Rep RES:Menu"),
+};
+
+static const UI_Widget_t scr_error_message[] = {
+    UI_LABEL(0, 8, "ERROR"),
+    UI_TEXT(0, 32, 128, GetErrorMessage, 0),
+    UI_LABEL(0, 56, "Press any key..."),
+};
+
+// Клиентская панель: тот же налив, но всегда своего ведомого и без клавиатурных подсказок
+static const UI_Widget_t scr_unit_panel[] = {
+    UI_LABEL(0, 0, "COLUMN"),
+    UI_NUM8(56, 0, 1, 0, GetUnitNo, UI_ARG_VIEW),
+    UI_TEXT(80, 0, 48, GetStatusName, UI_ARG_VIEW),
+    UI_LABEL(0, 16, "L"),
+    UI_BIGNUM(16, 1, SSD1309_FONT_16X24, 3, 2, GetVolume, UI_ARG_VIEW),
+    UI_LABEL(0, 40, "A"),
+    UI_BIGNUM(16, 4, SSD1309_FONT_16X24, 6, 0, GetAmount, UI_ARG_VIEW),
+    UI_LABEL(0, 56, "PRICE"),
+    UI_NUM8(56, 56, 4, 0, GetPrice, UI_ARG_VIEW),
+};
+
+static const UI_Screen_t unit_panel_screen = UI_SCREEN(scr_unit_panel);
+
+static const UI_Screen_t ui_screens[] = {
+    [UI_STATE_MAIN]               = UI_SCREEN(scr_main),
+    [UI_STATE_TOTALIZER]          = UI_SCREEN(scr_totalizer),
+    [UI_STATE_SET_PRICE]          = UI_SCREEN(scr_set_price),
+    [UI_STATE_INPUT_VOLUME]       = UI_SCREEN(scr_input_volume),
+    [UI_STATE_INPUT_AMOUNT]       = UI_SCREEN(scr_input_amount),
+    [UI_STATE_FUELLING]           = UI_SCREEN(scr_fuelling),
+    [UI_STATE_TRANSACTION_RESULT] = UI_SCREEN(scr_transaction_result),
+    [UI_STATE_ERROR_MESSAGE]      = UI_SCREEN(scr_error_message),
+};
+
 // Функция для отображения сообщения об ошибке
 void ShowErrorMessage(const char* msg) {
     strncpy(error_message, msg, sizeof(error_message) - 1);
@@ -335,18 +295,10 @@ void ShowErrorMessage(const char* msg) {
     ui_state = UI_STATE_ERROR_MESSAGE;
 }
 
-static void DrawErrorMessage(void) {
-    SSD1309_Clear(&oled);
-    SSD1309_DrawString8x8(&oled, 0, 8, "ERROR", SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 32, error_message, SSD1309_COLOR_WHITE);
-    SSD1309_DrawString8x8(&oled, 0, 56, "Press any key...", SSD1309_COLOR_WHITE);
-    SSD1309_UpdateAsync(&oled);
-}
-
 void UI_ProcessInput(void) {
     char key = Keyboard_GetKey();
     if (key != 0) {
-        UsbLog_Printf("Key: %c\r\n", key);
+        BLOG("Key: %c\r\n", key);
     }
     
     switch (ui_state) {
@@ -372,11 +324,11 @@ void UI_ProcessInput(void) {
             } else if (key == 'D') {
                 // Выбор ведомого 1 (0-indexed)
                 Dispenser_SwitchActiveUnit(0);
-                UsbLog_Printf("Selected UNIT1\r\n");
+                BLOG("Selected UNIT1\r\n");
             } else if (key == 'H') {
                 // Выбор ведомого 2 (1-indexed)
                 Dispenser_SwitchActiveUnit(1);
-                UsbLog_Printf("Selected UNIT2\r\n");
+                BLOG("Selected UNIT2\r\n");
             }
             break;
             
@@ -396,16 +348,13 @@ void UI_ProcessInput(void) {
                 uint8_t active_unit = Dispenser_GetActiveUnit();
                 uint32_t new_price = atol(input_buf);
                 if (new_price <= 9999) {
-                    global_prices[active_unit] = new_price;
-                    if (active_unit == 0) {
-                        EEPROM_SavePrice(global_prices[active_unit]);
-                    } else {
-                        EEPROM_SavePriceToAddr(0x0004, global_prices[active_unit]);
+                    if (Config_SetPrice(active_unit, 0, new_price) != HAL_OK) {
+                        BLOG("ERROR: price for UNIT%d not saved\r\n", active_unit + 1);
                     }
-                    UsbLog_Printf("Price for UNIT%d set to: %lu\r\n", active_unit + 1, (unsigned long)global_prices[active_unit]);
+                    BLOG("Price for UNIT%d set to: %lu\r\n", active_unit + 1, (unsigned long)UnitPrice(active_unit));
                     ui_state = UI_STATE_MAIN;
                 } else {
-                    UsbLog_Printf("ERROR: Price must be 0-9999, got: %lu\r\n", (unsigned long)new_price);
+                    BLOG("ERROR: Price must be 0-9999, got: %lu\r\n", (unsigned long)new_price);
                     char error_msg[32];
                     snprintf(error_msg, sizeof(error_msg), "Price 0-9999");
                     ShowErrorMessage(error_msg);
@@ -438,7 +387,7 @@ void UI_ProcessInput(void) {
                 uint32_t volume_cl = ParseDecimalVolume(input_buf);
                 if (volume_cl > 0) {
                     // Рассчитываем динамический лимит объёма на основе цены
-                    uint32_t max_volume_by_price = (999900 * 100) / global_prices[active_unit];  // 999900 коп / цена в коп
+                    uint32_t max_volume_by_price = (999900 * 100) / UnitPrice(active_unit);  // 999900 коп / цена в коп
                     uint32_t max_volume_limit = (max_volume_by_price < 90000) ? max_volume_by_price : 90000;
                     
                     if (volume_cl <= max_volume_limit) {
@@ -446,13 +395,13 @@ void UI_ProcessInput(void) {
                         target_amount = 0;
                         Dispenser_GetUnit(active_unit)->transaction_closed = 0;
                         fuelling_entry_tick = HAL_GetTick();
-                        Dispenser_StartVolume(active_unit, 1, volume_cl, global_prices[active_unit]);
+                        Dispenser_StartVolume(active_unit, 1, volume_cl, UnitPrice(active_unit));
                         ui_state = UI_STATE_FUELLING;
                     } else {
-                        UsbLog_Printf("ERROR: Volume %u.%02u L exceeds max %u.%02u L (price %u.%02u)\r\n", 
+                        BLOG("ERROR: Volume %u.%02u L exceeds max %u.%02u L (price %u.%02u)\r\n", 
                             (unsigned int)(volume_cl/100), (unsigned int)(volume_cl%100),
                             (unsigned int)(max_volume_limit/100), (unsigned int)(max_volume_limit%100),
-                            (unsigned int)(global_prices[active_unit]/100), (unsigned int)(global_prices[active_unit]%100));
+                            (unsigned int)(UnitPrice(active_unit)/100), (unsigned int)(UnitPrice(active_unit)%100));
                         char error_msg[32];
                         snprintf(error_msg, sizeof(error_msg), "Max %u.%02u L", 
                             (unsigned int)(max_volume_limit/100), (unsigned int)(max_volume_limit%100));
@@ -480,7 +429,7 @@ void UI_ProcessInput(void) {
                 uint32_t amount = atol(input_buf);
                 if (amount > 0) {
                     // Рассчитываем динамический лимит суммы на основе цены и максимального объёма
-                    uint32_t max_amount_by_volume = (90000 * global_prices[active_unit]) / 100;  // 900.00 л * цена в копейках
+                    uint32_t max_amount_by_volume = (90000 * UnitPrice(active_unit)) / 100;  // 900.00 л * цена в копейках
                     uint32_t max_amount_limit = (max_amount_by_volume < 999900) ? max_amount_by_volume : 999900;
                     
                     if (amount <= max_amount_limit) {
@@ -488,12 +437,12 @@ void UI_ProcessInput(void) {
                         target_volume_cl = 0;
                         Dispenser_GetUnit(active_unit)->transaction_closed = 0;
                         fuelling_entry_tick = HAL_GetTick();
-                        Dispenser_StartAmount(active_unit, 1, amount, global_prices[active_unit]);
+                        Dispenser_StartAmount(active_unit, 1, amount, UnitPrice(active_unit));
                         ui_state = UI_STATE_FUELLING;
                     } else {
-                        UsbLog_Printf("ERROR: Amount %lu exceeds max %lu (price %u.%02u, max vol %u.%02u L)\r\n", 
+                        BLOG("ERROR: Amount %lu exceeds max %lu (price %u.%02u, max vol %u.%02u L)\r\n", 
                             (unsigned long)amount, (unsigned long)max_amount_limit,
-                            (unsigned int)(global_prices[active_unit]/100), (unsigned int)(global_prices[active_unit]%100),
+                            (unsigned int)(UnitPrice(active_unit)/100), (unsigned int)(UnitPrice(active_unit)%100),
                             (unsigned int)(90000/100), (unsigned int)(90000%100));
                         char error_msg[32];
                         snprintf(error_msg, sizeof(error_msg), "Max %lu", (unsigned long)max_amount_limit);
@@ -513,8 +462,9 @@ void UI_ProcessInput(void) {
                 uint8_t active_unit = Dispenser_GetActiveUnit();
                 DispenserUnit_t* unit = Dispenser_GetUnit(active_unit);
                 
+                Deadline_At(fuelling_entry_tick + FUELLING_TIMEOUT_MS + 1u);
                 if ((HAL_GetTick() - fuelling_entry_tick) > FUELLING_TIMEOUT_MS) {
-                    UsbLog_Printf("Fuelling timeout\r\n");
+                    BLOG("Fuelling timeout\r\n");
                     if (!unit->transaction_closed && (unit->volume_cl > 0 || unit->amount > 0)) {
                         Dispenser_CloseTransaction(active_unit);
                         unit->transaction_closed = 1;
@@ -526,7 +476,7 @@ void UI_ProcessInput(void) {
                 
                 if (unit->status == DS_IDLE || unit->status == DS_CALLING) {
                     if (unit->volume_cl > 0 || unit->amount > 0) {
-                        UsbLog_Printf("Dispenser returned to IDLE/CALLING with data\r\n");
+                        BLOG("Dispenser returned to IDLE/CALLING with data\r\n");
                         if (!unit->transaction_closed) {
                             Dispenser_CloseTransaction(active_unit);
                             unit->transaction_closed = 1;
@@ -538,7 +488,7 @@ void UI_ProcessInput(void) {
                 }
                 else if (unit->status == DS_END) {
                     if (!unit->transaction_closed) {
-                        UsbLog_Printf("Transaction END detected\r\n");
+                        BLOG("Transaction END detected\r\n");
                         Dispenser_CloseTransaction(active_unit);
                         unit->transaction_closed = 1;
                         transaction_end_tick = HAL_GetTick();
@@ -548,7 +498,7 @@ void UI_ProcessInput(void) {
                 }
                 
                 if (key == 'F') {
-                    UsbLog_Printf("Manual exit from fuelling\r\n");
+                    BLOG("Manual exit from fuelling\r\n");
                     ui_state = UI_STATE_MAIN;
                     unit->transaction_closed = 0;
                 }
@@ -560,6 +510,7 @@ void UI_ProcessInput(void) {
                 uint8_t active_unit = Dispenser_GetActiveUnit();
                 DispenserUnit_t* unit = Dispenser_GetUnit(active_unit);
                 
+                Deadline_At(transaction_end_tick + 30001u);
                 if ((HAL_GetTick() - transaction_end_tick) > 30000) {
                     ui_state = UI_STATE_MAIN;
                     unit->transaction_closed = 0;
@@ -585,42 +536,133 @@ void UI_ProcessInput(void) {
     }
 }
 
-void UI_Draw(void) {
+// Поверх виджетов: перерисовка, если изменился текст или виджет под ним стёр его
+static void DrawDebugOverlay(uint8_t force) {
+    const SSD1309_Stats_t* st = SSD1309_GetStats(&oled);
+    uint32_t xfer_us = DWT_CyclesToUs(st->xfer_cycles_last);
+    uint32_t render_us = DWT_CyclesToUs(ui_stats.render_cycles_last);
+    char text[sizeof(overlay_text)];
+
+    snprintf(text, sizeof(text), "%4lu/%3lu",
+             (unsigned long)(xfer_us > 9999u ? 9999u : xfer_us),
+             (unsigned long)(render_us > 999u ? 999u : render_us));
+
+    if (!force && strcmp(text, overlay_text) == 0) return;
+    memcpy(overlay_text, text, sizeof(overlay_text));
+
+    SSD1309_FillRect(&oled, 64, 56, 64, 8, SSD1309_COLOR_BLACK);
+    SSD1309_DrawString8x8(&oled, 64, 56, overlay_text, SSD1309_COLOR_WHITE);
+}
+
+// Шаг отрисовки для планировщика: уступка после каждого перерисованного
+// виджета. Пока кадр не дорисован, панель держится SSD1309_Hold — передача
+// начнётся только с SSD1309_UpdateAsync в последнем шаге кадра
+static uint8_t draw_w;
+static uint8_t draw_redrawn;
+static uint32_t draw_cycles;        // рендер кадра без чужих шагов между уступками
+static uint32_t draw_t0;
+
+#define DRAW_YIELD(t) do {                          \
+        draw_cycles += DWT_Cycles() - draw_t0;      \
+        PT_YIELD(t);                                \
+        draw_t0 = DWT_Cycles();                     \
+    } while (0)
+
+uint8_t UI_DrawTask(Sched_Task_t *t) {
+    static uint8_t u;
     uint32_t now = HAL_GetTick();
-    
+
+    PT_BEGIN(t);
+
     if (now - last_ui_draw_tick < 33) { 
-        return;
+        Deadline_At(last_ui_draw_tick + 33u);
+        PT_EXIT(t);
     }
     last_ui_draw_tick = now;
+    Deadline_At(now + 33u);
+    draw_t0 = DWT_Cycles();
+    draw_cycles = 0u;
+
+    // Смена экрана -> полная отрисовка, иначе только изменившиеся виджеты
+    ui_view.unit = Dispenser_GetActiveUnit();
+    if (ui_view.screen != &ui_screens[ui_state]) {
+        UI_View_Begin(&ui_view, &ui_screens[ui_state]);
+    }
+    SSD1309_Hold(&oled);
+
+    // Экран и его число виджетов могут смениться между шагами (ввод, 'O'):
+    // кадр доводится по старому, новый экран — со следующего кадра
+    draw_redrawn = 0u;
+    for (draw_w = 0; draw_w < UI_View_Count(&ui_view); draw_w++) {
+        if (!UI_View_RefreshWidget(&ui_view, draw_w)) continue;
+        draw_redrawn++;
+        DRAW_YIELD(t);
+    }
 
-    switch (ui_state) {
-        case UI_STATE_MAIN:
-            DrawMain();
-            break;
-        case UI_STATE_TOTALIZER:
-            DrawTotalizer();
-            break;
-        case UI_STATE_SET_PRICE:
-            DrawSetPrice();
-            break;
-        case UI_STATE_INPUT_VOLUME:
-            DrawInputVolume();
-            break;
-        case UI_STATE_INPUT_AMOUNT:
-            DrawInputAmount();
-            break;
-        case UI_STATE_FUELLING:
-            DrawFuelling();
-            break;
-        case UI_STATE_TRANSACTION_RESULT:
-            DrawTransactionResult();
-            break;
-        case UI_STATE_ERROR_MESSAGE:
-            DrawErrorMessage();
-            // Автоматический возврат после таймаута или при нажатии любой клавиши
-            if ((now - error_display_start) > error_display_duration) {
-                ui_state = UI_STATE_MAIN;
-            }
-            break;
+    if (debug_overlay) {
+        DrawDebugOverlay(draw_redrawn != 0);
     }
+
+    uint32_t cyc = draw_cycles + (DWT_Cycles() - draw_t0);
+    ui_stats.renders++;
+    ui_stats.widgets += draw_redrawn;
+    ui_stats.render_cycles_last = cyc;
+    if (cyc > ui_stats.render_cycles_max) ui_stats.render_cycles_max = cyc;
+
+    // Автоматический возврат после таймаута или при нажатии любой клавиши
+    if (ui_state == UI_STATE_ERROR_MESSAGE && (now - error_display_start) > error_display_duration) {
+        ui_state = UI_STATE_MAIN;
+    }
+
+    // Уходят только изменённые страницы; если ничего не менялось — передачи нет
+    SSD1309_UpdateAsync(&oled);
+
+    // Клиентские панели: framebuffer свой, шину делит SSD1309_Bus_Task()
+    for (u = 0; u < 2; u++) {
+        if (unit_view[u].disp == NULL) continue;
+        if (unit_view[u].screen == NULL) {
+            UI_View_Begin(&unit_view[u], &unit_panel_screen);
+        }
+        SSD1309_Hold(unit_view[u].disp);
+
+        for (draw_w = 0; draw_w < UI_View_Count(&unit_view[u]); draw_w++) {
+            if (UI_View_RefreshWidget(&unit_view[u], draw_w)) PT_YIELD(t);
+        }
+        SSD1309_UpdateAsync(unit_view[u].disp);
+    }
+
+    PT_END(t);
+}
+
+// Все шаги сразу: без планировщика (хостовые замеры)
+void UI_Draw(void) {
+    Sched_Task_t t = SCHED_STEP("ui_draw", UI_DrawTask, SCHED_PRIO_RENDER, SCHED_NO_ZONE);
+    while (UI_DrawTask(&t) == SCHED_YIELD) { }
+}
+
+const UI_Screen_t* UI_GetScreen(UI_State_t state) {
+    if ((unsigned)state >= sizeof(ui_screens) / sizeof(ui_screens[0])) return NULL;
+    return &ui_screens[state];
+}
+
+const UI_Stats_t* UI_GetStats(void) {
+    return &ui_stats;
+}
+
+void UI_ResetStats(void) {
+    memset(&ui_stats, 0, sizeof(ui_stats));
+}
+
+void UI_SetDebugOverlay(uint8_t on) {
+    on = on ? 1u : 0u;
+    if (on == debug_overlay) return;
+    debug_overlay = on;
+    overlay_text[0] = '\0';
+    ui_view.screen = NULL;  // полная перерисовка: показать или стереть строку
+}
+
+void UI_AttachUnitPanel(uint8_t unit, SSD1309_t *disp) {
+    if (unit >= 2) return;
+    UI_View_Init(&unit_view[unit], disp);
+    unit_view[unit].unit = unit;
 }
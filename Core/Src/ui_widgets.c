@@ -0,0 +1,160 @@
+#include "ui_widgets.h"
+#include <string.h>
+
+static uint8_t widget_arg(const UI_View_t *v, const UI_Widget_t *w)
+{
+    return (w->arg == UI_ARG_VIEW) ? v->unit : w->arg;
+}
+
+static void clear_rect(UI_View_t *v, const UI_Widget_t *w)
+{
+    SSD1309_FillRect(v->disp, w->x, w->y, w->w, w->h, SSD1309_COLOR_BLACK);
+}
+
+static void draw_number(UI_View_t *v, const UI_Widget_t *w, UI_WidgetState_t *st, uint32_t value)
+{
+    if (w->font == UI_FONT_8X8) {
+        char buf[SSD1309_NUM_MAX_SLOTS + 1u];
+        if (SSD1309_FormatFixed(buf, (uint8_t)sizeof(buf), value, w->int_digits, w->decimals) == 0u) return;
+        clear_rect(v, w);
+        SSD1309_DrawString8x8(v->disp, w->x, w->y, buf, SSD1309_COLOR_WHITE);
+        return;
+    }
+
+    /* крупный шрифт: поле само перерисует только изменившиеся знакоместа */
+    SSD1309_NumField_t *f = &st->u.num;
+    if (!st->valid) {
+        f->x = w->x;
+        f->page = (uint8_t)(w->y >> 3);
+        f->font = w->font;
+        f->int_digits = w->int_digits;
+        f->decimals = w->decimals;
+        SSD1309_NumField_Invalidate(f);
+    }
+    SSD1309_DrawNumber(v->disp, f, value);
+}
+
+static void draw_bar(UI_View_t *v, const UI_Widget_t *w, uint32_t percent)
+{
+    if (percent > 100u) percent = 100u;
+
+    clear_rect(v, w);
+
+    /* рамка */
+    SSD1309_FillRect(v->disp, w->x, w->y, w->w, 1u, SSD1309_COLOR_WHITE);
+    SSD1309_FillRect(v->disp, w->x, (uint16_t)(w->y + w->h - 1u), w->w, 1u, SSD1309_COLOR_WHITE);
+    SSD1309_FillRect(v->disp, w->x, w->y, 1u, w->h, SSD1309_COLOR_WHITE);
+    SSD1309_FillRect(v->disp, (uint16_t)(w->x + w->w - 1u), w->y, 1u, w->h, SSD1309_COLOR_WHITE);
+
+    uint16_t fill = (uint16_t)(((uint32_t)(w->w - 2u) * percent) / 100u);
+    SSD1309_FillRect(v->disp, (uint16_t)(w->x + 1u), (uint16_t)(w->y + 1u), fill, (uint16_t)(w->h - 2u),
+                     SSD1309_COLOR_WHITE);
+}
+
+/* 1 — виджет перерисован */
+static uint8_t refresh_widget(UI_View_t *v, const UI_Widget_t *w, UI_WidgetState_t *st)
+{
+    uint8_t arg = widget_arg(v, w);
+
+    switch ((UI_WidgetType_t)w->type) {
+    case UI_W_LABEL:
+        if (st->valid) return 0u;
+        SSD1309_DrawString8x8(v->disp, w->x, w->y, w->text, SSD1309_COLOR_WHITE);
+        break;
+
+    case UI_W_HLINE:
+        if (st->valid) return 0u;
+        SSD1309_FillRect(v->disp, w->x, w->y, w->w, 1u, SSD1309_COLOR_WHITE);
+        break;
+
+    case UI_W_TEXT: {
+        const char *t = (w->get_text != NULL) ? w->get_text(arg) : NULL;
+        if (t == NULL) t = "";
+        if (st->valid && strncmp(st->u.text, t, UI_TEXT_MAX) == 0) return 0u;
+
+        strncpy(st->u.text, t, UI_TEXT_MAX);
+        st->u.text[UI_TEXT_MAX] = '\0';
+        clear_rect(v, w);
+        SSD1309_DrawString8x8(v->disp, w->x, w->y, st->u.text, SSD1309_COLOR_WHITE);
+        break;
+    }
+
+    case UI_W_NUMBER: {
+        uint32_t value = (w->get != NULL) ? w->get(arg) : 0u;
+        if (st->valid && st->value == value) return 0u;
+
+        draw_number(v, w, st, value);
+        st->value = value;
+        break;
+    }
+
+    case UI_W_ICON: {
+        uint32_t value = (w->get != NULL) ? w->get(arg) : 0u;
+        if (st->valid && st->value == value) return 0u;
+
+        char ch = (value < strlen(w->text)) ? w->text[value] : '?';
+        clear_rect(v, w);
+        SSD1309_DrawChar8x8(v->disp, w->x, w->y, ch, SSD1309_COLOR_WHITE);
+        st->value = value;
+        break;
+    }
+
+    case UI_W_BAR: {
+        uint32_t value = (w->get != NULL) ? w->get(arg) : 0u;
+        if (st->valid && st->value == value) return 0u;
+
+        draw_bar(v, w, value);
+        st->value = value;
+        break;
+    }
+
+    default:
+        return 0u;
+    }
+
+    st->valid = 1u;
+    return 1u;
+}
+
+void UI_View_Init(UI_View_t *v, SSD1309_t *disp)
+{
+    memset(v, 0, sizeof(*v));
+    v->disp = disp;
+}
+
+void UI_View_Begin(UI_View_t *v, const UI_Screen_t *scr)
+{
+    v->screen = scr;
+    memset(v->state, 0, sizeof(v->state));
+
+    SSD1309_Clear(v->disp);
+}
+
+void UI_View_Show(UI_View_t *v, const UI_Screen_t *scr)
+{
+    UI_View_Begin(v, scr);
+    (void)UI_View_Refresh(v);
+}
+
+uint8_t UI_View_Count(const UI_View_t *v)
+{
+    if (v->screen == NULL) return 0u;
+    return (v->screen->count > UI_MAX_WIDGETS) ? (uint8_t)UI_MAX_WIDGETS : v->screen->count;
+}
+
+uint8_t UI_View_RefreshWidget(UI_View_t *v, uint8_t i)
+{
+    if (i >= UI_View_Count(v)) return 0u;
+    return refresh_widget(v, &v->screen->widgets[i], &v->state[i]);
+}
+
+uint8_t UI_View_Refresh(UI_View_t *v)
+{
+    uint8_t count = UI_View_Count(v);
+
+    uint8_t redrawn = 0u;
+    for (uint8_t i = 0; i < count; i++) {
+        redrawn = (uint8_t)(redrawn + refresh_widget(v, &v->screen->widgets[i], &v->state[i]));
+    }
+    return redrawn;
+}
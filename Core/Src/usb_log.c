@@ -0,0 +1,271 @@
+#include "usb_log.h"
+#include "main.h"
+#include "usbd_cdc_if.h"
+#include "blog.h"
+#include "mem_layout.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RING_MASK  (USBLOG_RING_SZ - 1u)
+#define SLOT_MASK  (USBLOG_MSG_SLOTS - 1u)
+
+/*
+ * Позиции — 16-битные счётчики байт, номера сообщений — 8-битные, оба
+ * сравниваются через разность по модулю.
+ *
+ * res_state (писатели):  head[15:0] | msg[23:16] | writers[31:24]
+ * commit_state:          wr[15:0]   | wr_msg[23:16]   — всё до wr записано
+ * rd_state (читатель):   rd[15:0]   | rd_msg[23:16] | MID | INFLIGHT
+ *   rd     — начало непереданных данных (при INFLIGHT — начало передачи);
+ *   rd_msg — первое сообщение, переданное не полностью;
+ *   MID    — rd внутри сообщения rd_msg (передача оборвалась посреди него).
+ */
+#define ST_POS(s)     ((uint16_t)(s))
+#define ST_MSG(s)     ((uint8_t)((s) >> 16))
+#define ST_WRITERS(s) ((uint8_t)((s) >> 24))
+#define WRITER_ONE    (1u << 24)
+#define RD_MID        (1u << 30)
+#define RD_INFLIGHT   (1u << 31)
+
+/* USB FS работает без DMA: кольцо можно держать в DTCM */
+static uint8_t ring[USBLOG_RING_SZ] DTCM_BSS;
+static uint16_t msg_end[USBLOG_MSG_SLOTS] DTCM_BSS;   /* позиция конца сообщения */
+
+static volatile uint32_t res_state = 0;
+static volatile uint32_t commit_state = 0;
+static volatile uint32_t rd_state = 0;
+static volatile uint16_t tx_len = 0;
+static volatile uint8_t policy = USBLOG_POLICY;
+
+static volatile UsbLog_Stats_t stats;
+static UsbLog_Stats_t reported;
+
+static inline uint32_t Pack(uint16_t pos, uint8_t msg)
+{
+    return (uint32_t)pos | ((uint32_t)msg << 16);
+}
+
+static void AtomicAdd(volatile uint32_t *p, uint32_t v)
+{
+    do {
+        uint32_t x = __LDREXW(p);
+        if (__STREXW(x + v, p) == 0u) return;
+    } while (1);
+}
+
+/* Вытеснить старейшее сообщение, если оно целиком ещё не отдано в USB */
+static uint8_t DiscardOldest(void)
+{
+    for (;;) {
+        uint32_t r = __LDREXW(&rd_state);
+        uint32_t c = commit_state;
+        if ((r & (RD_INFLIGHT | RD_MID)) || ST_MSG(r) == ST_MSG(c)) {
+            __CLREX();
+            return 0;
+        }
+        uint16_t end = msg_end[ST_MSG(r) & SLOT_MASK];
+        if (__STREXW(Pack(end, (uint8_t)(ST_MSG(r) + 1u)), &rd_state) == 0u) {
+            AtomicAdd(&stats.overwritten_msgs, 1u);
+            AtomicAdd(&stats.overwritten_bytes, (uint16_t)(end - ST_POS(r)));
+            return 1;
+        }
+    }
+}
+
+static uint8_t Reserve(uint16_t len, uint16_t *pos, uint8_t *msg)
+{
+    for (;;) {
+        uint32_t s = __LDREXW(&res_state);
+        uint32_t r = rd_state;
+        uint16_t used = (uint16_t)(ST_POS(s) - ST_POS(r));
+        uint8_t msgs = (uint8_t)(ST_MSG(s) - ST_MSG(r));
+
+        if (len > USBLOG_RING_SZ - used || msgs >= USBLOG_MSG_SLOTS) {
+            __CLREX();
+            if (policy == USBLOG_DROP_OLDEST && DiscardOldest()) continue;
+            return 0;
+        }
+
+        uint32_t n = Pack((uint16_t)(ST_POS(s) + len), (uint8_t)(ST_MSG(s) + 1u)) |
+                     ((uint32_t)(ST_WRITERS(s) + 1u) << 24);
+        if (__STREXW(n, &res_state) == 0u) {
+            *pos = ST_POS(s);
+            *msg = ST_MSG(s);
+            return 1;
+        }
+    }
+}
+
+/* commit_state только растёт: более старая граница не затирает новую */
+static void Publish(uint32_t wr)
+{
+    for (;;) {
+        uint32_t c = __LDREXW(&commit_state);
+        if ((int16_t)(ST_POS(wr) - ST_POS(c)) <= 0) {
+            __CLREX();
+            return;
+        }
+        if (__STREXW(wr, &commit_state) == 0u) return;
+    }
+}
+
+static void Commit(uint16_t pos, uint8_t msg, uint16_t len)
+{
+    msg_end[msg & SLOT_MASK] = (uint16_t)(pos + len);
+    __DMB();   /* данные и граница сообщения видны раньше, чем уменьшится writers */
+
+    for (;;) {
+        uint32_t s = __LDREXW(&res_state);
+        uint32_t n = s - WRITER_ONE;
+        if (__STREXW(n, &res_state) == 0u) {
+            /* Последний писатель: всё зарезервированное до head уже записано.
+               Вложенные писатели (ISR поверх main loop) завершаются раньше внешнего */
+            if (ST_WRITERS(n) == 0u) Publish(n & 0x00FFFFFFu);
+            return;
+        }
+    }
+}
+
+void UsbLog_Write(const uint8_t *data, uint16_t len)
+{
+    uint16_t pos;
+    uint8_t msg;
+
+    if (len == 0u) return;
+    if (!Reserve(len, &pos, &msg)) {
+        AtomicAdd(&stats.dropped_msgs, 1u);
+        AtomicAdd(&stats.dropped_bytes, len);
+        return;
+    }
+
+    uint16_t off = pos & RING_MASK;
+    uint16_t first = (uint16_t)(USBLOG_RING_SZ - off);
+    if (first > len) first = len;
+    memcpy(&ring[off], data, first);
+    memcpy(ring, data + first, (size_t)(len - first));
+
+    Commit(pos, msg, len);
+}
+
+void UsbLog_Printf(const char *fmt, ...)
+{
+    char tmp[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+
+    if (n <= 0) return;
+    if ((size_t)n > sizeof(tmp)) n = (int)sizeof(tmp);
+    UsbLog_Write((const uint8_t *)tmp, (uint16_t)n);
+}
+
+/* ---------- Читатель: USB ISR (и main loop при остановленной цепочке) ---------- */
+
+/* Переданный участок освобождается; rd_msg проходит полностью переданные сообщения.
+   Пока стоит INFLIGHT, rd_state меняет только читатель */
+ITCM_CODE static void Advance(uint16_t len)
+{
+    uint32_t r = rd_state;
+    uint32_t c = commit_state;
+    uint16_t rd = (uint16_t)(ST_POS(r) + len);
+    uint8_t rd_msg = ST_MSG(r);
+    uint8_t boundary = !(r & RD_MID) && len == 0u;
+
+    while (rd_msg != ST_MSG(c)) {
+        uint16_t end = msg_end[rd_msg & SLOT_MASK];
+        if ((int16_t)(end - rd) > 0) break;
+        boundary = (end == rd);
+        rd_msg++;
+    }
+    rd_state = Pack(rd, rd_msg) | (boundary ? 0u : RD_MID);
+}
+
+ITCM_CODE static void StartTx(void)
+{
+    uint32_t r;
+    uint16_t len;
+
+    for (;;) {
+        r = __LDREXW(&rd_state);
+        uint32_t c = commit_state;
+        if ((r & RD_INFLIGHT) || ST_POS(r) == ST_POS(c)) {
+            __CLREX();
+            return;
+        }
+        uint16_t off = ST_POS(r) & RING_MASK;
+        len = (uint16_t)(ST_POS(c) - ST_POS(r));
+        if (len > USBLOG_RING_SZ - off) len = (uint16_t)(USBLOG_RING_SZ - off);
+        if (len > USBLOG_TX_MAX) len = USBLOG_TX_MAX;
+        if (__STREXW(r | RD_INFLIGHT, &rd_state) == 0u) break;
+    }
+
+    /* Передачу длиной кратной 64 завершает ZLP — его шлёт класс CDC (USBD_CDC_DataIn) */
+    tx_len = len;
+    if (CDC_Transmit_FS(&ring[ST_POS(r) & RING_MASK], len) == USBD_OK) {
+        stats.xfers++;
+    } else {
+        tx_len = 0u;
+        rd_state = r;   /* INFLIGHT снят; писатели rd_state при INFLIGHT не трогали */
+    }
+}
+
+ITCM_CODE void UsbLog_OnTxCplt(void)
+{
+    uint16_t len = tx_len;
+    if (len == 0u) return;
+
+    Advance(len);
+    stats.tx_bytes += len;
+    tx_len = 0u;
+    StartTx();
+}
+
+void UsbLog_Task(void)
+{
+    UsbLog_Stats_t s = stats;
+
+    if (s.dropped_msgs != reported.dropped_msgs || s.overwritten_msgs != reported.overwritten_msgs) {
+        BLOG("[LOG] dropped %lu msgs (%lu bytes), overwritten %lu msgs (%lu bytes)\r\n",
+             (unsigned long)(s.dropped_msgs - reported.dropped_msgs),
+             (unsigned long)(s.dropped_bytes - reported.dropped_bytes),
+             (unsigned long)(s.overwritten_msgs - reported.overwritten_msgs),
+             (unsigned long)(s.overwritten_bytes - reported.overwritten_bytes));
+        reported = s;
+    }
+
+    if (ST_POS(rd_state) == ST_POS(commit_state) && !(rd_state & RD_INFLIGHT)) return;
+
+    /* Читатель один: здесь он не должен пересечься с USB ISR */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if ((rd_state & RD_INFLIGHT) && !CDC_TxBusy_FS()) {
+        /* Класс CDC переинициализирован (переподключение): завершения не будет */
+        Advance(tx_len);
+        tx_len = 0u;
+    }
+    StartTx();
+
+    __set_PRIMASK(primask);
+}
+
+uint16_t UsbLog_Free(void)
+{
+    uint32_t s = res_state;
+    uint32_t r = rd_state;
+
+    if ((uint8_t)(ST_MSG(s) - ST_MSG(r)) >= USBLOG_MSG_SLOTS) return 0u;
+    return (uint16_t)(USBLOG_RING_SZ - (uint16_t)(ST_POS(s) - ST_POS(r)));
+}
+
+void UsbLog_SetPolicy(UsbLog_Policy_t p)
+{
+    policy = (uint8_t)p;
+}
+
+void UsbLog_GetStats(UsbLog_Stats_t *out)
+{
+    *out = stats;
+}
@@ -5,6 +5,12 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Core/Src/app_tasks.c \
+../Core/Src/bench.c \
+../Core/Src/blog.c \
+../Core/Src/boot.c \
+../Core/Src/config_store.c \
+../Core/Src/deadline.c \
 ../Core/Src/dispenser.c \
 ../Core/Src/dma.c \
 ../Core/Src/eeprom_at24.c \
@@ -13,6 +19,8 @@ C_SRCS += \
 ../Core/Src/i2c.c \
 ../Core/Src/keyboard.c \
 ../Core/Src/main.c \
+../Core/Src/prof.c \
+../Core/Src/sched.c \
 ../Core/Src/spi.c \
 ../Core/Src/ssd1309.c \
 ../Core/Src/stm32h7xx_hal_msp.c \
@@ -22,9 +30,17 @@ C_SRCS += \
 ../Core/Src/system_stm32h7xx.c \
 ../Core/Src/tim.c \
 ../Core/Src/ui_manager.c \
-../Core/Src/usart.c 
+../Core/Src/ui_widgets.c \
+../Core/Src/usart.c \
+../Core/Src/usb_log.c 
 
 OBJS += \
+./Core/Src/app_tasks.o \
+./Core/Src/bench.o \
+./Core/Src/blog.o \
+./Core/Src/boot.o \
+./Core/Src/config_store.o \
+./Core/Src/deadline.o \
 ./Core/Src/dispenser.o \
 ./Core/Src/dma.o \
 ./Core/Src/eeprom_at24.o \
@@ -33,6 +49,8 @@ OBJS += \
 ./Core/Src/i2c.o \
 ./Core/Src/keyboard.o \
 ./Core/Src/main.o \
+./Core/Src/prof.o \
+./Core/Src/sched.o \
 ./Core/Src/spi.o \
 ./Core/Src/ssd1309.o \
 ./Core/Src/stm32h7xx_hal_msp.o \
@@ -42,9 +60,17 @@ OBJS += \
 ./Core/Src/system_stm32h7xx.o \
 ./Core/Src/tim.o \
 ./Core/Src/ui_manager.o \
-./Core/Src/usart.o 
+./Core/Src/ui_widgets.o \
+./Core/Src/usart.o \
+./Core/Src/usb_log.o 
 
 C_DEPS += \
+./Core/Src/app_tasks.d \
+./Core/Src/bench.d \
+./Core/Src/blog.d \
+./Core/Src/boot.d \
+./Core/Src/config_store.d \
+./Core/Src/deadline.d \
 ./Core/Src/dispenser.d \
 ./Core/Src/dma.d \
 ./Core/Src/eeprom_at24.d \
@@ -53,6 +79,8 @@ C_DEPS += \
 ./Core/Src/i2c.d \
 ./Core/Src/keyboard.d \
 ./Core/Src/main.d \
+./Core/Src/prof.d \
+./Core/Src/sched.d \
 ./Core/Src/spi.d \
 ./Core/Src/ssd1309.d \
 ./Core/Src/stm32h7xx_hal_msp.d \
@@ -62,7 +90,9 @@ C_DEPS += \
 ./Core/Src/system_stm32h7xx.d \
 ./Core/Src/tim.d \
 ./Core/Src/ui_manager.d \
-./Core/Src/usart.d 
+./Core/Src/ui_widgets.d \
+./Core/Src/usart.d \
+./Core/Src/usb_log.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -72,7 +102,7 @@ Core/Src/%.o Core/Src/%.su Core/Src/%.cyclo: ../Core/Src/%.c Core/Src/subdir.mk
 clean: clean-Core-2f-Src
 
 clean-Core-2f-Src:
-	-$(RM) ./Core/Src/dispenser.cyclo ./Core/Src/dispenser.d ./Core/Src/dispenser.o ./Core/Src/dispenser.su ./Core/Src/dma.cyclo ./Core/Src/dma.d ./Core/Src/dma.o ./Core/Src/dma.su ./Core/Src/eeprom_at24.cyclo ./Core/Src/eeprom_at24.d ./Core/Src/eeprom_at24.o ./Core/Src/eeprom_at24.su ./Core/Src/gaskitlink.cyclo ./Core/Src/gaskitlink.d ./Core/Src/gaskitlink.o ./Core/Src/gaskitlink.su ./Core/Src/gpio.cyclo ./Core/Src/gpio.d ./Core/Src/gpio.o ./Core/Src/gpio.su ./Core/Src/i2c.cyclo ./Core/Src/i2c.d ./Core/Src/i2c.o ./Core/Src/i2c.su ./Core/Src/keyboard.cyclo ./Core/Src/keyboard.d ./Core/Src/keyboard.o ./Core/Src/keyboard.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/spi.cyclo ./Core/Src/spi.d ./Core/Src/spi.o ./Core/Src/spi.su ./Core/Src/ssd1309.cyclo ./Core/Src/ssd1309.d ./Core/Src/ssd1309.o ./Core/Src/ssd1309.su ./Core/Src/stm32h7xx_hal_msp.cyclo ./Core/Src/stm32h7xx_hal_msp.d ./Core/Src/stm32h7xx_hal_msp.o ./Core/Src/stm32h7xx_hal_msp.su ./Core/Src/stm32h7xx_it.cyclo ./Core/Src/stm32h7xx_it.d ./Core/Src/stm32h7xx_it.o ./Core/Src/stm32h7xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32h7xx.cyclo ./Core/Src/system_stm32h7xx.d ./Core/Src/system_stm32h7xx.o ./Core/Src/system_stm32h7xx.su ./Core/Src/tim.cyclo ./Core/Src/tim.d ./Core/Src/tim.o ./Core/Src/tim.su ./Core/Src/ui_manager.cyclo ./Core/Src/ui_manager.d ./Core/Src/ui_manager.o ./Core/Src/ui_manager.su ./Core/Src/usart.cyclo ./Core/Src/usart.d ./Core/Src/usart.o ./Core/Src/usart.su
+	-$(RM) ./Core/Src/app_tasks.cyclo ./Core/Src/app_tasks.d ./Core/Src/app_tasks.o ./Core/Src/app_tasks.su ./Core/Src/bench.cyclo ./Core/Src/bench.d ./Core/Src/bench.o ./Core/Src/bench.su ./Core/Src/blog.cyclo ./Core/Src/blog.d ./Core/Src/blog.o ./Core/Src/blog.su ./Core/Src/boot.cyclo ./Core/Src/boot.d ./Core/Src/boot.o ./Core/Src/boot.su ./Core/Src/config_store.cyclo ./Core/Src/config_store.d ./Core/Src/config_store.o ./Core/Src/config_store.su ./Core/Src/deadline.cyclo ./Core/Src/deadline.d ./Core/Src/deadline.o ./Core/Src/deadline.su ./Core/Src/dispenser.cyclo ./Core/Src/dispenser.d ./Core/Src/dispenser.o ./Core/Src/dispenser.su ./Core/Src/dma.cyclo ./Core/Src/dma.d ./Core/Src/dma.o ./Core/Src/dma.su ./Core/Src/eeprom_at24.cyclo ./Core/Src/eeprom_at24.d ./Core/Src/eeprom_at24.o ./Core/Src/eeprom_at24.su ./Core/Src/gaskitlink.cyclo ./Core/Src/gaskitlink.d ./Core/Src/gaskitlink.o ./Core/Src/gaskitlink.su ./Core/Src/gpio.cyclo ./Core/Src/gpio.d ./Core/Src/gpio.o ./Core/Src/gpio.su ./Core/Src/i2c.cyclo ./Core/Src/i2c.d ./Core/Src/i2c.o ./Core/Src/i2c.su ./Core/Src/keyboard.cyclo ./Core/Src/keyboard.d ./Core/Src/keyboard.o ./Core/Src/keyboard.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/prof.cyclo ./Core/Src/prof.d ./Core/Src/prof.o ./Core/Src/prof.su ./Core/Src/sched.cyclo ./Core/Src/sched.d ./Core/Src/sched.o ./Core/Src/sched.su ./Core/Src/spi.cyclo ./Core/Src/spi.d ./Core/Src/spi.o ./Core/Src/spi.su ./Core/Src/ssd1309.cyclo ./Core/Src/ssd1309.d ./Core/Src/ssd1309.o ./Core/Src/ssd1309.su ./Core/Src/stm32h7xx_hal_msp.cyclo ./Core/Src/stm32h7xx_hal_msp.d ./Core/Src/stm32h7xx_hal_msp.o ./Core/Src/stm32h7xx_hal_msp.su ./Core/Src/stm32h7xx_it.cyclo ./Core/Src/stm32h7xx_it.d ./Core/Src/stm32h7xx_it.o ./Core/Src/stm32h7xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32h7xx.cyclo ./Core/Src/system_stm32h7xx.d ./Core/Src/system_stm32h7xx.o ./Core/Src/system_stm32h7xx.su ./Core/Src/tim.cyclo ./Core/Src/tim.d ./Core/Src/tim.o ./Core/Src/tim.su ./Core/Src/ui_manager.cyclo ./Core/Src/ui_manager.d ./Core/Src/ui_manager.o ./Core/Src/ui_manager.su ./Core/Src/ui_widgets.cyclo ./Core/Src/ui_widgets.d ./Core/Src/ui_widgets.o ./Core/Src/ui_widgets.su ./Core/Src/usart.cyclo ./Core/Src/usart.d ./Core/Src/usart.o ./Core/Src/usart.su ./Core/Src/usb_log.cyclo ./Core/Src/usb_log.d ./Core/Src/usb_log.o ./Core/Src/usb_log.su
 
 .PHONY: clean-Core-2f-Src
 
@@ -0,0 +1,116 @@
+#include "app.h"
+#include "app_tasks.h"
+#include "host_hal.h"
+#include "spi.h"
+#include "tim.h"
+#include "keyboard.h"
+#include "eeprom_at24.h"
+#include "dwt_cycles.h"
+#include "deadline.h"
+#include "boot.h"
+
+/* main(), USER CODE 2: таблица задач и дисплеи — общие с прошивкой
+   (app_tasks.c); настройки из EEPROM и UI_Init — в Boot_Task */
+void App_Init(void)
+{
+    Host_Reset();
+    DWT_CyclesInit();
+
+    AppTasks_Init();
+}
+
+void App_Boot(void)
+{
+    App_Init();
+    while (!Boot_Reached(BOOT_PHASE_UI) && HAL_GetTick() < 1000u) {
+        Host_Advance(1u);
+        App_Step();
+    }
+}
+
+/* main(), тело while (1) */
+void App_Step(void)
+{
+    AppTasks_Run();
+}
+
+void App_Run(uint32_t ms)
+{
+    uint32_t end = HAL_GetTick() + ms;
+
+    while ((int32_t)(end - HAL_GetTick()) > 0) {
+        Host_Advance(1u);
+        App_Step();
+    }
+}
+
+uint32_t App_RunFast(uint32_t ms)
+{
+    uint32_t end = HAL_GetTick() + ms;
+    uint32_t steps = 0;
+
+    while ((int32_t)(end - HAL_GetTick()) > 0) {
+        uint32_t wake;
+        uint8_t timed = Deadline_Take(&wake);
+
+        /* Итерация что-то запустила или получила прерывание — следующая
+           через миллисекунду, как в App_Run; иначе сон до срока */
+        if (Host_TakeEvents()) {
+            Host_Advance(1u);
+        } else {
+            if (!timed || (int32_t)(wake - end) > 0) wake = end;
+            Host_Sleep(wake);
+        }
+        App_Step();
+        steps++;
+    }
+    return steps;
+}
+
+/* main(), USER CODE 4: колбэки HAL -> модули */
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &hspi2) {
+        SSD1309_Bus_OnSpiTxCplt(&oled_bus, hspi);
+    }
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &hspi2) {
+        SSD1309_Bus_OnSpiError(&oled_bus, hspi);
+    }
+}
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim == &htim3) {
+        Keyboard_OnTick();
+    }
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    Keyboard_OnExti(GPIO_Pin);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    EEPROM_OnI2cDone(hi2c);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    EEPROM_OnI2cDone(hi2c);
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    EEPROM_OnI2cDone(hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    EEPROM_OnI2cError(hi2c);
+}
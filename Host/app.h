@@ -0,0 +1,31 @@
+/*
+ * Приложение на хосте: инициализация и main loop из main.c без железа.
+ *
+ * Состояние модулей (ui_manager, dispenser, eeprom_at24 ...) статическое,
+ * App_Init сбрасывает периферию (Host_Reset) и заново инициализирует модули
+ * тем же кодом, что и main(): AppTasks_Init/AppTasks_Run (app_tasks.c).
+ */
+#ifndef APP_H
+#define APP_H
+
+#include "app_tasks.h"
+#include <stdint.h>
+
+void App_Init(void);
+
+/* App_Init и main loop до UI_Init: настройки из EEPROM загружены и применены */
+void App_Boot(void);
+
+/* Одна итерация main loop */
+void App_Step(void);
+
+/* ms миллисекунд виртуального времени: на каждой — «прерывания» и итерация */
+void App_Run(uint32_t ms);
+
+/* То же с перескоком простоя: после итерации без событий — сон до ближайшего
+   Deadline_At или прерывания. Модули, время которых не отмечено, увидели
+   бы время скачками; результат сверяется с App_Run тестом. Возвращает
+   число итераций main loop */
+uint32_t App_RunFast(uint32_t ms);
+
+#endif // APP_H
@@ -0,0 +1,200 @@
+/*
+ * Микробенчмарки горячих путей на хосте.
+ *
+ *   host_bench [--quick] [--json] [подстрока имени]
+ *
+ * Сначала общий с платой набор (Core/Src/bench.c), затем случаи, которые
+ * есть только на хосте: им нужен шим (виртуальное время, модель ТРК).
+ * Время — CLOCK_MONOTONIC, только измеряемая часть: виртуальное время
+ * (Host_Advance) и разгрузка лога идут вне замера. Цифры — хостовые, для
+ * сравнения «до/после» и для perf/callgrind; такты на плате — 'B' по USB.
+ * --quick — в 100 раз меньше повторов (под valgrind), --json — JSON Lines
+ * в формате отчёта платы (Tools/bench_compare.py).
+ */
+#include "app.h"
+#include "host_hal.h"
+#include "bench.h"
+#include "ssd1309.h"
+#include "ui_manager.h"
+#include "usb_log.h"
+#include "blog.h"
+#include "gas_sim.h"
+#include "dispenser.h"
+#include "usart.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    const char *name;
+    uint32_t iters;
+    uint64_t (*fn)(uint32_t iters);   /* нс в измеряемой части */
+} Bench_t;
+
+static volatile uint32_t sink;
+
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Лог уходит в «USB» вне замера, чтобы кольцо не было всё время полным */
+static void DrainLog(void)
+{
+    static char out[4096];
+    Host_Advance(1);
+    UsbLog_Task();
+    while (Host_UsbTake(out, sizeof(out)) > 0u) { }
+}
+
+static uint64_t Bench_DrawBigDigits(uint32_t iters)
+{
+    uint64_t t0 = NowNs();
+    for (uint32_t i = 0; i < iters; i++) {
+        uint16_t x = 0;
+        for (char ch = '0'; ch <= '7'; ch++) {
+            x = (uint16_t)(x + SSD1309_DrawBigChar(&oled, x, 2, ch, SSD1309_FONT_16X32));
+        }
+    }
+    return NowNs() - t0;
+}
+
+/* UI_Draw рисует не чаще раза в 33 мс: время двигается вне замера */
+static uint64_t Bench_UiDraw(uint32_t iters)
+{
+    uint64_t ns = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        Host_Advance(33);
+        uint64_t t0 = NowNs();
+        UI_Draw();
+        ns += NowNs() - t0;
+    }
+    return ns;
+}
+
+static uint64_t Bench_BlogWrite(uint32_t iters)
+{
+    uint64_t ns = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        const uint32_t args[3] = { 1u, 'S', i };
+        if ((i & 15u) == 0u) DrainLog();
+        uint64_t t0 = NowNs();
+        Blog_Write(0x0123u, 3u, args);
+        ns += NowNs() - t0;
+    }
+    return ns;
+}
+
+/* Итерация main loop без событий: опросы, задачи, отрисовка по таймеру */
+static uint64_t Bench_MainLoop(uint32_t iters)
+{
+    uint64_t ns = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        Host_Advance(1);
+        uint64_t t0 = NowNs();
+        App_Step();
+        ns += NowNs() - t0;
+    }
+    return ns;
+}
+
+/* Полная транзакция V (10 л) против модели ТРК: виртуальное время с
+   перескоком простоя идёт внутри замера, цифра — цена прогона одной
+   транзакции в тестах */
+static uint64_t Bench_SimTransaction(uint32_t iters)
+{
+    GasSim_Config_t cfg;
+    GasSim_DefaultConfig(&cfg);
+    cfg.flow_cl_per_min = 60000u;   /* 1 сл/мс */
+    cfg.lift_delay_ms = 10u;
+    cfg.start_delay_ms = 10u;
+    cfg.hang_delay_ms = 10u;
+
+    GasSim_Init(1u);
+    GasSim_Slave_t *s = GasSim_Add(&huart2, 1u, &cfg);
+
+    uint64_t t0 = NowNs();
+    for (uint32_t i = 0; i < iters; i++) {
+        Dispenser_StartVolume(0, 1, 1000u, 1000u);
+        while (s->stats.transactions <= i) App_RunFast(10u);
+        if ((i & 15u) == 0u) DrainLog();
+    }
+    uint64_t ns = NowNs() - t0;
+
+    fprintf(stderr, "  refresh (L in S61): max %lu ms, avg %.1f ms\n", (unsigned long)s->stats.l_gap_max_ms,
+           s->stats.l_polls ? (double)s->stats.l_gap_sum_ms / s->stats.l_polls : 0.0);
+    return ns;
+}
+
+static const Bench_t benches[] = {
+    { "oled_draw_big8",     200000u, Bench_DrawBigDigits },
+    { "ui_draw",             20000u, Bench_UiDraw },
+    { "blog_write",        1000000u, Bench_BlogWrite },
+    { "main_loop_idle",     100000u, Bench_MainLoop },
+    { "sim_transaction",       500u, Bench_SimTransaction },
+};
+
+static void Report(uint8_t json, const char *name, const Bench_Result_t *res)
+{
+    char line[BENCH_LINE_MAX];
+
+    if (json) {
+        Bench_FormatResult(line, sizeof(line), name, res);
+        fputs(line, stdout);
+    } else {
+        printf("%-24s %10lu %12.1f %12.1f\n", name, (unsigned long)res->iters,
+               (double)res->ns / res->iters, (double)res->cycles / res->iters);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t div = 1u;
+    uint8_t json = 0u;
+    const char *filter = NULL;
+    char line[BENCH_LINE_MAX];
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) div = 100u;
+        else if (strcmp(argv[i], "--json") == 0) json = 1u;
+        else filter = argv[i];
+    }
+
+    if (json) {
+        Bench_FormatHeader(line, sizeof(line));
+        fputs(line, stdout);
+    } else {
+        printf("%-24s %10s %12s %12s\n", "bench", "iters", "ns/op", "tsc/op");
+    }
+
+    /* Каждый замер — с чистой загрузки и готового дисплея */
+    for (uint8_t b = 0; b < Bench_Count(); b++) {
+        Bench_Result_t res;
+        if (filter && strstr(Bench_Name(b), filter) == NULL) continue;
+        App_Init();
+        App_Run(200);
+        Bench_Run(b, div, &res);
+        Report(json, Bench_Name(b), &res);
+    }
+
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        const Bench_t *bn = &benches[b];
+        Bench_Result_t res;
+        if (filter && strstr(bn->name, filter) == NULL) continue;
+
+        App_Init();
+        App_Run(200);
+
+        uint32_t iters = bn->iters / div;
+        if (iters == 0u) iters = 1u;
+        memset(&res, 0, sizeof(res));
+        res.iters = iters;
+        res.batch = iters;
+        res.ns = bn->fn(iters);
+        res.min_ns = res.ns;
+        Report(json, bn->name, &res);
+    }
+    return 0;
+}
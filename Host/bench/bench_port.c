@@ -0,0 +1,44 @@
+/*
+ * Платформа bench.c на хосте: DWT шима идёт по виртуальному времени,
+ * поэтому время — CLOCK_MONOTONIC, такты — TSC (на x86; иначе тактов нет).
+ * Между пачками — миллисекунда виртуального времени и разгрузка лога.
+ */
+#include "bench.h"
+#include "host_hal.h"
+#include "usb_log.h"
+#include <stdio.h>
+#include <time.h>
+
+void Bench_Now(Bench_Stamp_t *t)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    t->ns = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#if defined(__x86_64__) || defined(__i386__)
+    t->cycles = __builtin_ia32_rdtsc();   /* x86intrin.h не дружит с макросами CMSIS */
+#else
+    t->cycles = 0u;
+#endif
+}
+
+void Bench_Idle(void)
+{
+    static char out[4096];
+
+    Host_Advance(1);
+    UsbLog_Task();
+    while (Host_UsbTake(out, sizeof(out)) > 0u) { }
+}
+
+const char *Bench_Platform(void)
+{
+    return "host";
+}
+
+uint16_t Bench_FormatHeader(char *out, uint16_t max)
+{
+    int len = snprintf(out, max, "{\"suite\":\"pult\",\"platform\":\"%s\",\"cases\":%u}\r\n",
+                       Bench_Platform(), (unsigned)Bench_Count());
+    return (len < 0) ? 0u : (uint16_t)((len < max) ? len : max - 1);
+}
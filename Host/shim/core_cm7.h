@@ -0,0 +1,70 @@
+/*
+ * Хостовая подмена CMSIS-ядра Cortex-M7.
+ *
+ * Настоящий core_cm7.h подключается целиком (типы SCB/DWT/NVIC, константы
+ * битов), но вместо cmsis_gcc.h с ассемблером ARM здесь те же макросы
+ * компилятора и встроенные функции на C. Прерываний на хосте нет: PRIMASK —
+ * просто переменная, LDREX/STREX всегда успешны (один поток).
+ *
+ * Адреса периферии ядра (SCB, DWT, CoreDebug) перенаправляет shim/stm32h7xx.h.
+ */
+#ifndef HOST_CORE_CM7_H
+#define HOST_CORE_CM7_H
+
+#include <stdint.h>
+
+/* cmsis_compiler.h не должен подключить cmsis_gcc.h */
+#define __CMSIS_GCC_H
+
+#define __ASM                                  __asm
+#define __INLINE                               inline
+#define __STATIC_INLINE                        static inline
+#define __STATIC_FORCEINLINE                   __attribute__((always_inline)) static inline
+#define __NO_RETURN                            __attribute__((__noreturn__))
+#define __USED                                 __attribute__((used))
+#define __WEAK                                 __attribute__((weak))
+#define __PACKED                               __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT                        struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                         union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                           __attribute__((aligned(x)))
+#define __RESTRICT                             __restrict
+#define __COMPILER_BARRIER()                   __asm volatile("" ::: "memory")
+
+extern uint32_t host_primask;
+
+__STATIC_FORCEINLINE void __enable_irq(void)              { host_primask = 0u; }
+__STATIC_FORCEINLINE void __disable_irq(void)             { host_primask = 1u; }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)         { return host_primask; }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t primask) { host_primask = primask; }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void)            { return 0u; }
+
+__STATIC_FORCEINLINE void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+#define __NOP()        do { } while (0)
+#define __WFI()        do { } while (0)
+#define __WFE()        do { } while (0)
+#define __SEV()        do { } while (0)
+#define __BKPT(value)  __builtin_trap()
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value) { return __builtin_bswap32(value); }
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value)  { return (value == 0u) ? 32u : (uint8_t)__builtin_clz(value); }
+
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+    uint32_t r = 0u;
+    for (uint32_t i = 0; i < 32u; i++) {
+        r = (r << 1) | (value & 1u);
+        value >>= 1;
+    }
+    return r;
+}
+
+__STATIC_FORCEINLINE uint32_t __LDREXW(volatile uint32_t *addr)                 { return *addr; }
+__STATIC_FORCEINLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr) { *addr = value; return 0u; }
+__STATIC_FORCEINLINE void __CLREX(void)                                         { }
+
+#include_next <core_cm7.h>
+
+#endif // HOST_CORE_CM7_H
@@ -0,0 +1,691 @@
+#include "host_hal.h"
+#include "usart.h"
+#include "spi.h"
+#include "i2c.h"
+#include "tim.h"
+#include "usbd_cdc_if.h"
+#include "usb_log.h"
+#include "keyboard.h"
+#include <string.h>
+
+#define HOST_EEPROM_ADDR  0xA0u
+
+/* Периферия по адресам из shim/stm32h7xx.h */
+GPIO_TypeDef host_gpio[11];
+TIM_TypeDef host_tim2, host_tim3;
+USART_TypeDef host_usart2, host_usart3;
+SPI_TypeDef host_spi2;
+I2C_TypeDef host_i2c1;
+DMA_Stream_TypeDef host_dma1_stream[8];
+EXTI_TypeDef host_exti;
+EXTI_Core_TypeDef host_exti_d1;
+SCB_Type host_scb;
+DWT_Type host_dwt;
+CoreDebug_Type host_coredebug;
+
+uint32_t host_primask;
+uint32_t SystemCoreClock = 480000000u;
+__IO uint32_t uwTick;
+
+/* Дескрипторы, как их заводит CubeMX (usart.c, spi.c, i2c.c, tim.c) */
+UART_HandleTypeDef huart2;
+UART_HandleTypeDef huart3;
+SPI_HandleTypeDef hspi2;
+I2C_HandleTypeDef hi2c1;
+TIM_HandleTypeDef htim2;
+TIM_HandleTypeDef htim3;
+
+static Host_Stats_t stats;
+static Host_TickHook_t tick_hook;
+static uint32_t hook_at;
+static uint64_t now_us;
+static uint8_t events;   /* прерывания и вызовы HAL с прошлого Host_TakeEvents */
+
+/* ====== Время ====== */
+
+/* Только время: для блокирующих вызовов, внутри которых прерывания не нужны */
+static void TimeUs(uint64_t us)
+{
+    now_us += us;
+    uwTick = (uint32_t)(now_us / 1000u);
+    DWT->CYCCNT += (uint32_t)(us * (SystemCoreClock / 1000000u));
+}
+
+static void Tick(uint32_t ms)
+{
+    TimeUs((uint64_t)ms * 1000u);
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    Host_Advance(Delay);
+}
+
+/* ====== GPIO и клавиатура ====== */
+
+static const char key_map[KEY_ROWS][KEY_COLS] = {
+    {'H', 'G', 'F', 'A'},
+    {'3', '2', '1', 'B'},
+    {'6', '5', '4', 'C'},
+    {'9', '8', '7', 'D'},
+    {'K', '0', '.', 'E'}
+};
+
+static GPIO_TypeDef *const row_ports[KEY_ROWS] = {
+    KeyRow_1_GPIO_Port, KeyRow_2_GPIO_Port, KeyRow_3_GPIO_Port, KeyRow_4_GPIO_Port, KeyRow_5_GPIO_Port
+};
+static const uint16_t row_pins[KEY_ROWS] = {
+    KeyRow_1_Pin, KeyRow_2_Pin, KeyRow_3_Pin, KeyRow_4_Pin, KeyRow_5_Pin
+};
+static GPIO_TypeDef *const col_ports[KEY_COLS] = {
+    KeyCol_1_GPIO_Port, KeyCol_2_GPIO_Port, KeyCol_3_GPIO_Port, KeyCol_4_GPIO_Port
+};
+static const uint16_t col_pins[KEY_COLS] = {
+    KeyCol_1_Pin, KeyCol_2_Pin, KeyCol_3_Pin, KeyCol_4_Pin
+};
+
+static uint8_t key_down[KEY_ROWS][KEY_COLS];
+static uint16_t cols_low;   /* столбцы в low на прошлой проверке EXTI (маска пинов) */
+
+static uint8_t ColumnLow(uint8_t c)
+{
+    for (uint8_t r = 0; r < KEY_ROWS; r++) {
+        if (key_down[r][c] && (row_ports[r]->ODR & row_pins[r]) == 0u) return 1u;
+    }
+    return 0u;
+}
+
+/* Спад на столбце при открытой маске EXTI — HAL_GPIO_EXTI_Callback */
+static void ExtiCheck(void)
+{
+    uint16_t low = 0u;
+    for (uint8_t c = 0; c < KEY_COLS; c++) {
+        if (ColumnLow(c)) low |= col_pins[c];
+    }
+    uint16_t fell = (uint16_t)(low & ~cols_low);
+    cols_low = low;
+
+    for (uint8_t c = 0; c < KEY_COLS; c++) {
+        if ((fell & col_pins[c]) && (EXTI_D1->IMR1 & col_pins[c])) {
+            events = 1u;
+            HAL_GPIO_EXTI_Callback(col_pins[c]);
+        }
+    }
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(const GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    for (uint8_t c = 0; c < KEY_COLS; c++) {
+        if (GPIOx == col_ports[c] && GPIO_Pin == col_pins[c]) {
+            return ColumnLow(c) ? GPIO_PIN_RESET : GPIO_PIN_SET;   /* подтяжка вверх */
+        }
+    }
+    return (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void Host_Key(char key, uint8_t down)
+{
+    for (uint8_t r = 0; r < KEY_ROWS; r++) {
+        for (uint8_t c = 0; c < KEY_COLS; c++) {
+            if (key_map[r][c] == key) key_down[r][c] = down ? 1u : 0u;
+        }
+    }
+    ExtiCheck();
+}
+
+/* ====== TIM ====== */
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim)
+{
+    events = 1u;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim)
+{
+    events = 1u;
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    events = 1u;
+    htim->Instance->DIER |= TIM_DIER_UIE;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+    events = 1u;
+    htim->Instance->DIER &= ~TIM_DIER_UIE;
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+static uint8_t TimIrqEnabled(TIM_HandleTypeDef *htim)
+{
+    return (htim->Instance->CR1 & TIM_CR1_CEN) && (htim->Instance->DIER & TIM_DIER_UIE);
+}
+
+/* ====== UART ====== */
+
+typedef struct {
+    uint8_t tx[HOST_UART_TX_MAX];
+    uint16_t tx_len;
+    uint8_t *rx_buf;
+    uint16_t rx_size;
+    uint8_t rx_armed;
+} HostUart_t;
+
+static HostUart_t uarts[2];
+static Host_UartTxHook_t uart_tx_hook;
+
+static HostUart_t *Uart(UART_HandleTypeDef *huart)
+{
+    if (huart == &huart2) return &uarts[0];
+    if (huart == &huart3) return &uarts[1];
+    return NULL;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    if (Uart(huart) == NULL) return HAL_ERROR;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+uint32_t Host_UartWireUs(const UART_HandleTypeDef *huart, uint16_t len)
+{
+    uint32_t bits = 10u;   /* старт, 8 бит (с чётностью — в WordLength), стоп */
+
+    if (huart->Init.WordLength == UART_WORDLENGTH_9B) bits++;
+    if (huart->Init.WordLength == UART_WORDLENGTH_7B) bits--;
+    if (huart->Init.StopBits == UART_STOPBITS_2) bits++;
+    if (huart->Init.BaudRate == 0u) return 0u;
+    return (uint32_t)(((uint64_t)len * bits * 1000000u + huart->Init.BaudRate - 1u) / huart->Init.BaudRate);
+}
+
+/* Блокирующая передача: возврат — после стоп-бита последнего байта (TC),
+   прерывания за это время идут; кадр уходит в перехват целиком в конце */
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    HostUart_t *u = Uart(huart);
+    (void)Timeout;
+
+    if (u == NULL || pData == NULL || Size == 0u) return HAL_ERROR;
+    u->tx_len = (Size > HOST_UART_TX_MAX) ? HOST_UART_TX_MAX : Size;
+    memcpy(u->tx, pData, u->tx_len);
+    stats.uart_tx_frames++;
+    events = 1u;
+
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    Host_AdvanceUs(Host_UartWireUs(huart, u->tx_len));
+    huart->gState = HAL_UART_STATE_READY;
+
+    if (uart_tx_hook) uart_tx_hook(huart, u->tx, u->tx_len);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart)
+{
+    HostUart_t *u = Uart(huart);
+
+    if (u == NULL) return HAL_ERROR;
+    u->rx_armed = 0u;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    HostUart_t *u = Uart(huart);
+
+    if (u == NULL || pData == NULL || Size == 0u) return HAL_ERROR;
+    u->rx_buf = pData;
+    u->rx_size = Size;
+    u->rx_armed = 1u;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    events = 1u;
+    return HAL_OK;
+}
+
+const uint8_t *Host_UartLastTx(UART_HandleTypeDef *huart, uint16_t *len)
+{
+    HostUart_t *u = Uart(huart);
+
+    *len = u ? u->tx_len : 0u;
+    return u ? u->tx : NULL;
+}
+
+void Host_UartTxHook(Host_UartTxHook_t hook)
+{
+    uart_tx_hook = hook;
+}
+
+/* Кадр целиком и пауза после него: для ReceiveToIdle это одно событие IDLE */
+void Host_UartRx(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len)
+{
+    HostUart_t *u = Uart(huart);
+
+    if (u == NULL || !u->rx_armed) {
+        stats.uart_rx_dropped++;
+        return;
+    }
+    uint16_t n = (len > u->rx_size) ? u->rx_size : len;
+    memcpy(u->rx_buf, data, n);
+    u->rx_armed = 0u;
+    huart->RxState = HAL_UART_STATE_READY;
+    events = 1u;
+    HAL_UARTEx_RxEventCallback(huart, n);
+}
+
+/* ====== SPI ====== */
+
+static uint8_t spi_pending;
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size)
+{
+    if (pData == NULL || Size == 0u) return HAL_ERROR;
+    if (spi_pending) return HAL_BUSY;
+
+    hspi->State = HAL_SPI_STATE_BUSY_TX;
+    spi_pending = 1u;
+    events = 1u;
+    stats.spi_xfers++;
+    stats.spi_bytes += Size;
+    return HAL_OK;
+}
+
+/* ====== I2C: AT24C256 ====== */
+
+typedef enum {
+    I2C_OP_NONE = 0,
+    I2C_OP_MEM_WRITE,
+    I2C_OP_MEM_READ,
+    I2C_OP_POLL
+} I2cOp_t;
+
+static uint8_t eeprom[HOST_EEPROM_SIZE];
+static uint32_t eeprom_busy_until;
+static uint32_t eeprom_fail_writes;      /* столько следующих записей получат NACK */
+static uint8_t eeprom_powered;     /* содержимое переживает Host_Reset, как перезагрузку */
+
+static struct {
+    I2cOp_t op;
+    uint8_t nack;
+    uint16_t addr;
+    uint8_t *data;
+    uint16_t size;
+} i2c_req;
+
+static uint8_t EepromBusy(void)
+{
+    return (int32_t)(uwTick - eeprom_busy_until) < 0;
+}
+
+/* Адрес и данные принимаются, если микросхема не в цикле записи */
+static uint8_t EepromAck(uint16_t dev_addr)
+{
+    stats.i2c_xfers++;
+    if (dev_addr == HOST_EEPROM_ADDR && !EepromBusy()) return 1u;
+    stats.i2c_nacks++;
+    return 0u;
+}
+
+/* Запись внутри страницы: адрес, дошедший до конца страницы, заворачивается */
+static void EepromWrite(uint16_t addr, const uint8_t *data, uint16_t size)
+{
+    uint16_t page = (uint16_t)(addr & ~(HOST_EEPROM_PAGE - 1u) & (HOST_EEPROM_SIZE - 1u));
+    uint16_t off = (uint16_t)(addr & (HOST_EEPROM_PAGE - 1u));
+
+    for (uint16_t i = 0; i < size; i++) {
+        eeprom[page + off] = data[i];
+        off = (uint16_t)((off + 1u) & (HOST_EEPROM_PAGE - 1u));
+    }
+    eeprom_busy_until = uwTick + HOST_EEPROM_WRITE_MS;
+    stats.eeprom_writes++;
+}
+
+/* Чтение последовательное, через конец памяти — на начало */
+static void EepromRead(uint16_t addr, uint8_t *data, uint16_t size)
+{
+    for (uint16_t i = 0; i < size; i++) {
+        data[i] = eeprom[(addr + i) & (HOST_EEPROM_SIZE - 1u)];
+    }
+}
+
+static HAL_StatusTypeDef I2cStart(I2C_HandleTypeDef *hi2c, I2cOp_t op, uint16_t dev_addr,
+                                  uint16_t mem_addr, uint8_t *data, uint16_t size)
+{
+    if (i2c_req.op != I2C_OP_NONE) return HAL_BUSY;
+
+    events = 1u;
+    i2c_req.op = op;
+    i2c_req.nack = EepromAck(dev_addr) ? 0u : 1u;
+    if (op == I2C_OP_MEM_WRITE && !i2c_req.nack && eeprom_fail_writes) {
+        eeprom_fail_writes--;
+        i2c_req.nack = 1u;
+    }
+    i2c_req.addr = mem_addr;
+    i2c_req.data = data;
+    i2c_req.size = size;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->State = (op == I2C_OP_MEM_READ) ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+    return HAL_OK;
+}
+
+/* Конец передачи (STOP): страница уходит в цикл записи, данные чтения — в буфер */
+static void I2cComplete(void)
+{
+    I2cOp_t op = i2c_req.op;
+
+    i2c_req.op = I2C_OP_NONE;
+    hi2c1.State = HAL_I2C_STATE_READY;
+    events = 1u;
+
+    if (i2c_req.nack) {
+        hi2c1.ErrorCode = HAL_I2C_ERROR_AF;
+        HAL_I2C_ErrorCallback(&hi2c1);
+        return;
+    }
+    switch (op) {
+    case I2C_OP_MEM_WRITE:
+        EepromWrite(i2c_req.addr, i2c_req.data, i2c_req.size);
+        HAL_I2C_MemTxCpltCallback(&hi2c1);
+        break;
+    case I2C_OP_MEM_READ:
+        EepromRead(i2c_req.addr, i2c_req.data, i2c_req.size);
+        HAL_I2C_MemRxCpltCallback(&hi2c1);
+        break;
+    case I2C_OP_POLL:
+        HAL_I2C_MasterTxCpltCallback(&hi2c1);
+        break;
+    default:
+        break;
+    }
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)MemAddSize;
+    (void)Timeout;
+    if (i2c_req.op != I2C_OP_NONE) return HAL_BUSY;
+    if (!EepromAck(DevAddress)) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    EepromWrite(MemAddress, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)MemAddSize;
+    (void)Timeout;
+    if (i2c_req.op != I2C_OP_NONE) return HAL_BUSY;
+    if (!EepromAck(DevAddress)) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    EepromRead(MemAddress, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+    (void)MemAddSize;
+    return I2cStart(hi2c, I2C_OP_MEM_WRITE, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+    (void)MemAddSize;
+    return I2cStart(hi2c, I2C_OP_MEM_READ, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                             uint16_t Size)
+{
+    (void)Size;
+    return I2cStart(hi2c, I2C_OP_POLL, DevAddress, 0u, pData, 0u);
+}
+
+/* Ждёт конца цикла записи, как опрос ACK в HAL, если он короче Timeout */
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials,
+                                        uint32_t Timeout)
+{
+    (void)Trials;
+    if (i2c_req.op != I2C_OP_NONE) return HAL_BUSY;
+    if (DevAddress != HOST_EEPROM_ADDR) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+        return HAL_ERROR;
+    }
+    if (EepromBusy()) {
+        uint32_t wait = eeprom_busy_until - uwTick;
+        if (wait > Timeout) {
+            Tick(Timeout);
+            hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+            return HAL_ERROR;
+        }
+        Tick(wait);
+    }
+    return HAL_OK;
+}
+
+uint32_t HAL_I2C_GetError(const I2C_HandleTypeDef *hi2c)
+{
+    return hi2c->ErrorCode;
+}
+
+uint8_t *Host_Eeprom(void)
+{
+    return eeprom;
+}
+
+void Host_EepromFailWrites(uint32_t n)
+{
+    eeprom_fail_writes = n;
+}
+
+/* ====== USB CDC ====== */
+
+static char usb_buf[HOST_USB_BUF_SIZE];
+static size_t usb_len;
+static uint8_t usb_busy;
+
+uint8_t CDC_Transmit_FS(uint8_t *Buf, uint16_t Len)
+{
+    if (usb_busy) return USBD_BUSY;
+
+    size_t n = Len;
+    if (n > sizeof(usb_buf) - usb_len) {
+        stats.usb_overflow += (uint32_t)(n - (sizeof(usb_buf) - usb_len));
+        n = sizeof(usb_buf) - usb_len;
+    }
+    memcpy(&usb_buf[usb_len], Buf, n);
+    usb_len += n;
+    usb_busy = 1u;
+    events = 1u;
+    stats.usb_xfers++;
+    return USBD_OK;
+}
+
+uint8_t CDC_TxBusy_FS(void)
+{
+    return usb_busy;
+}
+
+/* Перечисления на хосте нет: порт открыт с первого прохода */
+uint8_t CDC_IsConfigured_FS(void)
+{
+    return 1u;
+}
+
+size_t Host_UsbTake(char *out, size_t max)
+{
+    size_t n = (usb_len < max) ? usb_len : max;
+
+    memcpy(out, usb_buf, n);
+    memmove(usb_buf, &usb_buf[n], usb_len - n);
+    usb_len -= n;
+    return n;
+}
+
+/* ====== Общее ====== */
+
+void Host_TickHook(Host_TickHook_t hook)
+{
+    tick_hook = hook;
+    hook_at = uwTick + 1u;
+}
+
+/* До следующей границы миллисекунды и «прерывания» на ней */
+static void NextMs(void)
+{
+    TimeUs(1000u - now_us % 1000u);
+
+    if (tick_hook && (int32_t)(uwTick - hook_at) >= 0) hook_at = tick_hook();
+
+    /* Порядок — как у приоритетов NVIC: тик сканера, EXTI, потом передачи */
+    if (TimIrqEnabled(&htim3)) {
+        events = 1u;
+        HAL_TIM_PeriodElapsedCallback(&htim3);
+    }
+    ExtiCheck();
+
+    /* Кадр OLED (1 КБ) уходит по SPI меньше чем за миллисекунду: цепочку
+       передач, которую колбэк запускает сам, завершаем здесь же */
+    for (uint8_t n = 0; spi_pending && n < 64u; n++) {
+        spi_pending = 0u;
+        hspi2.State = HAL_SPI_STATE_READY;
+        events = 1u;
+        HAL_SPI_TxCpltCallback(&hspi2);
+    }
+    if (i2c_req.op != I2C_OP_NONE) I2cComplete();
+    if (usb_busy) {
+        usb_busy = 0u;
+        events = 1u;
+        UsbLog_OnTxCplt();
+    }
+}
+
+void Host_Advance(uint32_t ms)
+{
+    while (ms--) NextMs();
+}
+
+void Host_AdvanceUs(uint32_t us)
+{
+    uint64_t end = now_us + us;
+
+    while (end / 1000u > now_us / 1000u) NextMs();
+    TimeUs(end - now_us);
+}
+
+/* Что-то, что шим завершает на каждой миллисекунде */
+static uint8_t NeedEveryMs(void)
+{
+    return TimIrqEnabled(&htim3) || spi_pending || i2c_req.op != I2C_OP_NONE || usb_busy;
+}
+
+void Host_Sleep(uint32_t until)
+{
+    events = 0u;
+    do {
+        uint32_t next = until;
+        if (tick_hook && (int32_t)(hook_at - next) < 0) next = hook_at;
+        if (NeedEveryMs()) next = uwTick + 1u;
+
+        /* До следующего события прерываний нет: время — одним скачком */
+        if ((int32_t)(next - uwTick) > 1) {
+            TimeUs((uint64_t)(next - 1u - uwTick) * 1000u - now_us % 1000u);
+        }
+        NextMs();
+    } while (!events && (int32_t)(uwTick - until) < 0);
+}
+
+uint8_t Host_TakeEvents(void)
+{
+    uint8_t e = events;
+
+    events = 0u;
+    return e;
+}
+
+uint64_t Host_NowUs(void)
+{
+    return now_us;
+}
+
+void Host_Reset(void)
+{
+    memset(host_gpio, 0, sizeof(host_gpio));
+    memset(&host_tim2, 0, sizeof(host_tim2));
+    memset(&host_tim3, 0, sizeof(host_tim3));
+    memset(&host_exti_d1, 0, sizeof(host_exti_d1));
+    memset(&host_dwt, 0, sizeof(host_dwt));
+    memset(&host_scb, 0, sizeof(host_scb));
+    memset(key_down, 0, sizeof(key_down));
+    memset(uarts, 0, sizeof(uarts));
+    memset(&i2c_req, 0, sizeof(i2c_req));
+    eeprom_fail_writes = 0u;
+    if (!eeprom_powered) {
+        memset(eeprom, 0xFF, sizeof(eeprom));
+        eeprom_powered = 1u;
+    }
+    memset(&stats, 0, sizeof(stats));
+    cols_low = 0u;
+    spi_pending = 0u;
+    usb_busy = 0u;
+    usb_len = 0u;
+    eeprom_busy_until = 0u;
+    uart_tx_hook = NULL;
+    tick_hook = NULL;
+    host_primask = 0u;
+    uwTick = 0u;
+    now_us = 0u;
+    events = 0u;
+
+    memset(&huart2, 0, sizeof(huart2));
+    memset(&huart3, 0, sizeof(huart3));
+    memset(&hspi2, 0, sizeof(hspi2));
+    memset(&hi2c1, 0, sizeof(hi2c1));
+    memset(&htim2, 0, sizeof(htim2));
+    memset(&htim3, 0, sizeof(htim3));
+    huart2.Instance = USART2;
+    huart2.Init.BaudRate = 9600;
+    huart3.Instance = USART3;
+    huart3.Init.BaudRate = 115200;
+    hspi2.Instance = SPI2;
+    hi2c1.Instance = I2C1;
+    htim2.Instance = TIM2;
+    htim3.Instance = TIM3;
+    htim3.Init.Period = 499;
+}
+
+const Host_Stats_t *Host_GetStats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,102 @@
+/*
+ * HAL на хосте: модель периферии, которую трогает приложение.
+ *
+ * Время виртуальное, с точностью до микросекунды: HAL_GetTick() и
+ * DWT->CYCCNT меняются только через Host_Advance/Host_AdvanceUs/Host_Sleep
+ * и внутри блокирующих вызовов. Прерываний нет, их роль играют границы
+ * миллисекунд — на каждой тик TIM3 (если сканер клавиатуры запущен), EXTI
+ * столбцов клавиатуры и завершения отложенных передач (SPI DMA, I2C IT,
+ * USB CDC). Колбэки HAL вызываются те же, что на плате, — их разводит
+ * app.c, как main.c.
+ *
+ *   UART  — HAL_UART_Transmit занимает время кадра на линии (Host_UartWireUs:
+ *           старт, данные, стоп по Init) и отдаёт кадр в Host_UartTxHook;
+ *           приём — Host_UartRx (как IDLE-событие ReceiveToIdle_DMA).
+ *   SPI2  — передачи завершаются на следующей миллисекунде (цепочка из
+ *           колбэка — там же, до 64 подряд); байты считаются.
+ *   I2C1  — AT24C256 (32 КБ, страница 64 байта, цикл записи 5 мс,
+ *           во время цикла — NACK).
+ *   GPIO  — матрица клавиатуры из main.h: столбец low, если нажата клавиша
+ *           в строке, выставленной в low (Host_Key).
+ *   CDC   — вывод USB-лога копится и забирается Host_UsbTake.
+ *
+ * Для перескока простоя (App_RunFast) шим отмечает события: вызовы HAL,
+ * которые что-то запускают, и колбэки «прерываний» (Host_TakeEvents).
+ * Host_Sleep — WFI: время идёт до заданного тика или до первого события.
+ */
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include "main.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define HOST_EEPROM_SIZE        32768u
+#define HOST_EEPROM_PAGE        64u
+#define HOST_EEPROM_WRITE_MS    5u
+#define HOST_UART_TX_MAX        256u
+#define HOST_USB_BUF_SIZE       (256u * 1024u)
+
+typedef void (*Host_UartTxHook_t)(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len);
+typedef uint32_t (*Host_TickHook_t)(void);   /* -> тик следующего вызова */
+
+typedef struct {
+    uint32_t spi_xfers;
+    uint32_t spi_bytes;
+    uint32_t i2c_xfers;
+    uint32_t i2c_nacks;
+    uint32_t eeprom_writes;     /* циклы записи страниц */
+    uint32_t uart_tx_frames;
+    uint32_t uart_rx_dropped;   /* приём без запущенного ReceiveToIdle */
+    uint32_t usb_xfers;
+    uint32_t usb_overflow;      /* байт не влезло в буфер Host_UsbTake */
+} Host_Stats_t;
+
+/* Периферия в исходное состояние, время 0. Содержимое EEPROM сохраняется
+   (перезагрузка), при первом вызове она стёрта (0xFF) */
+void Host_Reset(void);
+
+/* Виртуальное время вперёд на ms границ миллисекунды, с «прерываниями» */
+void Host_Advance(uint32_t ms);
+
+/* То же на us микросекунд: «прерывания» — на пройденных границах */
+void Host_AdvanceUs(uint32_t us);
+uint64_t Host_NowUs(void);
+
+/* Сон до тика until или до первого события, не меньше одной миллисекунды.
+   Миллисекунды, на которых шиму и хуку делать нечего, проскакиваются */
+void Host_Sleep(uint32_t until);
+
+/* Были ли события с прошлого вызова; сбрасывает */
+uint8_t Host_TakeEvents(void);
+
+/* Модель внешнего устройства: вызывается на границе миллисекунды первой,
+   как прерывание приёма с наивысшим приоритетом, — на следующей после
+   установки и дальше на тике, который вернула. Host_Sleep между вызовами
+   проскакивает время, поэтому модель, которую тронули снаружи (кадр
+   мастера, действие теста), ставит хук заново — он сработает через 1 мс */
+void Host_TickHook(Host_TickHook_t hook);
+
+/* UART: последний переданный кадр, перехват передачи, приём */
+const uint8_t *Host_UartLastTx(UART_HandleTypeDef *huart, uint16_t *len);
+void Host_UartTxHook(Host_UartTxHook_t hook);
+void Host_UartRx(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len);
+
+/* Время len байт на линии при настройках huart->Init, мкс (с округлением вверх) */
+uint32_t Host_UartWireUs(const UART_HandleTypeDef *huart, uint16_t len);
+
+/* Клавиша из раскладки keyboard.c ('0'..'9', 'A'..'H', 'K', '.') */
+void Host_Key(char key, uint8_t down);
+
+/* Содержимое AT24C256 — для подготовки и проверки */
+uint8_t *Host_Eeprom(void);
+
+/* Следующие n записей страниц (IT) получат NACK на данных — сбой записи */
+void Host_EepromFailWrites(uint32_t n);
+
+/* Вывод USB CDC, накопленный с прошлого вызова; возвращает длину */
+size_t Host_UsbTake(char *out, size_t max);
+
+const Host_Stats_t *Host_GetStats(void);
+
+#endif // HOST_HAL_H
@@ -0,0 +1,92 @@
+/*
+ * Хостовая обёртка заголовка устройства.
+ *
+ * Типы регистров, HAL и константы — настоящие (stm32h750xx.h и
+ * stm32h7xx_hal.h подключаются как есть), меняются только адреса: периферия,
+ * к которой приложение обращается напрямую, лежит в обычной памяти процесса
+ * (host_hal.c). Регистры читаются и пишутся, но сами ничего не делают —
+ * поведение периферии моделируют функции HAL из host_hal.c.
+ */
+#ifndef HOST_STM32H7XX_H
+#define HOST_STM32H7XX_H
+
+#include_next "stm32h7xx.h"
+
+extern GPIO_TypeDef host_gpio[11];
+extern TIM_TypeDef host_tim2, host_tim3;
+extern USART_TypeDef host_usart2, host_usart3;
+extern SPI_TypeDef host_spi2;
+extern I2C_TypeDef host_i2c1;
+extern DMA_Stream_TypeDef host_dma1_stream[8];
+extern EXTI_TypeDef host_exti;
+extern EXTI_Core_TypeDef host_exti_d1;
+extern SCB_Type host_scb;
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_coredebug;
+
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOE
+#undef GPIOF
+#undef GPIOG
+#undef GPIOH
+#undef GPIOI
+#undef GPIOJ
+#undef GPIOK
+#define GPIOA  (&host_gpio[0])
+#define GPIOB  (&host_gpio[1])
+#define GPIOC  (&host_gpio[2])
+#define GPIOD  (&host_gpio[3])
+#define GPIOE  (&host_gpio[4])
+#define GPIOF  (&host_gpio[5])
+#define GPIOG  (&host_gpio[6])
+#define GPIOH  (&host_gpio[7])
+#define GPIOI  (&host_gpio[8])
+#define GPIOJ  (&host_gpio[9])
+#define GPIOK  (&host_gpio[10])
+
+#undef TIM2
+#undef TIM3
+#undef USART2
+#undef USART3
+#undef SPI2
+#undef I2C1
+#define TIM2    (&host_tim2)
+#define TIM3    (&host_tim3)
+#define USART2  (&host_usart2)
+#define USART3  (&host_usart3)
+#define SPI2    (&host_spi2)
+#define I2C1    (&host_i2c1)
+
+#undef DMA1_Stream0
+#undef DMA1_Stream1
+#undef DMA1_Stream2
+#undef DMA1_Stream3
+#undef DMA1_Stream4
+#undef DMA1_Stream5
+#undef DMA1_Stream6
+#undef DMA1_Stream7
+#define DMA1_Stream0  (&host_dma1_stream[0])
+#define DMA1_Stream1  (&host_dma1_stream[1])
+#define DMA1_Stream2  (&host_dma1_stream[2])
+#define DMA1_Stream3  (&host_dma1_stream[3])
+#define DMA1_Stream4  (&host_dma1_stream[4])
+#define DMA1_Stream5  (&host_dma1_stream[5])
+#define DMA1_Stream6  (&host_dma1_stream[6])
+#define DMA1_Stream7  (&host_dma1_stream[7])
+
+#undef EXTI
+#undef EXTI_D1
+#define EXTI     (&host_exti)
+#define EXTI_D1  (&host_exti_d1)
+
+#undef SCB
+#undef DWT
+#undef CoreDebug
+#define SCB        (&host_scb)
+#define DWT        (&host_dwt)
+#define CoreDebug  (&host_coredebug)
+
+#endif // HOST_STM32H7XX_H
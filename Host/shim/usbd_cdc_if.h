@@ -0,0 +1,19 @@
+/*
+ * Хостовая замена USB_DEVICE/App/usbd_cdc_if.h: от класса CDC usb_log.c
+ * нужны только передача и признак занятости, boot.c — конец перечисления.
+ * Реализация — host_hal.c, переданные байты копятся там же (Host_UsbTake).
+ */
+#ifndef HOST_USBD_CDC_IF_H
+#define HOST_USBD_CDC_IF_H
+
+#include <stdint.h>
+
+#define USBD_OK    0U
+#define USBD_BUSY  1U
+#define USBD_FAIL  3U
+
+uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len);
+uint8_t CDC_TxBusy_FS(void);
+uint8_t CDC_IsConfigured_FS(void);
+
+#endif // HOST_USBD_CDC_IF_H
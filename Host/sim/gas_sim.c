@@ -0,0 +1,508 @@
+#include "gas_sim.h"
+#include "gaskitlink.h"
+#include "host_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_MAX     32u     /* STX + адрес + команда + 22 байта данных + CRC */
+#define LINE_QUEUE    8u
+
+/* Ответы одной линии в порядке отправки; что созрело к одной миллисекунде,
+   приходит мастеру одним событием приёма (без паузы IDLE между кадрами) */
+typedef struct {
+    uint32_t due;
+    uint16_t len;
+    uint8_t data[2u * FRAME_MAX];
+} Pending_t;
+
+typedef struct {
+    UART_HandleTypeDef *huart;
+    Pending_t q[LINE_QUEUE];
+    uint8_t head;
+    uint8_t count;
+    uint8_t last[FRAME_MAX];   /* последний ответ — для склейки */
+    uint16_t last_len;
+} Line_t;
+
+static GasSim_Slave_t slaves[GAS_SIM_MAX_SLAVES];
+static uint8_t slave_count;
+static Line_t lines[GAS_SIM_MAX_SLAVES];
+static uint8_t line_count;
+static uint32_t rng;
+
+static uint32_t Rand(void)
+{
+    /* xorshift32 */
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint8_t Roll(uint16_t permille)
+{
+    return permille != 0u && (Rand() % 1000u) < permille;
+}
+
+static Line_t *LineOf(UART_HandleTypeDef *huart)
+{
+    for (uint8_t i = 0; i < line_count; i++) {
+        if (lines[i].huart == huart) return &lines[i];
+    }
+    return NULL;
+}
+
+void GasSim_DefaultConfig(GasSim_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->reply_delay_ms = 3u;
+    cfg->flow_cl_per_min = 4000u;
+    cfg->auto_customer = 1u;
+    cfg->lift_delay_ms = 500u;
+    cfg->start_delay_ms = 300u;
+    cfg->hang_delay_ms = 1000u;
+}
+
+/* ====== Ответы ====== */
+
+static void Queue(Line_t *line, const uint8_t *data, uint16_t len, uint32_t due)
+{
+    if (line->count >= LINE_QUEUE) return;   /* мастер не ждёт столько ответов сразу */
+    Pending_t *p = &line->q[(line->head + line->count) % LINE_QUEUE];
+    p->due = due;
+    p->len = len;
+    memcpy(p->data, data, len);
+    line->count++;
+}
+
+static void Reply(GasSim_Slave_t *s, const uint8_t *addr, char cmd, const char *data)
+{
+    Line_t *line = LineOf(s->huart);
+    uint8_t frame[2u * FRAME_MAX];
+    uint16_t off = 0;
+
+    if (Roll(s->cfg.drop_permille)) {
+        s->stats.dropped++;
+        return;
+    }
+    if (line->last_len != 0u && Roll(s->cfg.merge_permille)) {
+        memcpy(frame, line->last, line->last_len);
+        off = line->last_len;
+        s->stats.merged++;
+    }
+
+    uint16_t len = Gas_BuildFrame(&frame[off], addr[0], addr[1], cmd, data);
+    memcpy(line->last, &frame[off], len);
+    line->last_len = len;
+    if (Roll(s->cfg.crc_error_permille)) {
+        frame[off + len - 1u] ^= 0x5Au;
+        s->stats.crc_errors++;
+    }
+
+    /* Приём заканчивается, когда последний байт дошёл по линии: пауза
+       ответа плюс время кадра при скорости UART мастера */
+    uint32_t delay_us = s->cfg.reply_delay_ms * 1000u;
+    if (s->cfg.reply_jitter_ms) delay_us += (Rand() % (s->cfg.reply_jitter_ms + 1u)) * 1000u;
+    delay_us += Host_UartWireUs(s->huart, (uint16_t)(off + len));
+    uint64_t due_us = Host_NowUs() + delay_us;
+    Queue(line, frame, (uint16_t)(off + len), (uint32_t)((due_us + 999u) / 1000u));
+    s->stats.replies++;
+}
+
+/* FNV-1a по (тик, команда) каждого кадра мастера */
+static void Trace(GasSim_Slave_t *s, uint32_t now, char cmd)
+{
+    uint32_t h = s->stats.trace ? s->stats.trace : 2166136261u;
+    uint8_t b[5] = { (uint8_t)now, (uint8_t)(now >> 8), (uint8_t)(now >> 16), (uint8_t)(now >> 24), (uint8_t)cmd };
+
+    for (uint32_t i = 0; i < sizeof(b); i++) h = (h ^ b[i]) * 16777619u;
+    s->stats.trace = h;
+}
+
+/* 'Ssg': статус и пистолет; в S10 и S90 пистолет на месте — 0 */
+static void ReplyStatus(GasSim_Slave_t *s)
+{
+    char d[3];
+    d[0] = (char)('0' + s->status);
+    d[1] = (s->status == 1u || s->status == 9u) ? '0' : (char)('0' + s->nozzle);
+    d[2] = '\0';
+    Reply(s, s->addr, 'S', d);
+}
+
+/* ====== Состояние ТРК ====== */
+
+#define NEVER_MS  0x3FFFFFFFu   /* «не скоро» для сравнения тиков с переполнением */
+
+static uint8_t Due(uint32_t at, uint32_t now)
+{
+    return (int32_t)(now - at) >= 0;
+}
+
+static void SetStatusAt(GasSim_Slave_t *s, uint8_t status, uint32_t at)
+{
+    s->status = status;
+    s->state_tick = at;
+    if (status == 6u) {
+        s->flow_tick = at;
+        s->last_l_tick = at;
+    }
+}
+
+static void SetStatus(GasSim_Slave_t *s, uint8_t status)
+{
+    SetStatusAt(s, status, HAL_GetTick());
+}
+
+static void UpdateAmount(GasSim_Slave_t *s)
+{
+    s->amount = (uint32_t)(((uint64_t)s->volume_cl * s->price) / 100u);
+}
+
+/* Объём, на котором срабатывает отсечка: пресет объёма или первый
+   сантилитр, на котором сумма дошла до пресета */
+static uint32_t TargetCl(const GasSim_Slave_t *s)
+{
+    if (!s->preset_money) return s->preset;
+    if (s->price == 0u) return UINT32_MAX;
+    return (uint32_t)(((uint64_t)s->preset * 100u + s->price - 1u) / s->price);
+}
+
+/* Миллисекунд налива от flow_tick до отсечки */
+static uint32_t CutoffMs(const GasSim_Slave_t *s)
+{
+    uint32_t target = TargetCl(s);
+    if (s->cfg.flow_cl_per_min == 0u || target == UINT32_MAX) return NEVER_MS;
+    if (s->volume_cl >= target) return 0u;
+
+    uint64_t need = (uint64_t)(target - s->volume_cl) * 60000u - s->flow_acc;
+    uint64_t ms = (need + s->cfg.flow_cl_per_min - 1u) / s->cfg.flow_cl_per_min;
+    return (ms > NEVER_MS) ? NEVER_MS : (uint32_t)ms;
+}
+
+/* Налив с flow_tick до now; на отсечке — S8x ровно в её тик */
+static void Flow(GasSim_Slave_t *s, uint32_t now)
+{
+    uint32_t dt = now - s->flow_tick;
+    uint32_t cut = CutoffMs(s);
+    uint8_t stop = (dt >= cut);
+
+    if (stop) dt = cut;
+    uint64_t acc = s->flow_acc + (uint64_t)s->cfg.flow_cl_per_min * dt;
+    uint32_t cl = (uint32_t)(acc / 60000u);
+    s->flow_acc = (uint32_t)(acc % 60000u);
+    s->volume_cl += cl;
+    s->totalizer[s->nozzle] += cl;
+    s->flow_tick += dt;
+    UpdateAmount(s);
+
+    if (stop) {
+        /* Клапан закрывается ровно на дозе */
+        if (!s->preset_money) {
+            s->volume_cl = s->preset;
+            UpdateAmount(s);
+        } else {
+            s->amount = s->preset;
+        }
+        SetStatusAt(s, 8u, s->flow_tick);
+    }
+}
+
+/* Тик, когда ТРК сама сменит состояние; NEVER_MS от now — не сменит */
+static uint32_t NextChange(const GasSim_Slave_t *s, uint32_t now)
+{
+    switch (s->status) {
+    case 3:
+        if (s->nozzle_up) return s->state_tick;
+        if (s->cfg.auto_customer) return s->state_tick + s->cfg.lift_delay_ms;
+        break;
+    case 4:
+        return s->state_tick + s->cfg.start_delay_ms;
+    case 6:
+        return s->flow_tick + CutoffMs(s);
+    case 8:
+        if (s->cfg.auto_customer) return s->state_tick + s->cfg.hang_delay_ms;
+        break;
+    default:
+        break;
+    }
+    return now + NEVER_MS;
+}
+
+/* Состояние на момент now: все переходы, что случились с прошлого раза,
+   каждый — в свой тик */
+static void Sync(GasSim_Slave_t *s, uint32_t now)
+{
+    for (;;) {
+        uint32_t at = NextChange(s, now);
+        if (s->status == 6u) {
+            Flow(s, now);
+            if (s->status == 6u) return;
+            continue;
+        }
+        if (!Due(at, now)) return;
+
+        switch (s->status) {
+        case 3:
+            s->nozzle_up = 1u;
+            SetStatusAt(s, 4u, at);
+            break;
+        case 4:
+            SetStatusAt(s, 6u, at);
+            break;
+        case 8:
+            s->nozzle_up = 0u;
+            SetStatusAt(s, 9u, at);
+            break;
+        default:
+            return;
+        }
+    }
+}
+
+/* V/M: 'g;nnnnnn;pppp' — пистолет, пресет, цена */
+static void Authorize(GasSim_Slave_t *s, const GasFrame_t *f)
+{
+    if (s->status != 1u && s->status != 2u) return;
+    if (f->data_len < 9u || f->data[1] != ';') return;
+
+    uint8_t nozzle = (uint8_t)(f->data[0] - '0');
+    if (nozzle == 0u || nozzle > GAS_SIM_NOZZLES) return;
+    if (s->status == 2u && nozzle != s->nozzle) return;   /* снят другой пистолет */
+
+    s->nozzle = nozzle;
+    s->preset_money = (f->cmd == 'M') ? 1u : 0u;
+    s->preset = (uint32_t)atol(&f->data[2]);
+    s->price = (f->data_len > 9u) ? (uint32_t)atol(&f->data[9]) : 0u;
+    s->volume_cl = 0u;
+    s->amount = 0u;
+    s->flow_acc = 0u;
+    s->tid = (s->tid >= 'a' && s->tid < 'z') ? (char)(s->tid + 1) : 'a';
+    SetStatus(s, 3u);
+}
+
+static void Handle(GasSim_Slave_t *s, const GasFrame_t *f)
+{
+    char d[40];
+    uint32_t now = HAL_GetTick();
+
+    Sync(s, now);
+    s->stats.rx_frames++;
+    if (f->cmd >= 'A' && f->cmd <= 'Z') s->stats.cmd[f->cmd - 'A']++;
+    Trace(s, now, f->cmd);
+
+    switch (f->cmd) {
+    case 'S':
+        ReplyStatus(s);
+        break;
+
+    case 'V':
+    case 'M':
+        Authorize(s, f);
+        ReplyStatus(s);
+        break;
+
+    case 'L':
+        if (s->status == 6u) {
+            uint32_t gap = now - s->last_l_tick;
+            s->stats.l_polls++;
+            s->stats.l_gap_sum_ms += gap;
+            if (gap > s->stats.l_gap_max_ms) s->stats.l_gap_max_ms = gap;
+            s->last_l_tick = now;
+        }
+        snprintf(d, sizeof(d), "%c%c%c;%06lu", '0' + s->nozzle, s->tid ? s->tid : 'a', '0' + s->status,
+                 (unsigned long)s->volume_cl);
+        Reply(s, s->addr, 'L', d);
+        break;
+
+    case 'R':
+        snprintf(d, sizeof(d), "%c%c%c;%06lu", '0' + s->nozzle, s->tid ? s->tid : 'a', '0' + s->status,
+                 (unsigned long)s->amount);
+        Reply(s, s->addr, 'R', d);
+        break;
+
+    case 'T':
+        snprintf(d, sizeof(d), "%c%c%c;%06lu;%06lu;%04lu", '0' + s->nozzle, s->tid ? s->tid : 'a',
+                 '0' + s->status, (unsigned long)s->amount, (unsigned long)s->volume_cl,
+                 (unsigned long)s->price);
+        Reply(s, s->addr, 'T', d);
+        break;
+
+    case 'C': {
+        uint8_t n = (f->data_len > 0u) ? (uint8_t)(f->data[0] - '0') : 0u;
+        if (n == 0u || n > GAS_SIM_NOZZLES) n = 1u;   /* C0 — счётчик основного пистолета */
+        snprintf(d, sizeof(d), "%c;%09llu", '0' + n, (unsigned long long)(s->totalizer[n] % 1000000000u));
+        Reply(s, s->addr, 'C', d);
+        break;
+    }
+
+    case 'B':
+        if (s->status == 3u || s->status == 4u) SetStatus(s, 5u);
+        else if (s->status == 6u) SetStatus(s, 7u);
+        ReplyStatus(s);
+        break;
+
+    case 'G':
+        if (s->status == 5u) SetStatus(s, 4u);
+        else if (s->status == 7u) SetStatus(s, 6u);
+        ReplyStatus(s);
+        break;
+
+    case 'N':
+        /* Ответ — ещё S90 (как в эталонном логе), следующий S — уже S10 */
+        ReplyStatus(s);
+        if (s->status == 9u) {
+            s->stats.transactions++;
+            s->nozzle = 0u;
+            SetStatus(s, 1u);
+        }
+        break;
+
+    case 'W':
+    case 'Z':
+        if (f->data_len >= 2u) {
+            uint32_t nn = (uint32_t)((f->data[0] - '0') * 10 + (f->data[1] - '0'));
+            if (nn < GAS_SIM_PARAMS) {
+                if (f->cmd == 'W' && f->data_len >= 6u) {
+                    s->param[nn] = (uint16_t)atoi(&f->data[2]);
+                }
+                snprintf(d, sizeof(d), "%02lu%04u", (unsigned long)nn, (unsigned)(s->param[nn] % 10000u));
+                Reply(s, s->addr, 'Z', d);
+            }
+        }
+        break;
+
+    default:
+        break;   /* неизвестная команда — ведомый молчит */
+    }
+}
+
+/* ====== Связь с шимом ====== */
+
+static uint32_t OnTick(void);
+
+static void OnMasterTx(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len)
+{
+    Host_TickHook(OnTick);   /* ответ и новое состояние — в расписание */
+
+    GasFrame_t f;
+    int rc = Gas_ParseFrame(data, len, &f);
+
+    /* D — к контроллеру канала (адрес 00), отвечает первый ведомый линии */
+    if (rc == 0 && f.cmd == 'D' && f.addr_high == 0u && f.addr_low == 0u) {
+        for (uint8_t i = 0; i < slave_count; i++) {
+            if (slaves[i].huart != huart) continue;
+            static const uint8_t ctl[2] = { 0u, 0u };
+            slaves[i].stats.rx_frames++;
+            slaves[i].stats.cmd['D' - 'A']++;
+            Reply(&slaves[i], ctl, 'D', f.data);
+            break;
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < slave_count; i++) {
+        GasSim_Slave_t *s = &slaves[i];
+        if (s->huart != huart || len < 3u || data[1] != s->addr[0] || data[2] != s->addr[1]) continue;
+        if (rc != 0) {
+            s->stats.rx_bad++;
+        } else {
+            Handle(s, &f);
+        }
+        break;
+    }
+}
+
+/* Ответы, созревшие к этой миллисекунде, и тик, когда модель нужна снова */
+static uint32_t OnTick(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t next = now + NEVER_MS;
+
+    for (uint8_t i = 0; i < slave_count; i++) {
+        Sync(&slaves[i], now);
+        uint32_t at = NextChange(&slaves[i], now);
+        if ((int32_t)(at - next) < 0) next = at;
+    }
+
+    for (uint8_t l = 0; l < line_count; l++) {
+        Line_t *line = &lines[l];
+        uint8_t rx[4u * FRAME_MAX];
+        uint16_t n = 0;
+
+        while (line->count != 0u) {
+            Pending_t *p = &line->q[line->head];
+            if (!Due(p->due, now)) break;
+            if (n + p->len <= sizeof(rx)) {
+                memcpy(&rx[n], p->data, p->len);
+                n = (uint16_t)(n + p->len);
+            }
+            line->head = (uint8_t)((line->head + 1u) % LINE_QUEUE);
+            line->count--;
+        }
+        if (n != 0u) Host_UartRx(line->huart, rx, n);
+        if (line->count != 0u && (int32_t)(line->q[line->head].due - next) < 0) {
+            next = line->q[line->head].due;
+        }
+    }
+    /* Переход, который уже наступил, — на следующей миллисекунде */
+    return Due(next, now) ? now + 1u : next;
+}
+
+void GasSim_Init(uint32_t seed)
+{
+    memset(slaves, 0, sizeof(slaves));
+    memset(lines, 0, sizeof(lines));
+    slave_count = 0u;
+    line_count = 0u;
+    rng = seed ? seed : 1u;
+    Host_UartTxHook(OnMasterTx);
+    Host_TickHook(OnTick);
+}
+
+GasSim_Slave_t *GasSim_Add(UART_HandleTypeDef *huart, uint8_t addr, const GasSim_Config_t *cfg)
+{
+    if (slave_count >= GAS_SIM_MAX_SLAVES) return NULL;
+
+    GasSim_Slave_t *s = &slaves[slave_count++];
+    memset(s, 0, sizeof(*s));
+    s->huart = huart;
+    s->addr[0] = 0u;
+    s->addr[1] = addr;
+    if (cfg) {
+        s->cfg = *cfg;
+    } else {
+        GasSim_DefaultConfig(&s->cfg);
+    }
+    s->status = 1u;
+    s->state_tick = HAL_GetTick();
+    Host_TickHook(OnTick);
+
+    if (LineOf(huart) == NULL) lines[line_count++].huart = huart;
+    return s;
+}
+
+void GasSim_Lift(GasSim_Slave_t *s, uint8_t nozzle)
+{
+    Sync(s, HAL_GetTick());
+    Host_TickHook(OnTick);
+    s->nozzle_up = 1u;
+    if (s->status == 1u) {
+        s->nozzle = nozzle;
+        SetStatus(s, 2u);
+    }
+}
+
+/* Пистолет на место: без транзакции — дежурный режим, посреди налива — конец */
+void GasSim_Hang(GasSim_Slave_t *s)
+{
+    Sync(s, HAL_GetTick());
+    Host_TickHook(OnTick);
+    s->nozzle_up = 0u;
+    if (s->status == 2u) {
+        s->nozzle = 0u;
+        SetStatus(s, 1u);
+    } else if (s->status >= 4u && s->status <= 8u) {
+        SetStatus(s, 9u);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * Программная модель ведомого GasKitLink (ТРК) для хостовых тестов.
+ *
+ * Подключается к UART шима: кадры мастера приходят через Host_UartTxHook,
+ * ответы уходят через Host_UartRx с задержкой ответа (3 мс по протоколу),
+ * разбросом и временем кадра на линии (Host_UartWireUs). Время —
+ * виртуальное; состояние считается по требованию (кадр мастера, ответ),
+ * а хук тика шима зовёт модель только к её следующему событию — отсечке,
+ * смене статуса, готовому ответу — поэтому Host_Sleep проскакивает налив.
+ *
+ * Статусы и команды — по протоколу 1.2 и эталонному логу:
+ *   V/M  — авторизация с пресетом объёма/суммы: S10 -> S31;
+ *   дальше «покупатель»: пистолет снят -> S41, пошёл налив -> S61,
+ *   объём растёт с заданным расходом, на пресете налив обрывается -> S81,
+ *   пистолет повешен -> S90; N закрывает транзакцию -> S10.
+ *   B/G  — пауза и продолжение (S3x/S4x -> S5x, S6x -> S7x и обратно).
+ *   L/R/T/C — объём, сумма, итог транзакции, тотализатор.
+ *   W/Z  — параметры, D — переключение канала (адрес 00).
+ * Без auto_customer пистолетом управляет тест (GasSim_Lift/GasSim_Hang).
+ *
+ * Несколько ведомых на одной линии различаются адресом; отвечает только
+ * тот, кому адресован кадр. Сбои (на ответ): порча CRC, потеря ответа,
+ * склейка с предыдущим ответом в одно событие приёма. Случайность —
+ * от seed в GasSim_Init, прогон воспроизводим.
+ */
+#ifndef GAS_SIM_H
+#define GAS_SIM_H
+
+#include "main.h"
+#include <stdint.h>
+
+#define GAS_SIM_MAX_SLAVES  8u
+#define GAS_SIM_NOZZLES     6u
+#define GAS_SIM_PARAMS      100u
+
+typedef struct {
+    uint16_t reply_delay_ms;       /* 3 мс по протоколу */
+    uint16_t reply_jitter_ms;      /* + равномерно 0..jitter */
+    uint16_t crc_error_permille;
+    uint16_t drop_permille;
+    uint16_t merge_permille;
+    uint32_t flow_cl_per_min;      /* расход: 4000 = 40 л/мин */
+    uint8_t  auto_customer;        /* пистолет снимают и вешают сами */
+    uint16_t lift_delay_ms;        /* S31 -> S41 */
+    uint16_t start_delay_ms;       /* S41 -> S61 */
+    uint16_t hang_delay_ms;        /* S81 -> S90 */
+} GasSim_Config_t;
+
+typedef struct {
+    uint32_t rx_frames;            /* кадров по нашему адресу */
+    uint32_t rx_bad;               /* ... с ошибкой разбора (CRC мастера) */
+    uint32_t cmd[26];              /* по командам 'A'..'Z' */
+    uint32_t replies;
+    uint32_t crc_errors;           /* внесённые сбои */
+    uint32_t dropped;
+    uint32_t merged;
+    uint32_t transactions;         /* закрыто командой N */
+    uint32_t l_polls;              /* L во время налива */
+    uint32_t l_gap_max_ms;         /* наибольший интервал между L в наливе */
+    uint64_t l_gap_sum_ms;
+    uint32_t trace;                /* хеш (тик, команда) кадров мастера — сверка прогонов */
+} GasSim_Stats_t;
+
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uint8_t addr[2];
+    GasSim_Config_t cfg;
+
+    uint8_t status;                /* 0..9 */
+    uint8_t nozzle;                /* выбранный пистолет, 0 — нет */
+    uint8_t nozzle_up;
+    char tid;                      /* 'a'..'z' */
+    uint8_t preset_money;          /* 1 — M, 0 — V */
+    uint32_t preset;               /* сантилитры или деньги */
+    uint32_t price;
+    uint32_t volume_cl;
+    uint32_t amount;
+    uint32_t flow_acc;             /* доли сантилитра, 1/60000 */
+    uint32_t flow_tick;            /* налив посчитан до этого тика */
+    uint32_t state_tick;           /* вход в текущий статус */
+    uint32_t last_l_tick;
+    uint64_t totalizer[GAS_SIM_NOZZLES + 1u];
+    uint16_t param[GAS_SIM_PARAMS];
+
+    GasSim_Stats_t stats;
+} GasSim_Slave_t;
+
+void GasSim_DefaultConfig(GasSim_Config_t *cfg);
+
+/* Сбрасывает модель и занимает перехват UART и тик шима (после App_Init) */
+void GasSim_Init(uint32_t seed);
+
+/* Ведомый с адресом 0x00 addr на линии huart; cfg = NULL — по умолчанию */
+GasSim_Slave_t *GasSim_Add(UART_HandleTypeDef *huart, uint8_t addr, const GasSim_Config_t *cfg);
+
+/* Пистолет: снят (S21 без авторизации, S41 после неё) и повешен */
+void GasSim_Lift(GasSim_Slave_t *s, uint8_t nozzle);
+void GasSim_Hang(GasSim_Slave_t *s);
+
+#endif // GAS_SIM_H
@@ -0,0 +1,370 @@
+#include "replay.h"
+#include "app.h"
+#include "host_hal.h"
+#include "gaskitlink.h"
+#include "dispenser.h"
+#include "usart.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_CHUNK_MS   10u
+#define REPLAY_LIMIT_MS   (30u * 60u * 1000u)
+#define REPLAY_QUEUE      4u
+#define NEVER_MS          0x3FFFFFFFu
+
+typedef struct {
+    uint32_t due;
+    uint8_t len;
+    uint8_t data[REPLAY_FRAME_MAX];
+} Pending_t;
+
+static const Replay_Log_t *script;
+static Replay_Result_t *result;
+static uint32_t cursor;                    /* следующий обмен эталона */
+static uint8_t phase;                      /* цифра статуса из последнего ответа S */
+static uint8_t ref_phase[REPLAY_MAX_EXCHANGES];
+static const Replay_Exchange_t *last_reply[26];
+static uint32_t last_tx_tick;
+static uint8_t tx_seen;
+static Pending_t queue[REPLAY_QUEUE];
+static uint8_t queue_count;
+
+/* ====== Разбор лога ====== */
+
+static const char *const ctl_names[32] = {
+    "NUL", "SOH", "STX", "ETX", "EOT", "ENQ", "ACK", "BEL",
+    "BS",  "HT",  "LF",  "VT",  "FF",  "CR",  "SO",  "SI",
+    "DLE", "DC1", "DC2", "DC3", "DC4", "NAK", "SYN", "ETB",
+    "CAN", "EM",  "SUB", "ESC", "FS",  "GS",  "RS",  "US",
+};
+
+/* <NAME> в начале s -> байт и длина записи; 0 — это не имя управляющего байта */
+static uint8_t DecodeName(const char *s, uint8_t *byte)
+{
+    if (s[0] != '<') return 0u;
+    const char *end = strchr(s, '>');
+    if (end == NULL || end - s > 4) return 0u;
+
+    size_t n = (size_t)(end - s - 1);
+    for (uint8_t c = 0; c < 32u; c++) {
+        if (strlen(ctl_names[c]) == n && strncmp(&s[1], ctl_names[c], n) == 0) {
+            *byte = c;
+            return (uint8_t)(n + 2u);
+        }
+    }
+    if (n == 3u && strncmp(&s[1], "DEL", 3) == 0) {
+        *byte = 0x7Fu;
+        return 5u;
+    }
+    return 0u;
+}
+
+/* Конец кадра не размечен: CRC — любой байт, в том числе '/' или пробел.
+   Кадр кончается там, где сошёлся CRC и дальше пробел, «//» или конец строки */
+uint16_t Replay_ParseLine(const char *line, uint8_t *frame, uint16_t max)
+{
+    const char *p = line;
+    uint16_t len = 0;
+
+    while (*p != '\0' && *p != '\r' && *p != '\n' && len < max) {
+        uint8_t b;
+        uint8_t n = DecodeName(p, &b);
+        if (n == 0u) {
+            b = (uint8_t)*p;
+            n = 1u;
+        }
+        if (len == 0u && b != GAS_STX) return 0u;
+        frame[len++] = b;
+        p += n;
+
+        uint8_t at_end = (*p == '\0' || *p == '\r' || *p == '\n' || *p == ' ' || *p == '\t' ||
+                          (p[0] == '/' && p[1] == '/'));
+        if (len >= 5u && at_end && Gas_CalculateCRC(&frame[1], (uint16_t)(len - 2u)) == frame[len - 1u]) {
+            return len;
+        }
+    }
+    return 0u;
+}
+
+/* Ответ ведомого отличается от запроса той же буквы данными */
+static uint8_t IsReply(const GasFrame_t *f)
+{
+    switch (f->cmd) {
+    case 'S': return f->data_len >= 2u;
+    case 'L':
+    case 'R':
+    case 'T': return f->data_len > 0u;
+    case 'C': return f->data_len > 1u;
+    case 'Z': return f->data_len > 2u;
+    default:  return 0u;
+    }
+}
+
+int Replay_Load(const char *path, Replay_Log_t *log)
+{
+    FILE *f = fopen(path, "rb");
+    char line[512];
+    uint16_t line_no = 0;
+    Replay_Exchange_t *open = NULL;        /* запрос, ещё без ответа */
+
+    memset(log, 0, sizeof(*log));
+    if (f == NULL) return -1;
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        line_no++;
+        if (strncmp(line, "<STX>", 5) != 0) continue;
+
+        uint8_t frame[REPLAY_FRAME_MAX];
+        GasFrame_t gf;
+        uint16_t len = Replay_ParseLine(line, frame, sizeof(frame));
+        log->frames++;
+        if (len == 0u || Gas_ParseFrame(frame, len, &gf) != 0) {
+            log->bad++;
+            continue;
+        }
+
+        if (IsReply(&gf)) {
+            if (open == NULL) {
+                log->orphans++;
+            } else {
+                memcpy(open->reply, frame, len);
+                open->reply_len = (uint8_t)len;
+                open = NULL;
+            }
+            continue;
+        }
+        if (log->count >= REPLAY_MAX_EXCHANGES) break;
+        open = &log->ex[log->count++];
+        open->cmd = gf.cmd;
+        open->data_len = gf.data_len;
+        memcpy(open->data, gf.data, gf.data_len);
+        open->line = line_no;
+    }
+    fclose(f);
+    return 0;
+}
+
+/* ====== Ведомый по сценарию ====== */
+
+static uint8_t PhaseOf(const uint8_t *reply, uint8_t len, uint8_t prev)
+{
+    if (len >= 7u && reply[3] == 'S' && reply[4] >= '0' && reply[4] <= '9') {
+        return (uint8_t)(reply[4] - '0');
+    }
+    return prev;
+}
+
+static void AddDiff(char kind, uint8_t cmd, uint8_t ph, uint16_t line)
+{
+    if (result->diff_count < REPLAY_DIFF_MAX) {
+        Replay_Diff_t *d = &result->diff[result->diff_count];
+        d->kind = kind;
+        d->cmd = cmd;
+        d->phase = ph;
+        d->line = line;
+        d->tick = HAL_GetTick();
+    }
+    result->diff_count++;
+}
+
+/* Обмен эталона пройден: ведомый теперь в его состоянии */
+static void Consume(uint32_t k, uint8_t missing)
+{
+    const Replay_Exchange_t *e = &script->ex[k];
+
+    if (e->reply_len != 0u && e->reply[3] >= 'A' && e->reply[3] <= 'Z') {
+        last_reply[e->reply[3] - 'A'] = e;
+    }
+    if (missing) {
+        result->missing++;
+        result->phase[ref_phase[k]].missing++;
+        if (e->cmd >= 'A' && e->cmd <= 'Z') result->missing_cmd[e->cmd - 'A']++;
+        AddDiff('-', e->cmd, ref_phase[k], e->line);
+    }
+}
+
+static void Schedule(const uint8_t *data, uint8_t len)
+{
+    if (queue_count >= REPLAY_QUEUE) return;
+
+    uint64_t due_us = Host_NowUs() + 3000u + Host_UartWireUs(&huart2, len);
+    Pending_t *p = &queue[queue_count++];
+    p->due = (uint32_t)((due_us + 999u) / 1000u);
+    p->len = len;
+    memcpy(p->data, data, len);
+}
+
+static uint32_t OnTick(void);
+
+static void OnMasterTx(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len)
+{
+    GasFrame_t f;
+
+    if (huart != &huart2 || Gas_ParseFrame(data, len, &f) != 0) return;
+    Host_TickHook(OnTick);
+
+    uint32_t now = HAL_GetTick();
+    if (tx_seen) result->phase[phase].our_ms += now - last_tx_tick;
+    last_tx_tick = now;
+    tx_seen = 1u;
+    result->phase[phase].our_rounds++;
+
+    uint32_t end = cursor + REPLAY_LOOKAHEAD;
+    if (end > script->count) end = script->count;
+
+    const Replay_Exchange_t *reply = NULL;
+    for (uint32_t j = cursor; j < end; j++) {
+        const Replay_Exchange_t *e = &script->ex[j];
+        if (e->cmd != f.cmd || e->data_len != f.data_len || memcmp(e->data, f.data, f.data_len) != 0) continue;
+
+        while (cursor < j) Consume(cursor++, 1u);
+        Consume(cursor++, 0u);
+        result->matched++;
+        reply = e;
+        break;
+    }
+    if (reply == NULL) {
+        result->extra++;
+        result->phase[phase].extra++;
+        if (f.cmd >= 'A' && f.cmd <= 'Z') {
+            result->extra_cmd[f.cmd - 'A']++;
+            reply = last_reply[f.cmd - 'A'];
+        }
+        AddDiff('+', f.cmd, phase, cursor < script->count ? script->ex[cursor].line : 0u);
+    }
+
+    if (reply == NULL || reply->reply_len == 0u) {
+        result->silent++;
+        return;
+    }
+    Schedule(reply->reply, reply->reply_len);
+    phase = PhaseOf(reply->reply, reply->reply_len, phase);
+}
+
+static uint32_t OnTick(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint8_t rx[REPLAY_QUEUE * REPLAY_FRAME_MAX];
+    uint16_t n = 0;
+
+    while (queue_count != 0u && (int32_t)(queue[0].due - now) <= 0) {
+        memcpy(&rx[n], queue[0].data, queue[0].len);
+        n = (uint16_t)(n + queue[0].len);
+        memmove(&queue[0], &queue[1], (queue_count - 1u) * sizeof(queue[0]));
+        queue_count--;
+    }
+    if (n != 0u) Host_UartRx(&huart2, rx, n);
+    return queue_count != 0u ? queue[0].due : now + NEVER_MS;
+}
+
+/* Команда оператора, до которой дошёл сценарий: «нажали» на пульте */
+static void Operator(void)
+{
+    if (cursor >= script->count || queue_count != 0u) return;
+    if (Dispenser_GetUnit(0)->state != STATE_IDLE) return;
+
+    const Replay_Exchange_t *e = &script->ex[cursor];
+    char *p;
+    unsigned long nozzle, preset, price;
+
+    switch (e->cmd) {
+    case 'V':
+    case 'M':
+        nozzle = strtoul(e->data, &p, 10);
+        preset = (*p == ';') ? strtoul(p + 1, &p, 10) : 0u;
+        price = (*p == ';') ? strtoul(p + 1, &p, 10) : 0u;
+        if (e->cmd == 'V') Dispenser_StartVolume(0, (uint8_t)nozzle, preset, price);
+        else Dispenser_StartAmount(0, (uint8_t)nozzle, preset, price);
+        break;
+    case 'B':
+        Dispenser_Stop(0);
+        break;
+    case 'G':
+        Dispenser_Resume(0);
+        break;
+    default:
+        break;
+    }
+}
+
+void Replay_Run(const Replay_Log_t *log, Replay_Result_t *res)
+{
+    memset(res, 0, sizeof(*res));
+    script = log;
+    result = res;
+    cursor = 0u;
+    phase = 1u;
+    tx_seen = 0u;
+    queue_count = 0u;
+    memset(last_reply, 0, sizeof(last_reply));
+
+    App_Init();
+    Host_UartTxHook(OnMasterTx);
+    Host_TickHook(OnTick);
+
+    /* Эталон: фаза каждого обмена и обмен впритык на скорости линии */
+    uint8_t ph = 1u;
+    for (uint32_t k = 0; k < log->count; k++) {
+        const Replay_Exchange_t *e = &log->ex[k];
+        uint32_t us = Host_UartWireUs(&huart2, (uint16_t)(e->data_len + 5u));
+        if (e->reply_len != 0u) us += 3000u + Host_UartWireUs(&huart2, e->reply_len);
+        ref_phase[k] = ph;
+        res->phase[ph].ref_rounds++;
+        res->phase[ph].ref_min_us += us;
+        ph = PhaseOf(e->reply, e->reply_len, ph);
+    }
+
+    while (cursor < log->count && HAL_GetTick() < REPLAY_LIMIT_MS) {
+        Operator();
+        App_RunFast(REPLAY_CHUNK_MS);
+    }
+    res->completed = (cursor >= log->count);
+    while (cursor < log->count) Consume(cursor++, 1u);
+    res->virtual_ms = HAL_GetTick();
+
+    Host_UartTxHook(NULL);
+    Host_TickHook(NULL);
+}
+
+/* ====== Отчёт ====== */
+
+void Replay_Print(const Replay_Log_t *log, const Replay_Result_t *res, FILE *out)
+{
+    fprintf(out, "reference: %lu frames, %lu exchanges, %lu bad, %lu orphan replies\n",
+            (unsigned long)log->frames, (unsigned long)log->count,
+            (unsigned long)log->bad, (unsigned long)log->orphans);
+    fprintf(out, "replay: %s at %.1f s virtual; matched %lu, extra %lu, missing %lu, unanswered %lu\n",
+            res->completed ? "completed" : "STALLED", res->virtual_ms / 1000.0,
+            (unsigned long)res->matched, (unsigned long)res->extra,
+            (unsigned long)res->missing, (unsigned long)res->silent);
+
+    fprintf(out, "  missing (reference only):");
+    for (uint8_t c = 0; c < 26u; c++) {
+        if (res->missing_cmd[c]) fprintf(out, " %c x%lu", 'A' + c, (unsigned long)res->missing_cmd[c]);
+    }
+    fprintf(out, "\n  extra (ours only):");
+    for (uint8_t c = 0; c < 26u; c++) {
+        if (res->extra_cmd[c]) fprintf(out, " %c x%lu", 'A' + c, (unsigned long)res->extra_cmd[c]);
+    }
+
+    fprintf(out, "\n\n%-6s %8s %8s %7s %8s %12s %10s\n",
+            "phase", "ref", "ours", "extra", "missing", "ref min ms", "ours ms");
+    for (uint8_t p = 0; p < REPLAY_PHASES; p++) {
+        const Replay_Phase_t *ph = &res->phase[p];
+        if (ph->ref_rounds == 0u && ph->our_rounds == 0u) continue;
+        fprintf(out, "S%ux    %8lu %8lu %7lu %8lu %12.1f %10lu\n", p,
+                (unsigned long)ph->ref_rounds, (unsigned long)ph->our_rounds,
+                (unsigned long)ph->extra, (unsigned long)ph->missing,
+                ph->ref_min_us / 1000.0, (unsigned long)ph->our_ms);
+    }
+
+    if (res->diff_count != 0u) {
+        uint32_t shown = res->diff_count < REPLAY_DIFF_MAX ? res->diff_count : REPLAY_DIFF_MAX;
+        fprintf(out, "\ndifferences (first %lu of %lu):\n", (unsigned long)shown, (unsigned long)res->diff_count);
+        for (uint32_t i = 0; i < shown; i++) {
+            const Replay_Diff_t *d = &res->diff[i];
+            fprintf(out, "  %c %-2c S%ux  log line %-4u  at %lu ms\n", d->kind, d->cmd, d->phase,
+                    (unsigned)d->line, (unsigned long)d->tick);
+        }
+    }
+}
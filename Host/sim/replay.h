@@ -0,0 +1,93 @@
+/*
+ * Прогон эталонного лога (ЛОГ_эталонной_программы.txt) против нашего мастера.
+ *
+ * Лог — обмен эталонной программы по строке на кадр: <STX><NUL><SOH>, команда,
+ * данные и CRC; управляющие байты записаны именами в угловых скобках,
+ * после кадра может идти комментарий «//...». Строки без <STX> (описание
+ * протокола в конце файла) пропускаются, CRC каждого кадра проверяется.
+ * Кадр мастера и следующий за ним ответ ведомого — один обмен.
+ *
+ * Ведомый по сценарию: на кадр мастера он ищет в логе ближайший обмен с
+ * той же командой и данными (не дальше REPLAY_LOOKAHEAD) и отвечает кадром
+ * из лога. Пропущенные обмены эталона — «missing» (наш мастер их не делает),
+ * кадры без пары — «extra»: на них ведомый отвечает последним ответом на
+ * ту же команду, как ответил бы в том же состоянии. Ведомый двигается по
+ * логу только запросами мастера, поэтому прогон не зависит от скорости
+ * налива. Команды оператора (V/M/B/G) подаются через API dispenser.c,
+ * когда сценарий дошёл до них.
+ *
+ * В логе нет отметок времени: эталон по времени — нижняя граница «обмен
+ * впритык» (кадр мастера, 3 мс задержки ответа, ответ на 9600 8N1).
+ */
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define REPLAY_MAX_EXCHANGES  1024u
+#define REPLAY_FRAME_MAX      32u
+#define REPLAY_LOOKAHEAD      4u
+#define REPLAY_DIFF_MAX       32u
+#define REPLAY_PHASES         10u      /* по первой цифре статуса S */
+
+typedef struct {
+    uint8_t  cmd;                      /* кадр мастера */
+    uint8_t  data_len;
+    char     data[REPLAY_FRAME_MAX];
+    uint8_t  reply[REPLAY_FRAME_MAX];  /* кадр ведомого как есть, 0 байт — молчание */
+    uint8_t  reply_len;
+    uint16_t line;                     /* строка лога с кадром мастера */
+} Replay_Exchange_t;
+
+typedef struct {
+    Replay_Exchange_t ex[REPLAY_MAX_EXCHANGES];
+    uint32_t count;
+    uint32_t frames;                   /* кадров в логе */
+    uint32_t bad;                      /* не разобраны или не сошёлся CRC */
+    uint32_t orphans;                  /* ответ без запроса */
+} Replay_Log_t;
+
+typedef struct {
+    char     kind;                     /* '-' только эталон, '+' только наш мастер */
+    uint8_t  cmd;
+    uint8_t  phase;
+    uint16_t line;                     /* строка лога (для '+' — где был сценарий) */
+    uint32_t tick;
+} Replay_Diff_t;
+
+typedef struct {
+    uint32_t ref_rounds;
+    uint32_t our_rounds;
+    uint32_t extra;
+    uint32_t missing;
+    uint32_t ref_min_us;               /* обмен впритык */
+    uint32_t our_ms;
+} Replay_Phase_t;
+
+typedef struct {
+    uint8_t  completed;                /* сценарий пройден до конца */
+    uint32_t virtual_ms;
+    uint32_t matched;
+    uint32_t extra;
+    uint32_t missing;
+    uint32_t silent;                   /* наших кадров, оставшихся без ответа */
+    uint32_t extra_cmd[26];
+    uint32_t missing_cmd[26];
+    Replay_Phase_t phase[REPLAY_PHASES];
+    Replay_Diff_t diff[REPLAY_DIFF_MAX];
+    uint32_t diff_count;               /* всего расхождений, в diff — первые */
+} Replay_Result_t;
+
+/* Строка лога -> кадр; 0 — в строке нет кадра или он битый */
+uint16_t Replay_ParseLine(const char *line, uint8_t *frame, uint16_t max);
+
+/* 0 — прочитан; -1 — нет файла */
+int Replay_Load(const char *path, Replay_Log_t *log);
+
+/* Загрузка приложения, ведомый по сценарию на USART2, прогон до конца лога */
+void Replay_Run(const Replay_Log_t *log, Replay_Result_t *res);
+
+void Replay_Print(const Replay_Log_t *log, const Replay_Result_t *res, FILE *out);
+
+#endif // REPLAY_H
@@ -0,0 +1,37 @@
+/*
+ * Эталонный лог против нашего мастера (sim/replay.h).
+ *
+ *   host_replay [--log PATH] [--max-extra N] [--max-missing N]
+ *
+ * Код возврата 1, если сценарий не пройден до конца или лишних/пропущенных
+ * обменов больше заданного (для ctest — сторож поведения на линии).
+ */
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static Replay_Log_t log_;
+static Replay_Result_t res;
+
+int main(int argc, char **argv)
+{
+    const char *path = REPLAY_LOG_PATH;
+    unsigned long max_extra = ~0ul, max_missing = ~0ul;
+
+    for (int i = 1; i < argc; i++) {
+        const char *val = (i + 1 < argc) ? argv[i + 1] : "0";
+        if (strcmp(argv[i], "--log") == 0) { path = val; i++; }
+        else if (strcmp(argv[i], "--max-extra") == 0) { max_extra = strtoul(val, NULL, 0); i++; }
+        else if (strcmp(argv[i], "--max-missing") == 0) { max_missing = strtoul(val, NULL, 0); i++; }
+    }
+
+    if (Replay_Load(path, &log_) != 0) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return 1;
+    }
+    Replay_Run(&log_, &res);
+    Replay_Print(&log_, &res, stdout);
+
+    return (res.completed && res.extra <= max_extra && res.missing <= max_missing) ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include "shift.h"
+#include "app.h"
+#include "host_hal.h"
+#include "gas_sim.h"
+#include "dispenser.h"
+#include "config_store.h"
+#include "usart.h"
+#include <string.h>
+
+#define SHIFT_CHUNK_MS   50u    /* шаг, с которым «покупатели» смотрят на ТРК */
+#define SHIFT_LIMIT_MS   (24u * 3600u * 1000u)
+
+typedef struct {
+    GasSim_Slave_t *slave;
+    uint32_t next_start;          /* тик, когда подойдёт следующий покупатель */
+    uint32_t closed;              /* транзакций ТРК, уже сверенных с мастером */
+    uint32_t start_tick;
+    uint8_t active;
+} ShiftUnit_t;
+
+static uint32_t rng;
+
+static uint32_t Rand(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+void Shift_DefaultConfig(Shift_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->seed = 1u;
+    cfg->transactions = 500u;
+    cfg->units = CONFIG_UNITS;
+    cfg->fault_permille = 5u;
+    cfg->max_gap_ms = 60000u;
+}
+
+/* Новый покупатель: 2..50 л или 500..5000 по сумме, по цене из настроек */
+static void Start(uint8_t u)
+{
+    uint32_t price = Config_Get()->price[u][0];
+
+    if (Rand() & 1u) {
+        Dispenser_StartVolume(u, 1, 200u + Rand() % 4801u, price);
+    } else {
+        Dispenser_StartAmount(u, 1, 500u + Rand() % 4501u, price);
+    }
+}
+
+void Shift_Run(const Shift_Config_t *cfg, Shift_Result_t *res)
+{
+    UART_HandleTypeDef *const lines[CONFIG_UNITS] = { &huart2, &huart3 };
+    ShiftUnit_t units[CONFIG_UNITS];
+    uint8_t n = (cfg->units == 0u || cfg->units > CONFIG_UNITS) ? CONFIG_UNITS : cfg->units;
+    uint32_t started = 0;
+
+    memset(res, 0, sizeof(*res));
+    memset(units, 0, sizeof(units));
+    rng = cfg->seed ? cfg->seed : 1u;
+
+    App_Init();
+    GasSim_Init(cfg->seed);
+
+    GasSim_Config_t sc;
+    GasSim_DefaultConfig(&sc);
+    sc.reply_jitter_ms = 2u;
+    sc.crc_error_permille = cfg->fault_permille;
+    sc.drop_permille = cfg->fault_permille;
+    for (uint8_t u = 0; u < n; u++) {
+        units[u].slave = GasSim_Add(lines[u], Config_Get()->slave_addr[u], &sc);
+        units[u].next_start = 1000u + Rand() % (cfg->max_gap_ms + 1u);
+    }
+
+    while (res->transactions < cfg->transactions && HAL_GetTick() < SHIFT_LIMIT_MS) {
+        res->steps += cfg->stepwise ? SHIFT_CHUNK_MS : App_RunFast(SHIFT_CHUNK_MS);
+        if (cfg->stepwise) App_Run(SHIFT_CHUNK_MS);
+
+        for (uint8_t u = 0; u < n; u++) {
+            ShiftUnit_t *su = &units[u];
+            DispenserUnit_t *unit = Dispenser_GetUnit(u);
+
+            /* Транзакция закрыта: итог мастера (T) против счётчиков ТРК */
+            if (su->slave->stats.transactions != su->closed) {
+                su->closed = su->slave->stats.transactions;
+                su->active = 0u;
+                res->transactions++;
+                res->volume_cl += unit->volume_cl;
+                res->amount += unit->amount;
+                if (unit->volume_cl != su->slave->volume_cl || unit->amount != su->slave->amount) {
+                    res->mismatches++;
+                }
+                su->next_start = HAL_GetTick() + Rand() % (cfg->max_gap_ms + 1u);
+            }
+
+            /* Авторизация не дошла — покупатель жмёт «пуск» ещё раз */
+            if (su->active && su->slave->status == 1u && HAL_GetTick() - su->start_tick > 3000u &&
+                unit->state == STATE_IDLE) {
+                su->active = 0u;
+                started--;
+            }
+
+            if (!su->active && started < cfg->transactions && unit->is_connected &&
+                unit->status == DS_IDLE && unit->state == STATE_IDLE &&
+                (int32_t)(HAL_GetTick() - su->next_start) >= 0) {
+                Start(u);
+                su->start_tick = HAL_GetTick();
+                su->active = 1u;
+                started++;
+            }
+        }
+    }
+
+    res->virtual_ms = HAL_GetTick();
+    res->digest = 2166136261u;
+    for (uint8_t u = 0; u < n; u++) {
+        const GasSim_Stats_t *st = &units[u].slave->stats;
+        if (st->l_gap_max_ms > res->l_gap_max_ms) res->l_gap_max_ms = st->l_gap_max_ms;
+        res->digest = (res->digest ^ st->trace) * 16777619u;
+        res->digest = (res->digest ^ (uint32_t)units[u].slave->totalizer[1]) * 16777619u;
+    }
+}
@@ -0,0 +1,35 @@
+/*
+ * Смена на АЗС в модельном времени: ТРК на обеих линиях, покупатели
+ * приходят со случайными паузами и пресетами (объём или сумма), мастер —
+ * настоящий dispenser.c. Всё случайное — от seed, прогон воспроизводим:
+ * одинаковый seed даёт одинаковый digest.
+ */
+#ifndef SHIFT_H
+#define SHIFT_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t seed;
+    uint32_t transactions;        /* всего по обеим ТРК */
+    uint8_t  units;               /* 1..CONFIG_UNITS */
+    uint8_t  stepwise;            /* 1 — App_Run по миллисекунде, 0 — App_RunFast */
+    uint16_t fault_permille;      /* порча CRC и потеря ответа, каждая */
+    uint32_t max_gap_ms;          /* пауза между покупателями 0..max */
+} Shift_Config_t;
+
+typedef struct {
+    uint32_t transactions;        /* закрыто командой N */
+    uint32_t virtual_ms;
+    uint32_t steps;               /* итераций main loop */
+    uint64_t volume_cl;           /* по данным мастера (T) */
+    uint64_t amount;
+    uint32_t mismatches;          /* итог мастера разошёлся с ТРК */
+    uint32_t l_gap_max_ms;
+    uint32_t digest;
+} Shift_Result_t;
+
+void Shift_DefaultConfig(Shift_Config_t *cfg);
+void Shift_Run(const Shift_Config_t *cfg, Shift_Result_t *res);
+
+#endif // SHIFT_H
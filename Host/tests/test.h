@@ -0,0 +1,73 @@
+/*
+ * Минимальный раннер: тест — функция void(void), список — в test_main.c.
+ * CHECK* при ошибке печатают место и выходят из теста, остальные тесты
+ * выполняются дальше. Код возврата host_tests — число упавших тестов.
+ */
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdint.h>
+
+void Test_Fail(const char *file, int line, const char *expr, long long a, long long b);
+
+#define CHECK(cond) do { \
+    if (!(cond)) { Test_Fail(__FILE__, __LINE__, #cond, 0, 0); return; } \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long long test_a_ = (long long)(a), test_b_ = (long long)(b); \
+    if (test_a_ != test_b_) { Test_Fail(__FILE__, __LINE__, #a " == " #b, test_a_, test_b_); return; } \
+} while (0)
+
+/* Подстрока в выводе USB-лога, накопленном с прошлого вызова */
+int Test_UsbContains(const char *needle);
+
+#define TEST_LIST(X) \
+    X(gas_build_parse_roundtrip) \
+    X(gas_parse_rejects_bad_frames) \
+    X(gas_build_truncates_data) \
+    X(eeprom_async_write_crosses_page) \
+    X(eeprom_blocking_write_crosses_page) \
+    X(eeprom_write_survives_reset) \
+    X(eeprom_wb_page_written_once) \
+    X(eeprom_async_read_sees_flushed_page) \
+    X(config_save_and_reload) \
+    X(config_save_one_write_per_page) \
+    X(config_defaults_on_blank_eeprom) \
+    X(config_torn_newest_slot_falls_back) \
+    X(config_seq_wraparound) \
+    X(config_legacy_prices_migrated) \
+    X(config_old_version_migrated_and_resaved) \
+    X(config_save_failure_reported_while_barrier_pending) \
+    X(boot_first_poll_under_50ms) \
+    X(boot_stored_config_switches_slave) \
+    X(boot_panel_settings_without_reinit) \
+    X(sched_priority_and_yield) \
+    X(sched_protocol_latency_bounded_by_step) \
+    X(sched_app_dump) \
+    X(usb_log_boot_banner) \
+    X(usb_log_long_output_in_order) \
+    X(keyboard_press_release_events) \
+    X(keyboard_idle_after_release) \
+    X(ui_first_frame_reaches_panel) \
+    X(ui_window_refresh_with_col_offset) \
+    X(ui_big_char_missing_glyph_drawn_as_frame) \
+    X(sim_volume_transaction) \
+    X(sim_amount_transaction) \
+    X(sim_faults_recovered_by_retries) \
+    X(sim_pause_resume) \
+    X(sim_shared_line_addressing) \
+    X(sim_uart_byte_time) \
+    X(sim_link_timeout_fast_forward) \
+    X(sim_fast_forward_matches_stepwise) \
+    X(sim_shift_reproducible) \
+    X(replay_parse_log_line) \
+    X(replay_reference_log) \
+    X(bench_result_json) \
+    X(bench_suite_runs)
+
+#define TEST_DECL_(name) void test_##name(void);
+TEST_LIST(TEST_DECL_)
+#undef TEST_DECL_
+
+#endif // TEST_H
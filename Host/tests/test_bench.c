@@ -0,0 +1,41 @@
+#include "test.h"
+#include "app.h"
+#include "bench.h"
+#include <string.h>
+
+/* Строка отчёта: среднее по всем итерациям, минимум — по лучшей пачке */
+void test_bench_result_json(void)
+{
+    Bench_Result_t r;
+    char line[BENCH_LINE_MAX];
+
+    memset(&r, 0, sizeof(r));
+    r.iters = 1600u;
+    r.batch = 100u;
+    r.ns = 2000u;
+    r.min_ns = 110u;
+    r.cycles = 4850u;
+    r.min_cycles = 300u;
+    uint16_t len = Bench_FormatResult(line, sizeof(line), "gas_crc", &r);
+
+    CHECK_EQ(len, strlen(line));
+    CHECK(strcmp(line, "{\"bench\":\"gas_crc\",\"platform\":\"host\",\"iters\":1600,"
+                       "\"ns_per_op\":1.25,\"min_ns_per_op\":1.10,"
+                       "\"cycles_per_op\":3.03,\"min_cycles_per_op\":3.00}\r\n") == 0);
+
+    r.cycles = 0u;
+    Bench_FormatResult(line, sizeof(line), "gas_crc", &r);
+    CHECK(strstr(line, "\"cycles_per_op\":null") != NULL);
+}
+
+/* Каждый случай набора проходит и меряет что-то ненулевое */
+void test_bench_suite_runs(void)
+{
+    for (uint8_t i = 0; i < Bench_Count(); i++) {
+        Bench_Result_t r;
+        App_Init();
+        Bench_Run(i, 100u, &r);
+        CHECK_EQ(r.iters, r.batch * BENCH_BATCHES);
+        CHECK(r.ns > 0u);
+    }
+}
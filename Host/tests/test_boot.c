@@ -0,0 +1,91 @@
+#include "test.h"
+#include "app.h"
+#include "host_hal.h"
+#include "gas_sim.h"
+#include "boot.h"
+#include "config_store.h"
+#include "dispenser.h"
+#include "eeprom_at24.h"
+#include "usart.h"
+#include <string.h>
+
+void test_boot_first_poll_under_50ms(void)
+{
+    App_Init();
+    GasSim_Init(1u);
+    GasSim_Slave_t *s = GasSim_Add(&huart2, 1u, NULL);
+    App_Run(50);
+
+    CHECK(Boot_Reached(BOOT_PHASE_FIRST_POLL));
+    CHECK(Boot_GetUs(BOOT_PHASE_FIRST_POLL) - Boot_GetUs(BOOT_PHASE_START) < 50000u);
+    CHECK(s->stats.cmd['S' - 'A'] >= 1u);
+    CHECK(Dispenser_GetUnit(0)->is_connected);
+
+    /* Настройки и UI — задолго до конца reset панели (140 мс) */
+    CHECK(Boot_Reached(BOOT_PHASE_UI));
+    CHECK(!Boot_Reached(BOOT_PHASE_DISPLAY));
+
+    App_Run(200);
+    CHECK(Boot_Reached(BOOT_PHASE_DISPLAY));
+    CHECK(Test_UsbContains("Boot [us]: poll"));
+}
+
+/* Сохранённые адрес и скорость ведомого приходят после первого опроса */
+void test_boot_stored_config_switches_slave(void)
+{
+    Config_t cfg;
+
+    memset(Host_Eeprom(), 0xFF, HOST_EEPROM_SIZE);
+    App_Boot();
+    cfg = *Config_Get();
+    cfg.slave_addr[0] = 5u;
+    cfg.baud[0] = 19200u;
+    CHECK_EQ(Config_Save(&cfg), HAL_OK);
+    App_Run(EEPROM_MIRROR_MAX_DELAY_MS + 200u);
+    CHECK(EEPROM_IsIdle());
+
+    App_Init();
+    GasSim_Init(1u);
+    GasSim_Slave_t *s = GasSim_Add(&huart2, 5u, NULL);
+    App_Run(100);
+
+    uint8_t addr = Dispenser_GetUnit(0)->slave_address;
+    uint8_t connected = Dispenser_GetUnit(0)->is_connected;
+    uint32_t baud = huart2.Init.BaudRate;
+
+    /* EEPROM шима переживает Host_Reset: следующим тестам — чистая */
+    memset(Host_Eeprom(), 0xFF, HOST_EEPROM_SIZE);
+
+    CHECK_EQ(addr, 5u);
+    CHECK_EQ(baud, 19200u);
+    CHECK(s->stats.cmd['S' - 'A'] >= 1u);
+    CHECK(connected);
+}
+
+/* Контраст и инверсия на работающей панели — одна короткая передача команд,
+   без reset и повторной инициализации */
+void test_boot_panel_settings_without_reinit(void)
+{
+    App_Boot();
+    App_Run(300);
+    CHECK(SSD1309_IsSettled(&oled));
+
+    uint32_t xfers = Host_GetStats()->spi_xfers;
+    uint32_t bytes = Host_GetStats()->spi_bytes;
+    uint32_t frames = oled.stats.frames;
+
+    SSD1309_SetPanel(&oled, 0x40u, 1u);
+    CHECK(!SSD1309_IsSettled(&oled));
+    for (uint8_t i = 0; i < 10u; i++) {
+        App_Run(1);
+        CHECK(SSD1309_IsReady(&oled));
+    }
+
+    CHECK(SSD1309_IsSettled(&oled));
+    CHECK_EQ(oled.stats.frames, frames);
+    CHECK_EQ(Host_GetStats()->spi_xfers, xfers + 1u);
+    CHECK_EQ(Host_GetStats()->spi_bytes, bytes + 3u);
+    CHECK_EQ(oled.tx_cmd[0], 0x81u);
+    CHECK_EQ(oled.tx_cmd[1], 0x40u);
+    CHECK_EQ(oled.tx_cmd[2], 0xA7u);
+}
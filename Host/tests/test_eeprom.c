@@ -0,0 +1,358 @@
+#include "test.h"
+#include "app.h"
+#include "host_hal.h"
+#include "eeprom_at24.h"
+#include "config_store.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+static HAL_StatusTypeDef done_status;
+static int done_calls;
+
+static void Done(HAL_StatusTypeDef status, void *ctx)
+{
+    (void)ctx;
+    done_status = status;
+    done_calls++;
+}
+
+static void BlankBoot(void)
+{
+    memset(Host_Eeprom(), 0xFF, HOST_EEPROM_SIZE);
+    App_Boot();
+}
+
+/* Заголовок записи настроек — как ConfigHeader_t в config_store.c */
+typedef struct {
+    uint16_t magic;
+    uint16_t version;
+    uint32_t seq;
+    uint16_t len;
+    uint16_t crc;
+} TestConfigHeader_t;
+
+static uint16_t TestCrc16(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* Запись настроек прямо в микросхему, мимо драйвера */
+static void PutSlot(uint16_t addr, uint16_t version, uint32_t seq, const void *payload, uint16_t len)
+{
+    TestConfigHeader_t h = { 0x4643u, version, seq, len, 0u };
+
+    h.crc = TestCrc16(0xFFFFu, (const uint8_t *)&h, offsetof(TestConfigHeader_t, crc));
+    h.crc = TestCrc16(h.crc, (const uint8_t *)payload, len);
+    memcpy(&Host_Eeprom()[addr], &h, sizeof(h));
+    memcpy(&Host_Eeprom()[addr + sizeof(h)], payload, len);
+}
+
+static const TestConfigHeader_t *SlotHeader(uint16_t addr)
+{
+    return (const TestConfigHeader_t *)&Host_Eeprom()[addr];
+}
+
+void test_eeprom_async_write_crosses_page(void)
+{
+    uint8_t data[40];
+    const uint16_t addr = 0x1000u + 50u;   /* 14 байт в одной странице, 26 — в следующей */
+
+    for (uint32_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(0x40u + i);
+    BlankBoot();
+    done_calls = 0;
+
+    CHECK_EQ(EEPROM_WriteAsync(addr, data, sizeof(data), Done, NULL), HAL_OK);
+    App_Run(100);
+
+    CHECK_EQ(done_calls, 1);
+    CHECK_EQ(done_status, HAL_OK);
+    CHECK(memcmp(&Host_Eeprom()[addr], data, sizeof(data)) == 0);
+    CHECK_EQ(Host_Eeprom()[addr - 1u], 0xFF);
+    CHECK_EQ(Host_Eeprom()[addr + sizeof(data)], 0xFF);
+    CHECK(Host_GetStats()->eeprom_writes >= 2u);
+    CHECK(EEPROM_IsIdle());
+}
+
+/* Блокирующая запись через границу страницы — две порции, без заворота */
+void test_eeprom_blocking_write_crosses_page(void)
+{
+    const uint16_t addr = 0x2000u - 6u;
+    uint8_t data[14];
+
+    for (uint8_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(0x40u + i);
+
+    BlankBoot();
+    App_Run(EEPROM_MIRROR_MAX_DELAY_MS + 200u);
+    CHECK(EEPROM_IsIdle());
+    uint32_t writes = Host_GetStats()->eeprom_writes;
+    CHECK_EQ(EEPROM_Write(addr, data, sizeof(data)), HAL_OK);
+
+    CHECK_EQ(Host_GetStats()->eeprom_writes, writes + 2u);
+    CHECK(memcmp(&Host_Eeprom()[addr], data, sizeof(data)) == 0);
+    CHECK_EQ(Host_Eeprom()[0x2000u - EEPROM_PAGE_SIZE], 0xFF);
+}
+
+void test_eeprom_write_survives_reset(void)
+{
+    uint8_t msg[] = "hello, eeprom";
+    uint8_t back[sizeof(msg)];
+
+    BlankBoot();
+    App_Run(EEPROM_MIRROR_MAX_DELAY_MS + 200u);   /* блокирующая запись — только при пустой очереди */
+    CHECK(EEPROM_IsIdle());
+    CHECK_EQ(EEPROM_Write(0x2000u, msg, sizeof(msg)), HAL_OK);
+
+    App_Boot();
+    memset(back, 0, sizeof(back));
+    CHECK_EQ(EEPROM_Read(0x2000u, back, sizeof(back)), HAL_OK);
+    CHECK(memcmp(back, msg, sizeof(msg)) == 0);
+}
+
+/* Два несмежных участка страницы вне зеркала: промежуток дочитывается,
+   страница уходит одним циклом записи и байты между участками не меняются */
+void test_eeprom_wb_page_written_once(void)
+{
+    const uint16_t page = 0x1000u;
+    const uint8_t a[4] = { 1, 2, 3, 4 };
+    const uint8_t b[4] = { 5, 6, 7, 8 };
+    EEPROM_Stats_t st;
+
+    BlankBoot();
+    App_Run(EEPROM_MIRROR_MAX_DELAY_MS + 200u);
+    for (uint32_t i = 0; i < EEPROM_PAGE_SIZE; i++) Host_Eeprom()[page + i] = (uint8_t)(0x80u + i);
+    EEPROM_ResetStats();
+    uint32_t writes = Host_GetStats()->eeprom_writes;
+
+    CHECK_EQ(EEPROM_Stage(page + 2u, a, sizeof(a)), HAL_OK);
+    CHECK_EQ(EEPROM_Stage(page + 20u, b, sizeof(b)), HAL_OK);
+    App_Run(100);
+
+    EEPROM_GetStats(&st);
+    CHECK(EEPROM_IsIdle());
+    CHECK_EQ(st.fill_reads, 1u);
+    CHECK_EQ(st.page_writes, 1u);
+    CHECK_EQ(Host_GetStats()->eeprom_writes, writes + 1u);
+    CHECK(memcmp(&Host_Eeprom()[page + 2u], a, sizeof(a)) == 0);
+    CHECK(memcmp(&Host_Eeprom()[page + 20u], b, sizeof(b)) == 0);
+    for (uint32_t i = 6; i < 20u; i++) CHECK_EQ(Host_Eeprom()[page + i], 0x80u + i);
+    CHECK_EQ(Host_Eeprom()[page + 1u], 0x81u);
+    CHECK_EQ(Host_Eeprom()[page + 24u], 0x98u);
+}
+
+/* Чтение встало в очередь раньше, чем сброс страницы: запись уходит за ним,
+   слот освобождается, но чтение всё равно видит новые байты */
+void test_eeprom_async_read_sees_flushed_page(void)
+{
+    const uint16_t page = 0x1000u;
+    const uint8_t a[4] = { 1, 2, 3, 4 };
+    const uint8_t b[4] = { 5, 6, 7, 8 };
+    uint8_t busy[3 * EEPROM_PAGE_SIZE];
+    uint8_t back[8];
+
+    BlankBoot();
+    App_Run(EEPROM_MIRROR_MAX_DELAY_MS + 200u);
+    memset(busy, 0x5A, sizeof(busy));
+    for (uint32_t i = 0; i < sizeof(busy); i += EEPROM_MAX_WRITE) {
+        CHECK_EQ(EEPROM_WriteAsync(0x3000u + i, &busy[i], EEPROM_MAX_WRITE, NULL, NULL), HAL_OK);
+    }
+
+    CHECK_EQ(EEPROM_Stage(page, a, sizeof(a)), HAL_OK);
+    CHECK_EQ(EEPROM_Stage(page + 4u, b, sizeof(b)), HAL_OK);
+    done_calls = 0;
+    memset(back, 0, sizeof(back));
+    CHECK_EQ(EEPROM_ReadAsync(page, back, sizeof(back), Done, NULL), HAL_OK);
+    App_Run(100);
+
+    CHECK_EQ(done_calls, 1);
+    CHECK_EQ(done_status, HAL_OK);
+    CHECK(memcmp(back, a, sizeof(a)) == 0);
+    CHECK(memcmp(&back[4], b, sizeof(b)) == 0);
+    CHECK(memcmp(&Host_Eeprom()[page + 4u], b, sizeof(b)) == 0);
+}
+
+void test_config_defaults_on_blank_eeprom(void)
+{
+    BlankBoot();
+    CHECK_EQ(Config_GetSource(), CONFIG_SRC_DEFAULTS);
+    CHECK_EQ(Config_Get()->price[0][0], CONFIG_PRICE_DEFAULT);
+    CHECK_EQ(Config_Get()->baud[1], 115200u);
+}
+
+void test_config_save_and_reload(void)
+{
+    BlankBoot();
+    CHECK_EQ(Config_SetPrice(0, 1, 4321u), HAL_OK);
+    CHECK_EQ(Config_SetPrice(1, 3, 999u), HAL_OK);
+
+    /* Зеркало пишется не позже EEPROM_MIRROR_MAX_DELAY_MS */
+    App_Run(EEPROM_MIRROR_MAX_DELAY_MS + 200u);
+    CHECK(EEPROM_IsIdle());
+
+    App_Boot();
+    CHECK(Config_GetSource() == CONFIG_SRC_SLOT_A || Config_GetSource() == CONFIG_SRC_SLOT_B);
+    CHECK_EQ(Config_Get()->price[0][1], 4321u);
+    CHECK_EQ(Config_Get()->price[1][3], 999u);
+    CHECK_EQ(Config_Get()->price[0][0], CONFIG_PRICE_DEFAULT);
+}
+
+/* Повторное сохранение в тот же слот меняет номер записи, CRC и поле цены —
+   три участка одной страницы зеркала, один цикл записи */
+void test_config_save_one_write_per_page(void)
+{
+    EEPROM_Stats_t st;
+
+    BlankBoot();
+    CHECK_EQ(Config_SetPrice(0, 1, 1200u), HAL_OK);    /* слот A */
+    App_Run(100);
+    CHECK_EQ(Config_SetPrice(0, 1, 1300u), HAL_OK);    /* слот B */
+    App_Run(100);
+    CHECK(EEPROM_IsIdle());
+
+    EEPROM_ResetStats();
+    uint32_t writes = Host_GetStats()->eeprom_writes;
+    CHECK_EQ(Config_SetPrice(0, 1, 1400u), HAL_OK);    /* снова A */
+    App_Run(100);
+
+    EEPROM_GetStats(&st);
+    CHECK(EEPROM_IsIdle());
+    CHECK_EQ(st.page_writes, 1u);
+    CHECK_EQ(Host_GetStats()->eeprom_writes, writes + 1u);
+
+    App_Boot();
+    CHECK_EQ(Config_Get()->price[0][1], 1400u);
+}
+
+/* Обрыв записи: у новейшей копии неверная CRC — берётся предыдущая */
+void test_config_torn_newest_slot_falls_back(void)
+{
+    BlankBoot();
+    CHECK_EQ(Config_SetPrice(0, 1, 1200u), HAL_OK);
+    App_Run(100);
+    CHECK_EQ(Config_SetPrice(0, 1, 1300u), HAL_OK);
+    App_Run(100);
+    CHECK(EEPROM_IsIdle());
+
+    uint32_t seq = Config_GetSeq();
+    uint16_t newest = (SlotHeader(CONFIG_SLOT_A)->seq == seq) ? CONFIG_SLOT_A : CONFIG_SLOT_B;
+    Host_Eeprom()[newest + sizeof(TestConfigHeader_t) + offsetof(Config_t, price[0][1])] ^= 0x55u;
+
+    Test_UsbContains("");
+    App_Boot();
+    CHECK_EQ(Config_GetSource(), (newest == CONFIG_SLOT_A) ? CONFIG_SRC_SLOT_B : CONFIG_SRC_SLOT_A);
+    CHECK_EQ(Config_GetSeq(), seq - 1u);
+    CHECK_EQ(Config_Get()->price[0][1], 1200u);
+    CHECK(Test_UsbContains("(other slot invalid)"));
+}
+
+/* Номер записи переполнился: 0 новее 0xFFFFFFFF, следующая запись — 1 */
+void test_config_seq_wraparound(void)
+{
+    Config_t cfg;
+
+    BlankBoot();
+    cfg = *Config_Get();
+    memset(Host_Eeprom(), 0xFF, HOST_EEPROM_SIZE);
+    cfg.price[0][0] = 1500u;
+    PutSlot(CONFIG_SLOT_A, CONFIG_VERSION, 0xFFFFFFFFu, &cfg, sizeof(cfg));
+    cfg.price[0][0] = 1600u;
+    PutSlot(CONFIG_SLOT_B, CONFIG_VERSION, 0u, &cfg, sizeof(cfg));
+
+    App_Boot();
+    CHECK_EQ(Config_GetSource(), CONFIG_SRC_SLOT_B);
+    CHECK_EQ(Config_GetSeq(), 0u);
+    CHECK_EQ(Config_Get()->price[0][0], 1600u);
+
+    CHECK_EQ(Config_SetPrice(0, 0, 1700u), HAL_OK);
+    App_Run(100);
+    CHECK(EEPROM_IsIdle());
+    CHECK_EQ(SlotHeader(CONFIG_SLOT_A)->seq, 1u);
+
+    App_Boot();
+    CHECK_EQ(Config_GetSource(), CONFIG_SRC_SLOT_A);
+    CHECK_EQ(Config_Get()->price[0][0], 1700u);
+}
+
+/* Старая раскладка: цены big-endian по 0x0000 и 0x0004 переносятся в слот */
+void test_config_legacy_prices_migrated(void)
+{
+    static const uint8_t legacy[8] = { 0, 0, 0x04, 0xD2, 0, 0, 0x09, 0x29 };  /* 1234, 2345 */
+
+    memset(Host_Eeprom(), 0xFF, HOST_EEPROM_SIZE);
+    memcpy(&Host_Eeprom()[CONFIG_LEGACY_PRICE0], legacy, sizeof(legacy));
+    App_Boot();
+
+    CHECK_EQ(Config_GetSource(), CONFIG_SRC_LEGACY);
+    CHECK_EQ(Config_Get()->price[0][0], 1234u);
+    CHECK_EQ(Config_Get()->price[1][0], 2345u);
+    CHECK_EQ(Config_Get()->price[0][1], CONFIG_PRICE_DEFAULT);
+
+    App_Run(100);
+    CHECK(EEPROM_IsIdle());
+    App_Boot();
+    CHECK_EQ(Config_GetSource(), CONFIG_SRC_SLOT_A);
+    CHECK_EQ(Config_Get()->price[1][0], 2345u);
+}
+
+/* Запись старой версии короче Config_t: поля сверх неё — умолчания, и
+   настройки сразу пересохраняются в текущей схеме */
+void test_config_old_version_migrated_and_resaved(void)
+{
+    uint32_t price[CONFIG_UNITS][CONFIG_NOZZLES];
+
+    for (uint32_t u = 0; u < CONFIG_UNITS; u++) {
+        for (uint32_t n = 0; n < CONFIG_NOZZLES; n++) price[u][n] = 700u + u * 10u + n;
+    }
+    memset(Host_Eeprom(), 0xFF, HOST_EEPROM_SIZE);
+    PutSlot(CONFIG_SLOT_A, CONFIG_VERSION - 1u, 5u, price, sizeof(price));
+    App_Boot();
+
+    CHECK_EQ(Config_GetSource(), CONFIG_SRC_SLOT_A);
+    CHECK_EQ(Config_Get()->price[1][2], 712u);
+    CHECK_EQ(Config_Get()->baud[1], 115200u);
+    CHECK_EQ(Config_GetSeq(), 6u);
+
+    App_Run(100);
+    CHECK(EEPROM_IsIdle());
+    CHECK_EQ(SlotHeader(CONFIG_SLOT_B)->version, CONFIG_VERSION);
+    CHECK_EQ(SlotHeader(CONFIG_SLOT_B)->seq, 6u);
+    CHECK_EQ(SlotHeader(CONFIG_SLOT_B)->len, sizeof(Config_t));
+
+    App_Boot();
+    CHECK_EQ(Config_GetSource(), CONFIG_SRC_SLOT_B);
+    CHECK_EQ(Config_Get()->price[1][2], 712u);
+}
+
+/* Второе сохранение, пока барьер первого ждёт места в очереди: барьер
+   покрывает обе записи, сбой сообщается для обеих */
+void test_config_save_failure_reported_while_barrier_pending(void)
+{
+    uint8_t fill[EEPROM_MAX_WRITE];
+
+    BlankBoot();
+    App_Run(EEPROM_MIRROR_MAX_DELAY_MS + 200u);
+    CHECK(EEPROM_IsIdle());
+    uint32_t seq = Config_GetSeq();
+
+    memset(fill, 0x5A, sizeof(fill));
+    for (uint32_t i = 0; i < EEPROM_QUEUE_LEN; i++) {
+        CHECK_EQ(EEPROM_WriteAsync((uint16_t)(0x3000u + i * EEPROM_PAGE_SIZE), fill, sizeof(fill), NULL, NULL), HAL_OK);
+    }
+    Host_EepromFailWrites(100u);
+    Test_UsbContains("");
+
+    CHECK_EQ(Config_SetPrice(0, 1, 1200u), HAL_OK);    /* барьер — в ожидании */
+    CHECK_EQ(Config_SetPrice(0, 1, 1300u), HAL_OK);
+    App_Run(300);
+    Host_EepromFailWrites(0u);
+
+    char expect[40];
+    snprintf(expect, sizeof(expect), "save seq %lu..%lu failed", (unsigned long)(seq + 1u), (unsigned long)(seq + 2u));
+    CHECK(Test_UsbContains(expect));
+}
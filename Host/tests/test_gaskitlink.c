@@ -0,0 +1,45 @@
+#include "test.h"
+#include "gaskitlink.h"
+
+void test_gas_build_parse_roundtrip(void)
+{
+    uint8_t buf[32];
+    GasFrame_t f;
+
+    uint16_t len = Gas_BuildFrame(buf, '0', '1', 'V', "1;001000");
+    CHECK_EQ(len, 4 + 8 + 1);
+    CHECK_EQ(buf[0], GAS_STX);
+    CHECK_EQ(buf[len - 1], Gas_CalculateCRC(&buf[1], (uint16_t)(len - 2)));
+
+    CHECK_EQ(Gas_ParseFrame(buf, len, &f), 0);
+    CHECK_EQ(f.addr_high, '0');
+    CHECK_EQ(f.addr_low, '1');
+    CHECK_EQ(f.cmd, 'V');
+    CHECK_EQ(f.data_len, 8);
+    CHECK(strcmp(f.data, "1;001000") == 0);
+}
+
+void test_gas_parse_rejects_bad_frames(void)
+{
+    uint8_t buf[32];
+    GasFrame_t f;
+    uint16_t len = Gas_BuildFrame(buf, '0', '1', 'S', "1");
+
+    CHECK_EQ(Gas_ParseFrame(buf, 4, &f), -1);
+
+    buf[0] = 0x00;
+    CHECK_EQ(Gas_ParseFrame(buf, len, &f), -2);
+    buf[0] = GAS_STX;
+
+    buf[len - 1] ^= 0x55u;
+    CHECK_EQ(Gas_ParseFrame(buf, len, &f), -3);
+}
+
+void test_gas_build_truncates_data(void)
+{
+    uint8_t buf[64];
+    uint16_t len = Gas_BuildFrame(buf, '0', '2', 'L', "0123456789012345678901234567");
+
+    CHECK_EQ(len, 4 + 22 + 1);
+    CHECK_EQ(buf[len - 2], '1');
+}
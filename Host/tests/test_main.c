@@ -0,0 +1,51 @@
+#include "test.h"
+#include "host_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    void (*fn)(void);
+} Test_t;
+
+static const Test_t tests[] = {
+#define TEST_ENTRY_(name) { #name, test_##name },
+    TEST_LIST(TEST_ENTRY_)
+#undef TEST_ENTRY_
+};
+
+static int failed_now;
+
+void Test_Fail(const char *file, int line, const char *expr, long long a, long long b)
+{
+    printf("  %s:%d: CHECK(%s) failed", file, line, expr);
+    if (a != b) printf(": %lld != %lld", a, b);
+    printf("\n");
+    failed_now = 1;
+}
+
+int Test_UsbContains(const char *needle)
+{
+    static char out[HOST_USB_BUF_SIZE + 1];
+    size_t n = Host_UsbTake(out, HOST_USB_BUF_SIZE);
+
+    out[n] = '\0';
+    return strstr(out, needle) != NULL;
+}
+
+/* host_tests [имя]: все тесты или те, в имени которых есть подстрока */
+int main(int argc, char **argv)
+{
+    int run = 0, failed = 0;
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        if (argc > 1 && strstr(tests[i].name, argv[1]) == NULL) continue;
+        failed_now = 0;
+        tests[i].fn();
+        printf("%s %s\n", failed_now ? "FAIL" : "ok  ", tests[i].name);
+        run++;
+        failed += failed_now;
+    }
+    printf("%d tests, %d failed\n", run, failed);
+    return failed;
+}
@@ -0,0 +1,142 @@
+#include "test.h"
+#include "app.h"
+#include "host_hal.h"
+#include "sched.h"
+#include "ui_manager.h"
+#include "ssd1309.h"
+#include <string.h>
+
+static char trace[256];
+static uint8_t trace_len;
+
+static void Mark(char c)
+{
+    if (trace_len < sizeof(trace) - 1u) trace[trace_len++] = c;
+    trace[trace_len] = '\0';
+}
+
+static void Proto(void)  { Mark('p'); }
+static void Input(void)  { Mark('i'); }
+static void Log(void)    { Mark('l'); }
+
+/* Отрисовка в три части по 2 мс, между ними уступки */
+static uint8_t Render(Sched_Task_t *t)
+{
+    static uint8_t part;
+
+    PT_BEGIN(t);
+    for (part = 0; part < 3u; part++) {
+        Mark((char)('0' + part));
+        Host_AdvanceUs(2000u);
+        if (part < 2u) PT_YIELD(t);
+    }
+    PT_END(t);
+}
+
+static void Setup(Sched_Task_t *tasks, uint8_t n)
+{
+    Host_Reset();
+    trace_len = 0;
+    trace[0] = '\0';
+    Sched_Init(tasks, n);
+}
+
+/* Таблица в произвольном порядке: проход идёт по уровням, протокол — перед
+   каждым шагом ниже, отрисовка продолжается со своей точки уступки */
+void test_sched_priority_and_yield(void)
+{
+    static Sched_Task_t tasks[] = {
+        SCHED_STEP("render", Render, SCHED_PRIO_RENDER,   SCHED_NO_ZONE),
+        SCHED_CALL("log",    Log,    SCHED_PRIO_LOGGING,  SCHED_NO_ZONE),
+        SCHED_CALL("proto",  Proto,  SCHED_PRIO_PROTOCOL, SCHED_NO_ZONE),
+        SCHED_CALL("input",  Input,  SCHED_PRIO_INPUT,    SCHED_NO_ZONE),
+    };
+
+    Setup(tasks, 4u);
+    CHECK(strcmp(Sched_GetTask(0)->name, "proto") == 0);
+    CHECK(strcmp(Sched_GetTask(3)->name, "render") == 0);
+
+    Sched_Run();
+    CHECK(strcmp(trace, "piplp0") == 0);
+    Sched_Run();
+    Sched_Run();
+    CHECK(strcmp(trace, "piplp0" "piplp1" "piplp2") == 0);
+    Sched_Run();
+    CHECK(strcmp(trace, "piplp0" "piplp1" "piplp2" "piplp0") == 0);
+
+    const Sched_Stats_t *r = &Sched_GetTask(3)->stats;
+    CHECK_EQ(r->runs, 4u);
+    CHECK_EQ(r->yields, 3u);
+}
+
+/* Настоящая отрисовка: полная перерисовка экрана идёт по виджету
+   за шаг, протокол опрашивается перед каждым, а страницы уходят в дисплей
+   только после последнего шага кадра */
+static uint32_t bytes_at_start;
+static uint8_t sent_early;
+
+static uint8_t Draw(Sched_Task_t *t)
+{
+    Mark('d');
+    return UI_DrawTask(t);
+}
+
+static void OledTask(void)
+{
+    SSD1309_Task(&oled);
+    if (Sched_GetTask(1)->pt != 0u && SSD1309_GetStats(&oled)->bytes != bytes_at_start) sent_early = 1u;
+}
+
+void test_sched_protocol_latency_bounded_by_step(void)
+{
+    static Sched_Task_t tasks[] = {
+        SCHED_CALL("proto",    Proto,    SCHED_PRIO_PROTOCOL, SCHED_NO_ZONE),
+        SCHED_STEP("ui_draw",  Draw,     SCHED_PRIO_RENDER,   SCHED_NO_ZONE),
+        SCHED_CALL("oled_bus", OledTask, SCHED_PRIO_RENDER,   SCHED_NO_ZONE),
+    };
+
+    App_Boot();
+    App_Run(300);                       /* дисплей готов, экран нарисован */
+    UI_SetDebugOverlay(0);
+    UI_SetDebugOverlay(1);              /* следующий кадр — весь экран */
+    Host_Advance(50u);
+
+    trace_len = 0;
+    trace[0] = '\0';
+    sent_early = 0u;
+    bytes_at_start = SSD1309_GetStats(&oled)->bytes;
+    Sched_Init(tasks, 3u);
+
+    uint32_t renders = UI_GetStats()->renders;
+    uint32_t widgets = UI_GetStats()->widgets;
+    uint8_t passes = 0;
+    do {
+        Sched_Run();
+        Host_Advance(1u);
+        passes++;
+    } while (Sched_GetTask(1)->pt != 0u && passes < 100u);
+
+    const Sched_Stats_t *d = &Sched_GetTask(1)->stats;
+    widgets = UI_GetStats()->widgets - widgets;
+    CHECK_EQ(UI_GetStats()->renders, renders + 1u);
+    CHECK(widgets > 1u);
+    CHECK_EQ(d->yields, widgets);             /* по шагу на перерисованный виджет */
+    CHECK_EQ(d->runs, widgets + 1u);
+    CHECK(strstr(trace, "dd") == NULL);       /* каждому шагу отрисовки предшествует опрос */
+    CHECK(trace[0] == 'p');
+    CHECK(!sent_early);
+    CHECK(SSD1309_GetStats(&oled)->bytes > bytes_at_start);
+}
+
+/* Приложение целиком: отчёт по задачам в USB-лог, построчно задачей sched */
+void test_sched_app_dump(void)
+{
+    App_Boot();
+    App_Run(300);
+    Test_UsbContains("");          /* сброс накопленного лога */
+
+    Sched_DumpStart();
+    App_Run(20);
+    CHECK(Test_UsbContains("TASK oled_bus"));  /* последняя строка — отчёт дошёл до конца */
+    CHECK(Sched_GetTask(0)->stats.runs > Sched_GetTask(Sched_Count() - 1u)->stats.runs);
+}
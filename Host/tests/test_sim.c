@@ -0,0 +1,238 @@
+#include "test.h"
+#include "app.h"
+#include "host_hal.h"
+#include "gas_sim.h"
+#include "dispenser.h"
+#include "usart.h"
+#include "shift.h"
+#include "replay.h"
+
+/* Модельное время до закрытия транзакции (N) или до max_ms */
+static uint32_t RunUntilClosed(GasSim_Slave_t *s, uint32_t closed, uint32_t max_ms)
+{
+    uint32_t ms = 0;
+    while (s->stats.transactions < closed && ms < max_ms) {
+        App_Run(10);
+        ms += 10u;
+    }
+    return ms;
+}
+
+static GasSim_Slave_t *Boot(const GasSim_Config_t *cfg)
+{
+    App_Init();
+    GasSim_Init(12345u);
+    GasSim_Slave_t *s = GasSim_Add(&huart2, 1u, cfg);
+    App_Run(1000);   /* мастер опросил S (раз в poll_idle_ms) и увидел S10 */
+    return s;
+}
+
+void test_sim_volume_transaction(void)
+{
+    GasSim_Slave_t *s = Boot(NULL);
+    DispenserUnit_t *unit = Dispenser_GetUnit(0);
+
+    CHECK(unit->is_connected);
+    CHECK_EQ(unit->status, DS_IDLE);
+
+    Dispenser_StartVolume(0, 1, 500u, 1100u);
+    RunUntilClosed(s, 1u, 30000u);
+    App_Run(500);
+
+    CHECK_EQ(s->stats.transactions, 1u);
+    CHECK_EQ(s->status, 1u);
+    CHECK_EQ(s->stats.cmd['T' - 'A'], 1u);
+    CHECK(s->stats.l_polls > 0u);
+    CHECK_EQ(unit->volume_cl, 500u);
+    CHECK_EQ(unit->amount, 5500u);
+    CHECK_EQ(unit->status, DS_IDLE);
+    CHECK_EQ(s->totalizer[1], 500u);
+}
+
+void test_sim_amount_transaction(void)
+{
+    GasSim_Slave_t *s = Boot(NULL);
+    DispenserUnit_t *unit = Dispenser_GetUnit(0);
+
+    Dispenser_StartAmount(0, 1, 2200u, 1100u);
+    RunUntilClosed(s, 1u, 30000u);
+
+    CHECK_EQ(s->stats.transactions, 1u);
+    CHECK_EQ(unit->amount, 2200u);
+    CHECK_EQ(unit->volume_cl, 200u);
+}
+
+/* Сбои на линии: мастер переспрашивает, транзакция всё равно закрывается */
+void test_sim_faults_recovered_by_retries(void)
+{
+    GasSim_Config_t cfg;
+    GasSim_DefaultConfig(&cfg);
+    cfg.crc_error_permille = 50u;
+    cfg.drop_permille = 50u;
+    cfg.reply_jitter_ms = 5u;
+
+    GasSim_Slave_t *s = Boot(&cfg);
+    DispenserUnit_t *unit = Dispenser_GetUnit(0);
+
+    for (uint32_t n = 1; n <= 3u; n++) {
+        Dispenser_StartVolume(0, 1, 300u, 1000u);
+        RunUntilClosed(s, n, 60000u);
+        CHECK_EQ(s->stats.transactions, n);
+        App_Run(1000);
+    }
+    CHECK(s->stats.crc_errors + s->stats.dropped > 0u);
+    /* T мастер не переспрашивает: при потерянном ответе итог — из последнего L */
+    CHECK(unit->volume_cl <= 300u);
+    CHECK_EQ(s->totalizer[1], 900u);
+}
+
+void test_sim_pause_resume(void)
+{
+    GasSim_Config_t cfg;
+    GasSim_DefaultConfig(&cfg);
+    cfg.auto_customer = 0u;
+
+    GasSim_Slave_t *s = Boot(&cfg);
+
+    Dispenser_StartVolume(0, 1, 1000u, 1000u);
+    App_Run(200);
+    CHECK_EQ(s->status, 3u);
+    GasSim_Lift(s, 1u);
+    App_Run(cfg.start_delay_ms + 1000u);
+    CHECK_EQ(s->status, 6u);
+
+    Dispenser_Stop(0);
+    App_Run(100);
+    CHECK_EQ(s->status, 7u);
+    uint32_t paused_at = s->volume_cl;
+    App_Run(2000);
+    CHECK_EQ(s->volume_cl, paused_at);
+
+    Dispenser_Resume(0);
+    App_Run(100);
+    CHECK_EQ(s->status, 6u);
+    App_Run(2000);
+    CHECK(s->volume_cl > paused_at);
+
+    /* Повесили посреди налива: S90 и закрытие с недоливом */
+    GasSim_Hang(s);
+    RunUntilClosed(s, 1u, 5000u);
+    CHECK_EQ(s->stats.transactions, 1u);
+    CHECK(s->volume_cl < 1000u);
+}
+
+/* Два ведомых на одной линии: отвечает только адресат */
+void test_sim_shared_line_addressing(void)
+{
+    App_Init();
+    GasSim_Init(1u);
+    GasSim_Slave_t *a = GasSim_Add(&huart2, 1u, NULL);
+    GasSim_Slave_t *b = GasSim_Add(&huart2, 3u, NULL);
+
+    App_Run(2000);
+    CHECK(a->stats.rx_frames > 0u);
+    CHECK_EQ(b->stats.rx_frames, 0u);
+    CHECK_EQ(b->stats.replies, 0u);
+    CHECK(Dispenser_GetUnit(0)->is_connected);
+}
+
+/* Кадр на линии: 10 бит на байт, HAL_UART_Transmit ждёт его целиком */
+void test_sim_uart_byte_time(void)
+{
+    App_Init();
+    CHECK_EQ(Host_UartWireUs(&huart2, 5u), 5209u);     /* 9600 8N1 */
+    CHECK_EQ(Host_UartWireUs(&huart3, 64u), 5556u);    /* 115200 8N1 */
+
+    uint64_t t0 = Host_NowUs();
+    Dispenser_RequestTotalizer(0);                     /* 6 байт */
+    CHECK_EQ(Host_NowUs() - t0, Host_UartWireUs(&huart2, 6u));
+}
+
+/* Связь пропала: 3 с с разрывом по таймауту — сотни итераций, а не 3000 */
+void test_sim_link_timeout_fast_forward(void)
+{
+    GasSim_Slave_t *s = Boot(NULL);
+    DispenserUnit_t *unit = Dispenser_GetUnit(0);
+
+    CHECK(unit->is_connected);
+    s->cfg.drop_permille = 1000u;
+    uint32_t steps = App_RunFast(3000u);
+
+    CHECK(!unit->is_connected);
+    CHECK(steps < 3000u / 8u);
+}
+
+/* Перескок простоя не меняет поведения: тот же обмен, те же тики */
+void test_sim_fast_forward_matches_stepwise(void)
+{
+    Shift_Config_t cfg;
+    Shift_Result_t fast, step;
+
+    Shift_DefaultConfig(&cfg);
+    cfg.seed = 3u;
+    cfg.transactions = 12u;
+    cfg.max_gap_ms = 20000u;
+    Shift_Run(&cfg, &fast);
+    cfg.stepwise = 1u;
+    Shift_Run(&cfg, &step);
+
+    CHECK_EQ(fast.transactions, 12u);
+    CHECK_EQ(fast.digest, step.digest);
+    CHECK_EQ(fast.virtual_ms, step.virtual_ms);
+    CHECK_EQ(fast.volume_cl, step.volume_cl);
+    CHECK(fast.steps * 2u < step.steps);
+}
+
+void test_sim_shift_reproducible(void)
+{
+    Shift_Config_t cfg;
+    Shift_Result_t a, b, c;
+
+    Shift_DefaultConfig(&cfg);
+    cfg.transactions = 20u;
+    cfg.seed = 7u;
+    Shift_Run(&cfg, &a);
+    Shift_Run(&cfg, &b);
+    cfg.seed = 8u;
+    Shift_Run(&cfg, &c);
+
+    CHECK_EQ(a.transactions, 20u);
+    CHECK_EQ(a.digest, b.digest);
+    CHECK_EQ(a.virtual_ms, b.virtual_ms);
+    CHECK(a.digest != c.digest);
+}
+
+/* Управляющие байты — именами, CRC может совпасть с печатным символом */
+void test_replay_parse_log_line(void)
+{
+    uint8_t f[REPLAY_FRAME_MAX];
+
+    CHECK_EQ(Replay_ParseLine("<STX><NUL><SOH>SR //опрос", f, sizeof(f)), 5u);
+    CHECK_EQ(f[3], 'S');
+    CHECK_EQ(f[4], 'R');
+    CHECK_EQ(Replay_ParseLine("<STX><NUL><SOH>L1q6;000009<HT>\r\n", f, sizeof(f)), 15u);
+    CHECK_EQ(f[14], 0x09u);
+    CHECK_EQ(Replay_ParseLine("<STX><NUL><SOH>L1q6;000009<VT>", f, sizeof(f)), 0u);   /* CRC */
+    CHECK_EQ(Replay_ParseLine("1. Команда S", f, sizeof(f)), 0u);
+}
+
+/* Наш мастер на эталонном обмене: лишних обменов нет, не хватает только C0 */
+void test_replay_reference_log(void)
+{
+    static Replay_Log_t log;
+    static Replay_Result_t res;
+
+    CHECK_EQ(Replay_Load(REPLAY_LOG_PATH, &log), 0);
+    CHECK_EQ(log.bad, 0u);
+    CHECK_EQ(log.orphans, 0u);
+    CHECK_EQ(log.count * 2u, log.frames);
+
+    Replay_Run(&log, &res);
+    CHECK(res.completed);
+    CHECK_EQ(res.extra, 0u);
+    CHECK_EQ(res.silent, 0u);
+    CHECK_EQ(res.missing, res.missing_cmd['C' - 'A']);
+    CHECK_EQ(res.phase[6].our_rounds, res.phase[6].ref_rounds);   /* S-L-R в наливе */
+    CHECK_EQ(Dispenser_GetUnit(0)->volume_cl, 500u);
+    CHECK_EQ(Dispenser_GetUnit(0)->amount, 5500u);
+}
@@ -0,0 +1,115 @@
+#include "test.h"
+#include "app.h"
+#include "host_hal.h"
+#include "keyboard.h"
+#include "tim.h"
+#include "ui_manager.h"
+#include "font_digits_cfg.h"
+
+/* Клавиатура без main loop: события остаются в очереди, UI их не забирает */
+static void DrainKeys(void)
+{
+    Keyboard_Event_t ev;
+    while (Keyboard_GetEvent(&ev)) { }
+}
+
+void test_keyboard_press_release_events(void)
+{
+    Keyboard_Event_t ev;
+
+    App_Boot();
+    DrainKeys();
+    CHECK(Keyboard_IsIdle());
+
+    Host_Key('5', 1);
+    CHECK(!Keyboard_IsIdle());
+    Host_Advance(40);
+    CHECK(Keyboard_GetEvent(&ev));
+    CHECK_EQ(ev.key, '5');
+    CHECK_EQ(ev.type, KEY_EV_PRESS);
+
+    Host_Key('5', 0);
+    Host_Advance(40);
+    CHECK(Keyboard_GetEvent(&ev));
+    CHECK_EQ(ev.key, '5');
+    CHECK_EQ(ev.type, KEY_EV_RELEASE);
+    CHECK(!Keyboard_GetEvent(&ev));
+}
+
+void test_keyboard_idle_after_release(void)
+{
+    App_Boot();
+    Host_Key('A', 1);
+    Host_Advance(40);
+    Host_Key('A', 0);
+    Host_Advance(KEY_IDLE_MS + 50u);
+    DrainKeys();
+
+    CHECK(Keyboard_IsIdle());
+    CHECK_EQ(htim3.Instance->DIER & TIM_DIER_UIE, 0);
+}
+
+void test_ui_first_frame_reaches_panel(void)
+{
+    App_Init();
+    App_Run(300);
+
+    CHECK(SSD1309_IsReady(&oled));
+    CHECK(oled.stats.frames >= 1u);
+    CHECK(Host_GetStats()->spi_bytes >= SSD1309_FB_SIZE);
+
+    uint32_t lit = 0;
+    for (uint32_t i = 0; i < SSD1309_FB_SIZE; i++) lit += (oled.fb[i] != 0u);
+    CHECK(lit > 0u);
+}
+
+/* Панель платы со сдвигом столбцов 2: окно 0x21 со сдвигом, кадр без смены
+   окна — одна передача данных */
+void test_ui_window_refresh_with_col_offset(void)
+{
+    App_Boot();
+    App_Run(300);
+
+    CHECK(oled.window);
+    CHECK_EQ(oled.cfg.col_offset, 2u);
+    uint8_t found = 0;
+    for (uint8_t i = 0; i + 2u < oled.init_len; i++) {
+        if (oled.init_seq[i] == 0x21u && oled.init_seq[i + 1u] == 2u && oled.init_seq[i + 2u] == 129u) found = 1;
+    }
+    CHECK(found);
+
+    App_Run(100);                       /* окно на весь экран уже в контроллере */
+    UI_SetDebugOverlay(0);
+    UI_SetDebugOverlay(1);              /* весь экран: окно 0..7 */
+    uint32_t xfers = Host_GetStats()->spi_xfers;
+    uint32_t frames = oled.stats.frames;
+    App_Run(40);
+
+    CHECK_EQ(oled.stats.frames, frames + 1u);
+    CHECK_EQ(Host_GetStats()->spi_xfers, xfers + 1u);
+}
+
+/* Глиф, выброшенный из сборки font_digits.h, виден рамкой, а не пропадает */
+void test_ui_big_char_missing_glyph_drawn_as_frame(void)
+{
+    const uint8_t *fb = oled.fb;
+
+    App_Boot();
+    SSD1309_Clear(&oled);
+
+#if !FONT_DIGITS_HAS_MINUS
+    CHECK_EQ(SSD1309_DrawBigChar(&oled, 32, 1, '-', SSD1309_FONT_16X24), 16u);
+    CHECK_EQ(fb[1 * SSD1309_WIDTH + 32], 0xFF);             /* левый край, все три страницы */
+    CHECK_EQ(fb[3 * SSD1309_WIDTH + 32], 0xFF);
+    CHECK_EQ(fb[1 * SSD1309_WIDTH + 38] & 0x01u, 0x01u);   /* верх */
+    CHECK_EQ(fb[3 * SSD1309_WIDTH + 38] & 0x80u, 0x80u);   /* низ */
+    CHECK_EQ(fb[2 * SSD1309_WIDTH + 38], 0x00);
+#endif
+#if !FONT_DIGITS_16X32
+    CHECK_EQ(SSD1309_DrawBigChar(&oled, 64, 1, '0', SSD1309_FONT_16X32), 16u);
+    CHECK_EQ(fb[4 * SSD1309_WIDTH + 64], 0xFF);             /* четыре страницы */
+    CHECK_EQ(fb[4 * SSD1309_WIDTH + 70] & 0x80u, 0x80u);
+#endif
+    CHECK_EQ(SSD1309_DrawBigChar(&oled, 96, 1, ' ', SSD1309_FONT_16X24), 16u);
+    CHECK_EQ(fb[1 * SSD1309_WIDTH + 96], 0x00);
+}
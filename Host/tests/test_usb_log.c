@@ -0,0 +1,40 @@
+#include "test.h"
+#include "app.h"
+#include "host_hal.h"
+#include "usb_log.h"
+#include <stdio.h>
+#include <string.h>
+
+void test_usb_log_boot_banner(void)
+{
+    App_Init();
+    App_Run(20);
+    CHECK(Test_UsbContains("=== System Started ==="));
+}
+
+/* Больше, чем уходит за одну передачу CDC: строки не теряются и не путаются */
+void test_usb_log_long_output_in_order(void)
+{
+    static char out[8192];
+    char line[32];
+
+    App_Init();
+    App_Run(20);
+    Test_UsbContains("");
+
+    for (int i = 0; i < 48; i++) {
+        UsbLog_Printf("line %03d ........................\r\n", i);
+    }
+    App_Run(50);
+
+    size_t n = Host_UsbTake(out, sizeof(out) - 1u);
+    out[n] = '\0';
+
+    const char *p = out;
+    for (int i = 0; i < 48; i++) {
+        snprintf(line, sizeof(line), "line %03d ", i);
+        p = strstr(p, line);
+        CHECK(p != NULL);
+    }
+    CHECK(Host_GetStats()->usb_xfers >= 2u);
+}
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Сравнение двух прогонов микробенчмарков (Core/Inc/bench.h).
+
+Вход — JSON Lines отчёта: вывод host_bench --json или захват USB-лога платы
+после команды 'B' (текст лога вокруг строк отчёта пропускается; двоичный
+лог сначала через blog_decode.py). Сравнивается лучшая пачка на операцию:
+она меньше всего зависит от прерываний и соседей по машине.
+
+    build-host/host_bench --json > base.jsonl      # до изменений
+    build-host/host_bench --json > new.jsonl       # после
+    python3 Tools/bench_compare.py base.jsonl new.jsonl --threshold 10
+
+Код возврата 1, если хоть один случай медленнее порога (в процентах).
+
+Только стандартная библиотека Python 3.
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    """{имя: запись} из строк с ключом "bench"; остальные строки — мимо."""
+    results = {}
+    platform = None
+    with open(path, encoding='utf-8', errors='replace') as f:
+        for line in f:
+            start = line.find('{')
+            if start < 0:
+                continue
+            try:
+                rec = json.loads(line[start:].strip())
+            except ValueError:
+                continue
+            if 'bench' in rec:
+                results[rec['bench']] = rec
+            elif 'suite' in rec:
+                platform = rec.get('platform')
+    return platform, results
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('base')
+    ap.add_argument('new')
+    ap.add_argument('--threshold', type=float, default=10.0,
+                    help='допустимое замедление, %% (по умолчанию 10)')
+    ap.add_argument('--metric', default=None,
+                    help='поле записи; по умолчанию min_cycles_per_op, без тактов — min_ns_per_op')
+    args = ap.parse_args()
+
+    base_platform, base = load(args.base)
+    new_platform, new = load(args.new)
+    if base_platform and new_platform and base_platform != new_platform:
+        print('warning: platforms differ: %s vs %s' % (base_platform, new_platform), file=sys.stderr)
+
+    slower = 0
+    print('%-24s %12s %12s %8s' % ('bench', 'base', 'new', 'change'))
+    for name in sorted(set(base) | set(new)):
+        if name not in base or name not in new:
+            print('%-24s %s' % (name, 'only in ' + ('new' if name in new else 'base')))
+            continue
+        metric = args.metric
+        if metric is None:
+            metric = 'min_cycles_per_op'
+            if base[name].get(metric) is None or new[name].get(metric) is None:
+                metric = 'min_ns_per_op'
+        b = base[name].get(metric)
+        n = new[name].get(metric)
+        if not b or n is None:
+            print('%-24s %12s %12s' % (name, b, n))
+            continue
+        change = (n - b) / b * 100.0
+        mark = ''
+        if change > args.threshold:
+            mark = '  SLOWER'
+            slower += 1
+        print('%-24s %12.2f %12.2f %+7.1f%%%s' % (name, b, n, change, mark))
+
+    if slower:
+        print('%d case(s) slower than %.1f%%' % (slower, args.threshold))
+    return 1 if slower else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
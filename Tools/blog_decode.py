@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""Декодер двоичного USB-лога пульта (Core/Inc/blog.h).
+
+Строки формата берутся из секции .blog_fmt прошивки, строки-константы для %s
+читаются из загружаемых секций того же ELF. Текст UsbLog_Printf в потоке
+проходит как есть.
+
+    stty -F /dev/ttyACM0 raw -echo
+    python3 Tools/blog_decode.py Debug/Pult.elf /dev/ttyACM0
+    python3 Tools/blog_decode.py Debug/Pult.elf capture.bin > capture.txt
+    python3 Tools/blog_decode.py --list Debug/Pult.elf
+
+Только стандартная библиотека Python 3.
+"""
+import argparse
+import re
+import struct
+import sys
+
+BLOG_SYNC = 0x1E
+BLOG_DUMP_MARK = 0xFF
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+class Elf:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        d = self.data
+        if d[:4] != b'\x7fELF':
+            raise ValueError('%s: not an ELF file' % path)
+        is64 = d[4] == 2
+        end = '<' if d[5] == 1 else '>'
+        if is64:
+            shoff, = struct.unpack_from(end + 'Q', d, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(end + 'HHH', d, 0x3A)
+            shfmt = end + 'IIQQQQIIQQ'
+        else:
+            shoff, = struct.unpack_from(end + 'I', d, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(end + 'HHH', d, 0x2E)
+            shfmt = end + 'IIIIIIIIII'
+
+        raw = []
+        for i in range(shnum):
+            f = struct.unpack_from(shfmt, d, shoff + i * shentsize)
+            # name, type, flags, addr, offset, size
+            raw.append((f[0], f[1], f[2], f[3], f[4], f[5]))
+        strtab = raw[shstrndx]
+        self.sections = []
+        for name, typ, flags, addr, off, size in raw:
+            n = d[strtab[4] + name:d.index(b'\0', strtab[4] + name)].decode()
+            self.sections.append({'name': n, 'type': typ, 'flags': flags,
+                                  'addr': addr, 'offset': off, 'size': size})
+
+        fmt = [s for s in self.sections if s['name'] == '.blog_fmt']
+        if not fmt:
+            raise ValueError('%s: no .blog_fmt section (built with BLOG_ENABLED=0?)' % path)
+        self.fmt = fmt[0]
+        if self.fmt['size'] > 0x10000:
+            raise ValueError('.blog_fmt is larger than 64 KB, 16-bit ids overflow')
+
+    def format_string(self, fid):
+        # id — младшие 16 бит адреса строки; в прошивке секция INFO начинается с 0
+        s = self.fmt
+        off = (fid - s['addr']) & 0xFFFF
+        if off >= s['size']:
+            return None
+        start = s['offset'] + off
+        return self.data[start:self.data.index(b'\0', start)].decode('utf-8', 'replace')
+
+    def formats(self):
+        s = self.fmt
+        pos = 0
+        while pos < s['size']:
+            start = s['offset'] + pos
+            end = self.data.index(b'\0', start)
+            if end > start:
+                yield (s['addr'] + pos) & 0xFFFF, self.data[start:end].decode('utf-8', 'replace')
+            pos = end - s['offset'] + 1
+
+    def cstring(self, addr):
+        for s in self.sections:
+            if (s['flags'] & SHF_ALLOC) and s['type'] != SHT_NOBITS \
+                    and s['addr'] <= addr < s['addr'] + s['size']:
+                start = s['offset'] + addr - s['addr']
+                return self.data[start:self.data.index(b'\0', start)].decode('utf-8', 'replace')
+        return '<str@0x%08X>' % addr
+
+
+CONV = re.compile(r'%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])')
+
+
+def render(elf, fmt, args):
+    out = []
+    pos = 0
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    for m in CONV.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, prec, _, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        if width == '*':
+            width = str(take())
+        if prec == '*':
+            prec = str(take())
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        v = take()
+        if conv in 'di':
+            out.append((spec + 'd') % (v - (1 << 32) if v & 0x80000000 else v))
+        elif conv == 'u':
+            out.append((spec + 'd') % v)
+        elif conv in 'xXo':
+            out.append((spec + conv) % v)
+        elif conv == 'p':
+            out.append('0x%08x' % v)
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(v & 0xFF))
+        elif conv == 's':
+            out.append((spec + 's') % elf.cstring(v))
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def dump(label, data):
+    hexs = ''.join('%02X ' % b for b in data)
+    asc = ''.join(chr(b) if 32 <= b <= 126 else '.' for b in data)
+    return '%s (%u): %s | %s\r\n' % (label, len(data), hexs, asc)
+
+
+def varint(buf, pos):
+    v = 0
+    shift = 0
+    while True:
+        if pos >= len(buf):
+            return None, pos
+        b = buf[pos]
+        pos += 1
+        v |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return v & 0xFFFFFFFF, pos
+
+
+def parse(elf, buf):
+    """Разбирает buf; возвращает (текст, число использованных байт)."""
+    out = []
+    pos = 0
+    while pos < len(buf):
+        sync = buf.find(bytes([BLOG_SYNC]), pos)
+        if sync < 0:
+            out.append(buf[pos:].decode('utf-8', 'replace'))
+            pos = len(buf)
+            break
+        out.append(buf[pos:sync].decode('utf-8', 'replace'))
+        pos = sync
+        if pos + 4 > len(buf):
+            break
+        fid = buf[pos + 1] | (buf[pos + 2] << 8)
+        n = buf[pos + 3]
+        fmt = elf.format_string(fid)
+        if n == BLOG_DUMP_MARK:
+            if pos + 5 > len(buf) or pos + 5 + buf[pos + 4] > len(buf):
+                break
+            data = buf[pos + 5:pos + 5 + buf[pos + 4]]
+            out.append(dump(fmt if fmt is not None else '<blog id 0x%04X>' % fid, data))
+            pos += 5 + len(data)
+            continue
+        p = pos + 4
+        args = []
+        for _ in range(n):
+            v, p = varint(buf, p)
+            if v is None:
+                break
+            args.append(v)
+        if len(args) < n:
+            break
+        if fmt is None:
+            out.append('<blog id 0x%04X %s>\r\n' % (fid, ' '.join('%u' % a for a in args)))
+        else:
+            out.append(render(elf, fmt, args))
+        pos = p
+    return ''.join(out), pos
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Decode the binary USB log of the Pult firmware')
+    ap.add_argument('elf', help='firmware ELF, e.g. Debug/Pult.elf')
+    ap.add_argument('input', nargs='?', default='-', help='capture file or tty (default stdin)')
+    ap.add_argument('--list', action='store_true', help='print the format string table and exit')
+    a = ap.parse_args()
+
+    elf = Elf(a.elf)
+    if a.list:
+        for fid, fmt in elf.formats():
+            print('0x%04X  %r' % (fid, fmt))
+        return
+
+    src = sys.stdin.buffer if a.input == '-' else open(a.input, 'rb', buffering=0)
+    pending = b''
+    while True:
+        chunk = src.read(4096)
+        if not chunk:
+            break
+        pending += chunk
+        text, used = parse(elf, pending)
+        pending = pending[used:]
+        sys.stdout.write(text)
+        sys.stdout.flush()
+    if pending:
+        sys.stdout.write(parse(elf, pending)[0])
+
+
+if __name__ == '__main__':
+    main()